@@ -21,6 +21,8 @@
 #include "libHh/Lls.h"
 #include "libHh/Map.h"
 #include "libHh/MathOp.h"
+#include "libHh/MeshGeodesic.h"
+#include "libHh/MeshLaplacian.h"
 #include "libHh/MeshOp.h"  // Vnors, ...
 #include "libHh/MeshSearch.h"
 #include "libHh/Polygon.h"
@@ -35,6 +37,7 @@
 #include "libHh/StringOp.h"
 #include "libHh/Timer.h"
 #include "libHh/TriangleFaceSpatial.h"
+#include "libHh/WeldPoints.h"
 using namespace hh;
 
 #if defined(HH_HAVE_SIMPLEX)
@@ -264,41 +267,75 @@ void do_createobject(Args& args) {
 
 // *** froma3d
 
+// Is there already a face with the same vertices as va (in either orientation)?
+bool has_duplicate_face(CArrayView<Vertex> va) {
+  for (Face f : mesh.faces(va[0])) {
+    if (mesh.num_vertices(f) != va.num()) continue;
+    bool same = true;
+    for (Vertex v : mesh.vertices(f)) same = same && contains(va, v);
+    if (same) return true;
+  }
+  return false;
+}
+
 void do_froma3d() {
   HH_TIMER("_froma3d");
-  HH_STAT(Sppdist2);
   RSA3dStream ia3d(std::cin);
-  HashPoint hp;
-  Array<Vertex> gva, va;
-  A3dElem el;
-  for (;;) {
-    ia3d.read(el);
-    if (el.type() == A3dElem::EType::endfile) break;
-    if (el.type() == A3dElem::EType::comment) {
-      showff("|%s\n", el.comment().c_str());
-      continue;
+  // Read the polygon soup, then weld its points in bulk.
+  Array<Point> points;
+  Array<int> poly_start;  // Polygon i has points [poly_start[i], poly_start[i + 1]).
+  {
+    HH_TIMER("__reada3d");
+    A3dElem el;
+    for (;;) {
+      ia3d.read(el);
+      if (el.type() == A3dElem::EType::endfile) break;
+      if (el.type() == A3dElem::EType::comment) {
+        showff("|%s\n", el.comment().c_str());
+        continue;
+      }
+      if (el.type() != A3dElem::EType::polygon) {
+        Warning("Non-polygon input ignored");
+        continue;
+      }
+      poly_start.push(points.num());
+      for_int(i, el.num()) points.push(el[i].p);
     }
-    if (el.type() != A3dElem::EType::polygon) {
-      Warning("Non-polygon input ignored");
-      continue;
+    poly_start.push(points.num());
+  }
+  Array<int> point_class;
+  const int num_classes = weld_points(points, point_class);
+  HH_TIMER("__createmesh");
+  Array<Vertex> class_vertex(num_classes, nullptr);
+  for_int(i, points.num()) {
+    Vertex& v = class_vertex[point_class[i]];
+    if (!v) {
+      v = mesh.create_vertex();
+      mesh.set_point(v, points[i]);
     }
+  }
+  int num_degenerate = 0, num_duplicate = 0, num_nonmanifold = 0;
+  Array<Vertex> va;
+  for_int(poly, poly_start.num() - 1) {
     va.init(0);
-    for_int(i, el.num()) {
-      int k = hp.enter(el[i].p);
-      if (k == gva.num()) {
-        Vertex v = mesh.create_vertex();
-        mesh.set_point(v, el[i].p);
-        gva.push(v);
-        va.push(v);
-      } else {
-        assertx(gva.ok(k));
-        va.push(gva[k]);
-        Sppdist2.enter(dist2(el[i].p, mesh.point(gva[k])));
-      }
+    for_intL(i, poly_start[poly], poly_start[poly + 1]) va.push(class_vertex[point_class[i]]);
+    bool repeated = false;
+    for_int(i, va.num()) for_int(j, i) repeated = repeated || va[i] == va[j];
+    if (va.num() < 3 || repeated) {
+      num_degenerate++;
+    } else if (!mesh.legal_create_face(va)) {
+      if (has_duplicate_face(va))
+        num_duplicate++;
+      else
+        num_nonmanifold++;
+    } else {
+      mesh.create_face(va);
     }
-    if (!assertw(mesh.legal_create_face(va))) continue;
-    mesh.create_face(va);
   }
+  showdf("froma3d: welded %d points into %d vertices\n", points.num(), num_classes);
+  if (num_degenerate + num_duplicate + num_nonmanifold)
+    showdf("froma3d: skipped %d degenerate, %d duplicate, and %d non-manifold faces\n",  //
+           num_degenerate, num_duplicate, num_nonmanifold);
 }
 
 void do_rawfroma3d() {
@@ -349,39 +386,38 @@ void normalize_arrayv(ArrayView<Vertex> ar) {
 // Given mesh mo, merge the vertices, producing mesh mn.
 GMesh geometric_merge(const GMesh& mo) {
   // Adapted from GMesh::merge() and do_froma3d().
-  // Use bbox so that error between
+  // weld_points() uses a tolerance relative to the bbox, so that error between
   //  Vertex x 0.00502754 31.3495 30.7251
   //  Vertex x 0.00504071 31.3495 30.7251
   // is irrelevant if the bbox is of size 200.
-  // Thus, gmerge is always more robust than do_froma3d().
-  const Bbox bbox{transform(mesh.vertices(), [&](Vertex v) { return mesh.point(v); })};
-  const Frame xform = bbox.get_frame_to_small_cube();
   GMesh mn;
   // Create new vertices.
   Map<Vertex, Vertex> mvvn;
   {
-    HashPoint hp;
-    Array<Vertex> gva;
-    for (Vertex vo : mo.ordered_vertices()) {
-      int i;
-      if (bndmerge && !mo.num_boundaries(vo)) {
-        i = -1;
-      } else {
-        Point p = mo.point(vo) * xform;
-        i = hp.enter(p);
-      }
-      if (0) SHOW(i, mo.point(vo));
-      Vertex vn;
-      if (i == -1 || i == gva.num()) {
+    const Array<Vertex> vertices{mo.ordered_vertices()};
+    Array<int> vmerge;  // Vertices that participate in merging.
+    Array<Point> points;
+    for_int(i, vertices.num()) {
+      if (bndmerge && !mo.num_boundaries(vertices[i])) continue;
+      vmerge.push(i);
+      points.push(mo.point(vertices[i]));
+    }
+    Array<int> point_class;
+    const int num_classes = weld_points(points, point_class);
+    Array<int> vertex_class(vertices.num(), -1);
+    for_int(j, vmerge.num()) vertex_class[vmerge[j]] = point_class[j];
+    Array<Vertex> gva(num_classes, nullptr);
+    for_int(i, vertices.num()) {
+      const Vertex vo = vertices[i];
+      const int k = vertex_class[i];
+      Vertex vn = k < 0 ? nullptr : gva[k];
+      if (!vn) {
         vn = mn.create_vertex_private(mo.vertex_id(vo));
         mn.set_point(vn, mo.point(vo));
         mn.flags(vn) = mo.flags(vo);
         mn.set_string(vn, mo.get_string(vo));
-        // mn.update_string(vn, "Ovi", csform(str, "%d", mn.vertex_id(vn)));
-        if (i == gva.num()) gva.push(vn);
+        if (k >= 0) gva[k] = vn;
       } else {
-        assertx(gva.ok(i));
-        vn = gva[i];
         HH_SSTAT(Smerged, dist(mo.point(vo), mn.point(vn)));
       }
       mvvn.enter(vo, vn);
@@ -770,6 +806,11 @@ void do_renumber() {
   mesh.renumber();
 }
 
+void do_reorderlocality() {
+  HH_TIMER("_reorderlocality");
+  reorder_for_locality(mesh);
+}
+
 void do_nidrenumberv() {
   HH_TIMER("_nidrenumberv");
   Set<Vertex> setv;
@@ -853,49 +894,39 @@ void do_diagonal() {
 
 // *** segment
 
-void gather_follow_seg(Face f, Map<Face, int>& mfseg, int segnum, int& pnf, Point& pcentroid) {
-  int nf = 0;
-  Homogeneous h;
-  Queue<Face> queuef;
-  mfseg.enter(f, segnum);
+// Label the segments (components separated by sharp edges), with mfseg mapping each face to its segment number
+// (1-based, in order of mesh.faces()), and arepf containing one representative face per segment.
+void gather_segments(Map<Face, int>& mfseg, Array<Face>& arepf) {
+  assertx(mfseg.empty() && !arepf.num());
+  const Array<Face> faces{mesh.faces()};
+  Array<int> face_labels;
+  const int num_segments = label_components(mesh, faces, face_labels, [](Edge e) { return !sharp(e); });
+  Array<Face> segment_face(num_segments, nullptr);
+  Array<int> segment_nf(num_segments, 0);
+  Array<Homogeneous> segment_h(num_segments);
   Polygon poly;
-  for (;;) {
-    nf++;
+  for_int(i, faces.num()) {
+    const Face f = faces[i];
+    const int seg = face_labels[i];
+    mfseg.enter(f, seg + 1);
+    if (!segment_face[seg]) segment_face[seg] = f;
+    segment_nf[seg]++;
     mesh.polygon(f, poly);
-    h += poly.get_area() * Homogeneous(mean(poly));
-    for (Edge e : mesh.edges(f)) {
-      if (sharp(e)) continue;
-      Face f2 = mesh.opp_face(f, e);
-      bool is_new;
-      mfseg.enter(f2, segnum, is_new);
-      if (is_new) queuef.enqueue(f2);
-    }
-    if (queuef.empty()) break;
-    f = queuef.dequeue();
-  }
-  if (!h[3]) {
-    Warning("Segment has zero area");
-    h[3] = 1.f;
+    segment_h[seg] += poly.get_area() * Homogeneous(mean(poly));
   }
-  pnf = nf;
-  pcentroid = to_Point(normalized(h));
-}
-
-void gather_segments(Map<Face, int>& mfseg, Array<Face>& arepf) {
-  assertx(mfseg.empty() && !arepf.num());
   HPqueue<Face> pq;
   {
     HH_STAT(Sseg);
-    int segnum = 0;
-    for (Face f : mesh.faces()) {
-      if (mfseg.contains(f)) continue;
-      segnum++;
-      int nf;
-      Point pc;
-      gather_follow_seg(f, mfseg, segnum, nf, pc);
-      Sseg.enter(nf);
+    for_int(seg, num_segments) {
+      Homogeneous& h = segment_h[seg];
+      if (!h[3]) {
+        Warning("Segment has zero area");
+        h[3] = 1.f;
+      }
+      const Point pc = to_Point(normalized(h));
+      Sseg.enter(segment_nf[seg]);
       float pri = abs(pc[0] * 37.f + pc[1] * 17.f + pc[2]);
-      pq.enter(f, pri);
+      pq.enter(segment_face[seg], pri);
     }
   }
   while (!pq.empty()) {
@@ -955,31 +986,14 @@ void do_segment() {
 
 // *** Record segment numbers
 
-void record_segment(Face f, Map<Face, int>& mfseg) {
-  Queue<Face> queuef;
-  int segnum = mfseg.remove(f);
-  assertx(segnum);
-  string str;
-  for (;;) {
-    mesh.update_string(f, "segn", csform(str, "%d", segnum - 1));
-    for (Edge e : mesh.edges(f)) {
-      if (sharp(e)) continue;
-      Face f2 = mesh.opp_face(f, e);
-      if (mfseg.remove(f2)) queuef.enqueue(f2);
-    }
-    if (queuef.empty()) break;
-    f = queuef.dequeue();
-  }
-}
-
 void do_recordsegments() {
   HH_TIMER("_recordsegments");
   Map<Face, int> mfseg;  // Face -> segment number
   Array<Face> arepf;
   gather_segments(mfseg, arepf);
   showdf("Detected %d segments\n", arepf.num());
-  for (Face f : arepf) record_segment(f, mfseg);
-  assertx(mfseg.empty());
+  string str;
+  for (const auto& [f, segnum] : mfseg) mesh.update_string(f, "segn", csform(str, "%d", segnum - 1));
 }
 
 // *** selsmooth
@@ -1274,117 +1288,58 @@ void do_taubinsmooth(Args& args) {
     lambda = 0.33f;
     mu = -0.34f;
   }
+  const MeshLaplacian laplacian(mesh, MeshLaplacian::EWeights::uniform);
+  Array<bool> movable(laplacian.num());
   int nnewv = 0;
-  for (Vertex v : mesh.vertices())
-    if (GMesh::string_has_key(mesh.get_string(v), "newvertex")) nnewv++;
+  for_int(i, laplacian.num()) {
+    movable[i] = GMesh::string_has_key(mesh.get_string(laplacian.vertices()[i]), "newvertex");
+    nnewv += movable[i];
+  }
   if (nnewv) Warning("Only smoothing new vertices");
-  Map<Vertex, Point> mvp;
-  for (Vertex v : mesh.vertices()) mvp.enter(v, Point());
+  if (!nnewv) movable.init(0);
+  Array<Point> points = laplacian.get_points(mesh), newpoints(points.num());
   // HH: introduced the factor * 2 on niter on 1999-01-04.
   for_int(i, niter * 2) {
     float disp = i % 2 == 0 ? lambda : mu;
-    for (Vertex v : mesh.vertices()) {
-      Homogeneous h;
-      int n = 0;
-      for (Vertex vv : mesh.vertices(v)) {
-        h += mesh.point(vv);
-        n++;
-      }
-      h += float(-n) * Homogeneous(mesh.point(v));
-      assertx(n);
-      h /= float(n);
-      Vector vec = to_Vector(h) * disp;
-      if (nnewv && !GMesh::string_has_key(mesh.get_string(v), "newvertex")) vec = Vector(0.f, 0.f, 0.f);
-      Point p = mesh.point(v) + vec;
-      mvp.get(v) = p;
-    }
-    for (Vertex v : mesh.vertices()) mesh.set_point(v, mvp.get(v));
+    laplacian.smooth_step(points, newpoints, disp, movable);
+    swap(points, newpoints);
   }
+  laplacian.set_points(mesh, points);
 }
 
 // *** Desbrun
 
-// Return cotangent of angle about point p1 in triangle, or BIGFLOAT if triangle is degenerate about p1.
-float cotan(const Point& p1, const Point& p2, const Point& p3) {
-  Vector v = p2 - p1, w = p3 - p1;
-  // cos(ang) = dot(v, w) / (mag(v) * mag(w))
-  // sin(ang) = mag(cross(v, w)) / (mag(v) * mag(w))
-  // -> cot(ang) = dot(v, w) / mag(cross(v, w))
-  float vcos = dot(v, w);
-  float vsin = mag(cross(v, w));
-  if (!vsin) Warning("cotan: found degenerate triangle");
-  return !vsin ? BIGFLOAT : vcos / vsin;
-}
-
 void do_desbrunsmooth(Args& args) {
   HH_TIMER("_desbrunsmooth");
   float lambda = args.get_float();
   assertx(lambda > 0.f);
   const bool use_taubin_laplacian = false;
-  Array<Vertex> a_v;
-  Map<Vertex, int> m_vi;
-  for (Vertex v : mesh.vertices()) {
-    m_vi.enter(v, a_v.num());
-    a_v.push(v);
-  }
-  SparseLls lls(a_v.num(), a_v.num(), 3);
+  const MeshLaplacian laplacian(
+      mesh, use_taubin_laplacian ? MeshLaplacian::EWeights::uniform : MeshLaplacian::EWeights::cotangent);
+  const int nv = laplacian.num();
+  SparseLls lls(nv, nv, 3);
   lls.set_tolerance(1e-6f);
   lls.set_verbose(1);
-  Array<int> nei_vi;
-  Array<float> nei_w;
-  for (Vertex v : mesh.vertices()) {
-    if (mesh.is_boundary(v)) {
+  for_int(i, nv) {
+    const Point& p = mesh.point(laplacian.vertices()[i]);
+    CArrayView<int> nei_vi = laplacian.neighbors(i);
+    if (!nei_vi.num()) {
       Warning("Boundary vertex not smoothed");
-      lls.enter_a_rc(m_vi.get(v), m_vi.get(v), 1.f);
-      lls.enter_b_r(m_vi.get(v), mesh.point(v));
+      lls.enter_a_rc(i, i, 1.f);
+      lls.enter_b_r(i, p);
       continue;
     }
-    float sum_area = 0.f;
-    for (Face f : mesh.faces(v)) sum_area += mesh.area(f);
-    assertx(sum_area > 0.f);
-    float sum_w = 0.f;
-    nei_vi.init(0);
-    nei_w.init(0);
-    for (Vertex vv : mesh.vertices(v)) {  // unsorted!
-      nei_vi.push(m_vi.get(vv));
-      float w;
-      if (use_taubin_laplacian) {
-        w = 1.f;
-      } else {
-        Vertex vp = mesh.clw_vertex(v, vv);
-        Vertex vn = mesh.ccw_vertex(v, vv);
-        float cotp = cotan(mesh.point(vp), mesh.point(vv), mesh.point(v));
-        float cotn = cotan(mesh.point(vn), mesh.point(v), mesh.point(vv));
-        w = cotn + cotp;
-        if (w < 0.f) Warning("Desbrun: negative edge weight, hope OK");
-        if (cotp == BIGFLOAT || cotn == BIGFLOAT) {
-          Warning("Degenerate triangle");
-          // OK to have two edges each have BIGFLOAT / (2 * BIGFLOAT) == .5f weight.
-          if (0) w = 0.f;
-        }
-      }
-      nei_w.push(w);
-      sum_w += w;
-    }
-    assertx(sum_w);
-    if (0) {  // this makes lambda scale-dependent (bad)
-      for_int(j, nei_vi.num()) nei_w[j] /= (4.f * sum_area);
-      sum_w /= (4.f * sum_area);
-    } else {  // "normalized" version from Section 5.5
-      for_int(j, nei_vi.num()) nei_w[j] /= sum_w;
-      sum_w = 1.f;
-    }
-    lls.enter_a_rc(m_vi.get(v), m_vi.get(v), 1.f + lambda * sum_w);
-    for_int(j, nei_vi.num()) lls.enter_a_rc(m_vi.get(v), nei_vi[j], -lambda * nei_w[j]);
-    lls.enter_b_r(m_vi.get(v), mesh.point(v));
-    lls.enter_xest_r(m_vi.get(v), mesh.point(v));
+    // "normalized" version from Section 5.5 (the laplacian weights sum to 1).
+    CArrayView<float> nei_w = laplacian.weights(i);
+    lls.enter_a_rc(i, i, 1.f + lambda);
+    for_int(j, nei_vi.num()) lls.enter_a_rc(i, nei_vi[j], -lambda * nei_w[j]);
+    lls.enter_b_r(i, p);
+    lls.enter_xest_r(i, p);
   }
   assertx(lls.solve());
-  for_int(i, a_v.num()) {
-    Point p;
-    lls.get_x_r(i, p);
-    mesh.set_point(a_v[i], p);
-  }
+  Array<Point> points(nv);
+  for_int(i, nv) lls.get_x_r(i, points[i]);
+  laplacian.set_points(mesh, points);
 }
 
 // *** LSCM parameterization
@@ -1859,14 +1814,14 @@ void do_quadodddiag() {
 
 // *** rmcomponents
 
-void remove_component(const Set<Face>& setf) {
-  Set<Vertex> setv;
-  for (Face f : setf) {
-    for (Vertex v : mesh.vertices(f)) setv.add(v);  // May already be there.
-    mesh.destroy_face(f);
-  }
-  for (Vertex v : setv)
-    if (!mesh.degree(v)) mesh.destroy_vertex(v);
+// Keep only the faces faces[i] for which keep[i] is true, rebuilding the mesh in one pass.
+void retain_faces(CArrayView<Face> faces, CArrayView<bool> keep) {
+  Array<Face> fa;
+  for_int(i, faces.num()) if (keep[i]) fa.push(faces[i]);
+  if (fa.num() == faces.num()) return;
+  GMesh nmesh;
+  nmesh.copy_faces(mesh, fa);
+  mesh = std::move(nmesh);
 }
 
 void remove_isolated_vertices() {
@@ -1880,32 +1835,41 @@ void remove_isolated_vertices() {
 void do_rmcomp(Args& args) {
   HH_TIMER("_rmcomp");
   int maxnumf = args.get_int();
-  const Array<Set<Face>> components = gather_components(mesh);
-  HH_STAT(Sfacesrem);
-  for (const Set<Face>& setf : components) {
-    const int nf = setf.num();
-    if (nf >= maxnumf) continue;
-    Sfacesrem.enter(nf);
-    remove_component(setf);
-  }
-  showdf("Removed %d out of %d mesh components\n", Sfacesrem.inum(), components.num());
   remove_isolated_vertices();
+  const Array<Face> faces{mesh.faces()};
+  Array<int> face_labels;
+  const int num_components = label_components(mesh, faces, face_labels);
+  Array<int> component_nf(num_components, 0);
+  for (const int label : face_labels) component_nf[label]++;
+  HH_STAT(Sfacesrem);
+  for (const int nf : component_nf)
+    if (nf < maxnumf) Sfacesrem.enter(nf);
+  retain_faces(faces, map(face_labels, [&](int label) { return component_nf[label] >= maxnumf; }));
+  showdf("Removed %d out of %d mesh components\n", Sfacesrem.inum(), num_components);
 }
 
 void do_rmcompn(Args& args) {
   HH_TIMER("_rmcompn");
   const int ncomp = args.get_int();
+  remove_isolated_vertices();
+  const Array<Face> faces{mesh.faces()};
+  Array<int> face_labels;
+  const int num_components = label_components(mesh, faces, face_labels);
+  Array<int> component_nf(num_components, 0);
+  for (const int label : face_labels) component_nf[label]++;
+  Array<int> by_increasing_size{range(num_components)};
+  std::stable_sort(by_increasing_size.begin(), by_increasing_size.end(),
+                   [&](int c1, int c2) { return component_nf[c1] < component_nf[c2]; });
+  const int num_to_remove = max(num_components - ncomp, 0);
+  Array<bool> keep_component(num_components, true);
   HH_STAT(Sfacesrem);
-  const Array<Set<Face>> components = gather_components(mesh);
-  const int num_to_remove = max(components.num() - ncomp, 0);
   for_int(i, num_to_remove) {
-    const Set<Face>& setf = components[i];
-    const int nf = setf.num();
-    Sfacesrem.enter(nf);
-    remove_component(setf);
+    const int c = by_increasing_size[i];
+    Sfacesrem.enter(component_nf[c]);
+    keep_component[c] = false;
   }
-  showdf("Removed %d out of %d mesh components\n", Sfacesrem.inum(), components.num());
-  remove_isolated_vertices();
+  retain_faces(faces, map(face_labels, [&](int label) { return keep_component[label]; }));
+  showdf("Removed %d out of %d mesh components\n", Sfacesrem.inum(), num_components);
 }
 
 // *** coalesce
@@ -2662,6 +2626,25 @@ float reduce_criterion(Edge e) {
   }
 }
 
+struct struct_e_pqindex {
+  int i{0};  // Position in the do_reduce() queue (plus one), or 0.
+};
+HH_SACABLE(struct_e_pqindex);
+HH_SAC_ALLOCATE_CD_FUNC(Mesh::MEdge, struct_e_pqindex, func_e_pqindex);
+
+struct EdgePqIndex {
+  int& operator()(Edge e) const { return func_e_pqindex(e).i; }
+};
+
+// Order the edges by their vertex ids rather than by their (run-dependent) addresses, so that equal-cost edges
+// enter the priority queue in a reproducible order.
+Array<Edge> sorted_by_vertex_ids(const Set<Edge>& edges) {
+  Array<Edge> ar_edge(edges);
+  const auto key = [](Edge e) { return std::pair{mesh.vertex_id(mesh.vertex1(e)), mesh.vertex_id(mesh.vertex2(e))}; };
+  sort(ar_edge, [&](Edge e1, Edge e2) { return key(e1) < key(e2); });
+  return ar_edge;
+}
+
 void do_reduce_old_sequential() {
   HH_TIMER("_reduce");
   assertx(reducecrit != EReduceCriterion::undefined);  // Also use: nfaces, maxcrit.
@@ -2704,7 +2687,7 @@ void do_reduce_old_sequential() {
     for (Vertex v : mesh.vertices(vkept))
       for (Edge e2 : mesh.edges(v)) edges_to_update.add(e2);
     // Applying parallel_for_each() is slower because the parallelism is too fine-grained and memory-incoherent.
-    for (Edge e2 : edges_to_update) pqe.enter_update(e2, reduce_criterion(e2));
+    for (Edge e2 : sorted_by_vertex_ids(edges_to_update)) pqe.enter_update(e2, reduce_criterion(e2));
   }
   cprogress.clear();
 }
@@ -2716,7 +2699,7 @@ void do_reduce() {
   }
   HH_TIMER("_reduce");
   assertx(reducecrit != EReduceCriterion::undefined);  // Also use: nfaces, maxcrit.
-  HPqueue<Edge> pqe;
+  IPqueue<Edge, EdgePqIndex> pqe;
   {
     HH_TIMER("__initpq");
     Array<Edge> ar_edge(mesh.edges());
@@ -2735,9 +2718,8 @@ void do_reduce() {
     const float fraction = 0.6f;
     if ((pqe.min_priority() > maxcrit || pqe.num() < max(int(mesh.num_edges() * fraction), 500)) &&
         edges_to_update.num()) {
-      Array<Edge> ar_edge(edges_to_update);
+      const Array<Edge> ar_edge = sorted_by_vertex_ids(edges_to_update);
       Array<float> ar_cost(ar_edge.num());
-      if (0) sort(ar_edge);  // No resulting improvement in memory access coherence.
       // With parallelism, 1.3x faster than original version; without parallelism, 1.6x slower.
       parallel_for_each(range(ar_edge.num()), [&](int i) { ar_cost[i] = reduce_criterion(ar_edge[i]); });
       for_int(i, ar_edge.num()) pqe.enter(ar_edge[i], ar_cost[i]);
@@ -2760,6 +2742,7 @@ void do_reduce() {
     for (Vertex v : mesh.vertices(vkept))
       for (Edge e2 : mesh.edges(v)) edges_to_update.add(e2);
   }
+  pqe.clear();  // Reset the queue positions for a later do_reduce().
   cprogress.clear();
 }
 
@@ -3030,6 +3013,25 @@ void do_colorsqheight(Args& args) {
   }
 }
 
+void do_geodesicdist(Args& args) {
+  const int vid = args.get_int();
+  Vertex vseed = assertx(mesh.id_retrieve_vertex(vid));
+  const MeshGeodesic geodesic(mesh);
+  Array<float> dist(geodesic.num());
+  geodesic.distances(V(geodesic.index(vseed)), dist, MeshGeodesic::EMetric::fast_marching);
+  HH_STAT(Sdist);
+  string str;
+  for_int(i, geodesic.num()) {
+    Vertex v = geodesic.vertices()[i];
+    if (dist[i] == BIGFLOAT) {  // Vertex in another connected component.
+      mesh.update_string(v, "dist", nullptr);
+      continue;
+    }
+    Sdist.enter(dist[i]);
+    mesh.update_string(v, "dist", csform(str, "%g", dist[i]));
+  }
+}
+
 void do_colorbizarre() {
   Vec3<Vec2<float>> lfb;
   fill(lfb, V(BIGFLOAT, -BIGFLOAT));
@@ -3433,6 +3435,20 @@ void do_procedure(Args& args) {
 
 // signed distance
 
+// Angle-weighted pseudonormal at a vertex (Baerentzen and Aanaes 2005), for which the sign test is exact.
+Vector vertex_pseudonormal(Vertex v) {
+  Vector nor{};
+  for (Face f : mesh.faces(v)) {
+    const Vec3<Vertex> va = mesh.triangle_vertices(f);
+    const int j = index(va, v);
+    const Point& p0 = mesh.point(v);
+    Vector v1 = mesh.point(va[mod3(j + 1)]) - p0, v2 = mesh.point(va[mod3(j + 2)]) - p0;
+    if (!v1.normalize() || !v2.normalize()) continue;
+    nor += get_normal(mesh.triangle_points(f)) * angle_between_unit_vectors(v1, v2);
+  }
+  return nor;
+}
+
 float signed_distance(const Point& p, Face f) {
   const Vec3<Point> triangle = mesh.triangle_points(f);
   const auto [d2, bary, clp] = project_point_triangle(p, triangle);
@@ -3463,40 +3479,149 @@ float signed_distance(const Point& p, Face f) {
       Vec3<Vertex> va = mesh.triangle_vertices(f);
       Vertex v = va[jpos];
       if (mesh.is_boundary(v)) return k_Contour_undefined;
-      Vector nor{};
-      for (Face ff : mesh.faces(v)) nor += get_normal(mesh.triangle_points(ff));
-      return sqrt(d2) * sign(dot(nor, p - clp));
+      return sqrt(d2) * sign(dot(vertex_pseudonormal(v), p - clp));
     }
     default: assertnever("");
   }
 }
 
-void do_signeddistcontour(Args& args) {
-  // e.g.:
-  // Filtermesh ~/data/mesh/icosahedron.m -signeddistcontour 50 | G3d - -key DmDe
-  // Filtermesh -createobject torus1 -transf "`Filterframe -create_euler 18 23 37`" -triang -signeddistcontour 40 | G3d - -key DmDe
-  int grid = args.get_int();
+// Signed distance to the mesh at the vertices of a contouring grid (as in Contour3DBase::get_point()), computed
+// exactly for all vertices within distance `band` of the surface.  The triangles are first rasterized into blocks
+// of grid vertices; the blocks are then processed in parallel, each finding the closest triangle for its vertices.
+class SignedDistanceBand {
+ public:
+  SignedDistanceBand(int gn, float band) : _gn(gn), _gni(1.f / gn), _nb((gn + k_block) / k_block) {
+    HH_TIMER("_signeddistband");
+    assertx(gn > 0 && band > 0.f);
+    const Array<Face> faces{mesh.faces()};
+    Array<Array<int>> block_faces(_nb * _nb * _nb);
+    for_int(fi, faces.num()) {
+      const auto [lo, hi] = vertex_range(faces[fi], band);
+      if (!(lo[0] <= hi[0] && lo[1] <= hi[1] && lo[2] <= hi[2])) continue;
+      for (const Vec3<int>& bi : range(lo / k_block, hi / k_block + 1)) block_faces[block_index(bi)].push(fi);
+    }
+    Array<int> blocks;
+    for_int(b, block_faces.num()) if (block_faces[b].num()) blocks.push(b);
+    _values.init(block_faces.num());
+    const int k_block3 = k_block * k_block * k_block;
+    parallel_for_each({uint64_t(k_block3) * 200}, range(blocks.num()), [&](const int i) {
+      const int b = blocks[i];
+      const Vec3<int> b0 = Vec3<int>(b / (_nb * _nb), (b / _nb) % _nb, b % _nb) * k_block;
+      const Vec3<int> b1 = b0 + k_block - 1;
+      Array<float> d2s(k_block3, BIGFLOAT);
+      Array<Face> closest(k_block3, nullptr);
+      for (const int fi : block_faces[b]) {
+        const Face f = faces[fi];
+        const Vec3<Point> triangle = mesh.triangle_points(f);
+        const auto [lo, hi] = vertex_range(f, band);
+        for (const Vec3<int>& ci : range(max(lo, b0), min(hi, b1) + 1)) {
+          const int k = local_index(ci - b0);
+          const float d2 = project_point_triangle(get_point(ci), triangle).d2;
+          if (d2 < d2s[k]) {
+            d2s[k] = d2;
+            closest[k] = f;
+          }
+        }
+      }
+      Array<float>& values = _values[b];
+      values.init(k_block3, BIGFLOAT);
+      for (const Vec3<int>& cd : range(thrice(k_block))) {
+        const int k = local_index(cd);
+        if (d2s[k] <= square(band)) values[k] = signed_distance(get_point(b0 + cd), closest[k]);
+      }
+    });
+    showdf("Signed distance band: %d blocks of %d^3 vertices\n", blocks.num(), k_block);
+  }
+  // Return the signed distance at grid point p, or BIGFLOAT if p is not a grid vertex within the band.
+  float lookup(const Point& p) const {
+    Vec3<int> ci;
+    for_int(c, 3) ci[c] = int(p[c] * _gn + .5f);
+    if (!ci.in_range(thrice(_gn + 1)) || get_point(ci) != p) return BIGFLOAT;
+    const Array<float>& values = _values[block_index(ci / k_block)];
+    return values.num() ? values[local_index(ci % k_block)] : BIGFLOAT;
+  }
+
+ private:
+  static constexpr int k_block = 8;  // Number of grid vertices per block along each axis.
+  int _gn;
+  float _gni;
+  int _nb;                      // Number of blocks along each axis.
+  Array<Array<float>> _values;  // Per block, vertex values (BIGFLOAT if outside band); empty if no nearby faces.
+  Point get_point(const Vec3<int>& ci) const {
+    Point p;
+    for_int(c, 3) p[c] = ci[c] < _gn ? ci[c] * _gni : 1.f;
+    return p;
+  }
+  int block_index(const Vec3<int>& bi) const { return (bi[0] * _nb + bi[1]) * _nb + bi[2]; }
+  static int local_index(const Vec3<int>& cd) { return (cd[0] * k_block + cd[1]) * k_block + cd[2]; }
+  // Range of grid vertices within distance band of the bounding box of face f.
+  std::pair<Vec3<int>, Vec3<int>> vertex_range(Face f, float band) const {
+    const Bbox bbox{mesh.triangle_points(f)};
+    Vec3<int> lo, hi;
+    for_int(c, 3) {
+      lo[c] = max(int(std::ceil((bbox[0][c] - band) * _gn)), 0);
+      hi[c] = min(int(std::floor((bbox[1][c] + band) * _gn)), _gn);
+    }
+    return {lo, hi};
+  }
+};
+
+// Contour the surface at the given signed distance from the (triangle) mesh, after scaling the mesh into the unit
+// cube.  The distances are precomputed in parallel over a narrow band of grid vertices about the contour; the marching
+// traversal only falls back to a closest-point search for the rare grid vertices outside that band.
+void contour_signed_distance(int grid, float offset) {
   assertx(grid >= 2);
   {
     const Bbox bbox{transform(mesh.vertices(), [&](Vertex v) { return mesh.point(v); })};
     const Frame xform = bbox.get_frame_to_small_cube();
     showdf("Applying xform: %s", FrameIO::create_string(ObjectFrame{xform, 1}).c_str());
     for (Vertex v : mesh.vertices()) mesh.set_point(v, mesh.point(v) * xform);
+    offset *= xform[0][0];
   }
+  // A cube visited by the contouring has a face crossed by the surface, so its vertices are within sqrt(3) cells.
+  const float band = abs(offset) + 2.f / grid;
+  const SignedDistanceBand signed_distance_band(grid, band);
   const MeshSearch mesh_search(mesh, {});
+  int num_fallback = 0;
   const auto func_mesh_signed_distance = [&](const Vec3<float>& p) {
-    Face f = mesh_search.search(p, nullptr).f;
-    return signed_distance(p, f);
+    float d = signed_distance_band.lookup(p);
+    if (d == BIGFLOAT) {
+      num_fallback++;
+      Face f = mesh_search.search(p, nullptr).f;
+      d = signed_distance(p, f);
+    }
+    return d == k_Contour_undefined ? d : d - offset;
   };
   GMesh nmesh;
   {
     Contour3DMesh contour(grid, &nmesh, func_mesh_signed_distance);
     contour.set_ostream(&std::cout);
-    for (Vertex v : mesh.vertices()) contour.march_from(mesh.point(v));
+    for (Vertex v : mesh.vertices()) {
+      Point p = mesh.point(v);
+      if (offset && mesh.degree(v) && !mesh.is_boundary(v)) p += ok_normalized(vertex_pseudonormal(v)) * offset;
+      for_int(c, 3) p[c] = clamp(p[c], 0.f, 1.f);
+      contour.march_from(p);
+    }
   }
+  if (num_fallback) showdf("Evaluated %d grid vertices outside the band\n", num_fallback);
   mesh.copy(nmesh);
 }
 
+void do_signeddistcontour(Args& args) {
+  // e.g.:
+  // Filtermesh ~/data/mesh/icosahedron.m -signeddistcontour 50 | G3d - -key DmDe
+  // Filtermesh -createobject torus1 -transf "`Filterframe -create_euler 18 23 37`" -triang -signeddistcontour 40 | G3d - -key DmDe
+  int grid = args.get_int();
+  contour_signed_distance(grid, 0.f);
+}
+
+// e.g.: Filtermesh ~/data/mesh/bunny.nf400.m -offsetcontour 200 .01 | G3d - -key DmDe
+void do_offsetcontour(Args& args) {
+  int grid = args.get_int();
+  float offset = args.get_float();
+  contour_signed_distance(grid, offset);
+}
+
 // *** hull
 
 Point compute_hull_point(Vertex v, float offset) {
@@ -4259,6 +4384,7 @@ int main(int argc, const char** argv) {
   HH_ARGSD(fromObj, "file.obj [flip] : import obj");
   HH_ARGSC("", ":");
   HH_ARGSD(renumber, ": renumber vertices and faces");
+  HH_ARGSD(reorderlocality, ": rebuild mesh with faces and vertices in spatial (Morton) order");
   HH_ARGSD(nidrenumberv, ": renumber vertices to have id=key{'Nid'}");
   HH_ARGSD(merge, "mesh1 mesh2 ... : merge other meshes");
   HH_ARGSD(outmesh, ": output mesh now");
@@ -4345,6 +4471,7 @@ int main(int argc, const char** argv) {
   HH_ARGSD(colorheight, "fac : assign vertex rgb based on elevation");
   HH_ARGSD(colorsqheight, "fac : same but with squared elevation");
   HH_ARGSD(colorbizarre, ": assign vertex rgb interestingly");
+  HH_ARGSD(geodesicdist, "vid : assign vertex dist key as geodesic distance from vertex vid");
   HH_ARGSD(colortransf, "'frame' : affine transform by frame");
   HH_ARGSD(normaltransf, "'frame' : affine transform by frame");
   HH_ARGSD(rmfarea, "area : remove faces with <area");
@@ -4353,6 +4480,7 @@ int main(int argc, const char** argv) {
   HH_ARGSD(uvtopos, ": replace vertex positions by uv");
   HH_ARGSD(perturbz, "scale : perturb z positions by [-1, 1]*scale");
   HH_ARGSD(signeddistcontour, "grid : contour signed distance to mesh");
+  HH_ARGSD(offsetcontour, "grid offset : contour offset surface of mesh at signed distance");
   HH_ARGSD(splitdiaguv, ": for uv grid, split diagonal edges");
   HH_ARGSD(rmdiaguv, ": for uv grid, remove diagonal edges");
   HH_ARGSD(obtusesplit, ": split obtuse tris, possibly on sphere");
@@ -1,4 +1,7 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include <atomic>
+#include <functional>  // std::function<>
+
 #include "VideoViewer/GradientDomainLoop.h"
 #include "libHh/Advanced.h"  // clone()
 #include "libHh/Args.h"
@@ -10,6 +13,7 @@
 #include "libHh/GridPixelOp.h"  // spatially_scale_Grid3_Pixel()
 #include "libHh/Homogeneous.h"
 #include "libHh/Image.h"
+#include "libHh/Map.h"
 #include "libHh/MathOp.h"    // smooth_step(), frac(Vec<>), floor(Vec<>)
 #include "libHh/MatrixOp.h"  // euclidean_distance_map()
 #include "libHh/Multigrid.h"
@@ -108,7 +112,7 @@ int parse_nframes(string s, bool measure_neg_from_end) {
 void read_video(const string& filename, bool use_nv12) {
   // Similar code in: Video::read_file(), VideoNv12::read_file(), and FilterVideo.cpp::read_video().
   HH_TIMER("_read_video");
-  RVideo rvideo(filename, use_nv12);
+  RVideo rvideo(filename, use_nv12, RVideo::k_default_prefetch);
   showf("Reading video %s\n", Video::diagnostic_string(rvideo.dims(), rvideo.attrib()).c_str());
   const int nfexpect = rvideo.nframes() - trunc_begin;
   const int nf_read_expect = max(min(nfexpect, trunc_frames), 0);
@@ -1054,7 +1058,7 @@ void do_gridcrop(Args& args) {
   assemble_videos(videos);
 }
 
-void do_replace(Args& args) {
+Pixel parse_replace_color(Args& args) {
   Pixel newcolor;
   for_int(i, 3) {
     int v = args.get_int();
@@ -1062,20 +1066,37 @@ void do_replace(Args& args) {
     newcolor[i] = uint8_t(v);
   }
   newcolor[3] = 255;
+  return newcolor;
+}
+
+// Returns the number of replaced pixels.
+int replace_pixels(ArrayView<Pixel> pixels, const Pixel& color, bool negate, const Pixel& newcolor) {
   int count = 0;
-  for (Pixel& pix : video) {
-    if (equal(pix, gcolor, nz) ^ g_not) {
+  for (Pixel& pix : pixels) {
+    if (equal(pix, color, nz) ^ negate) {
       count++;
       pix = newcolor;
     }
   }
+  return count;
+}
+
+void do_replace(Args& args) {
+  const Pixel newcolor = parse_replace_color(args);
+  int count = 0;
+  for_int(f, video.nframes()) count += replace_pixels(video[f].array_view(), gcolor, g_not, newcolor);
   showf("Replaced %d pixels\n", count);
 }
 
-void do_gamma(Args& args) {
-  float gamma = args.get_float();
+Vec<uint8_t, 256> gamma_table(float gamma) {
   Vec<uint8_t, 256> transf;
   for_int(i, 256) transf[i] = static_cast<uint8_t>(255.f * pow(i / 255.f, gamma) + 0.5f);
+  return transf;
+}
+
+void do_gamma(Args& args) {
+  float gamma = args.get_float();
+  const Vec<uint8_t, 256> transf = gamma_table(gamma);
   if (1) {
     parallel_for_each({10}, range(video.size()), [&](const size_t i) {
       for_int(z, nz) video.flat(i)[z] = transf[video.flat(i)[z]];  // fastest
@@ -1688,7 +1709,7 @@ void do_gdloopfile(Args& args) {
     Warning("Clearing audio");
     video.attrib().audio.clear();
   }
-  WVideo wvideo(loop_filename, sdims, video.attrib(), use_nv12);
+  WVideo wvideo(loop_filename, sdims, video.attrib(), use_nv12, WVideo::k_default_queued);
   VideoNv12 dummy_vnv12;
   compute_gdloop(dims, "", video, video_nv12, g_lp.mat_start, g_lp.mat_period, GdLoopScheme::fast, nnf, &wvideo,
                  Grid<3, Pixel>{}, dummy_vnv12, 1);
@@ -1718,7 +1739,7 @@ void do_gdloopstream(Args& args) {
     Warning("Clearing audio");
     attrib.audio.clear();
   }
-  WVideo wvideo(loop_filename, odims.tail<2>(), attrib, use_nv12);
+  WVideo wvideo(loop_filename, odims.tail<2>(), attrib, use_nv12, WVideo::k_default_queued);
   const GdLoopScheme scheme = GdLoopScheme::fast;
   VideoNv12 dummy_vnv12;
   compute_gdloop(odims, video_filename, Grid<3, Pixel>{}, VideoNv12{}, g_lp.mat_start, g_lp.mat_period, scheme, nnf,
@@ -2140,22 +2161,28 @@ void do_diff(Args& args) {
   });
 }
 
+void transform_pixels(ArrayView<Pixel> pixels, const Frame& frame) {
+  for (Pixel& pix : pixels) {
+    Point p{};
+    for_int(z, nz) p[z] = pix[z] / 255.f;
+    p *= frame;
+    for_int(z, nz) pix[z] = uint8_t(clamp(p[z], 0.f, 1.f) * 255.f + .5f);
+  }
+}
+
 void do_transf(Args& args) {
   Frame frame = FrameIO::parse_frame(args.get_string());
-  parallel_for_each(range(video.nframes()), [&](const int f) {
-    for (Pixel& pix : video[f]) {
-      Point p{};
-      for_int(z, nz) p[z] = pix[z] / 255.f;
-      p *= frame;
-      for_int(z, nz) pix[z] = uint8_t(clamp(p[z], 0.f, 1.f) * 255.f + .5f);
-    }
-  });
+  parallel_for_each(range(video.nframes()), [&](const int f) { transform_pixels(video[f].array_view(), frame); });
+}
+
+void add_gaussian_noise(ArrayView<Pixel> pixels, float sd, Random& random) {
+  for (Pixel& pix : pixels)
+    for_int(z, nz) pix[z] = clamp_to_uint8(int(to_float(pix[z]) + random.gauss() * sd + .5f));
 }
 
 void do_noisegaussian(Args& args) {
   float sd = args.get_float();
-  for (Pixel& pix : video)
-    for_int(z, nz) pix[z] = clamp_to_uint8(int(to_float(pix[z]) + Random::G.gauss() * sd + .5f));
+  for_int(f, video.nframes()) add_gaussian_noise(video[f].array_view(), sd, Random::G);
 }
 
 Vector frame_median(CMatrixView<Pixel> frame) {
@@ -2207,11 +2234,174 @@ void do_frameinfo() {
   }
 }
 
+// *** frame streaming
+
+// Options that can be applied while streaming frames, with their number of parameters.
+// The first ones act on each frame independently; the others only set state or video attributes.
+const Map<string, int>& streaming_options() {
+  static const auto& k_options = *new Map<string, int>{
+      {"-cropsides", 4}, {"-scaleunif", 1}, {"-gamma", 1}, {"-transf", 1}, {"-replace", 3},
+      {"-noisegaussian", 1}, {"-fliphorizontal", 0}, {"-flipvertical", 0},
+      {"-color", 3}, {"-not", 0}, {"-boundaryrule", 1}, {"-filter", 1},
+      {"-to", 1}, {"-bitrate", 1}, {"-framerate", 1}, {"-noaudio", 0},
+  };
+  return k_options;
+}
+
+bool can_stream(CArrayView<string> sargs) {
+  if (getenv_bool("FILTERVIDEO_NO_STREAM")) return false;
+  for (int i = 0; i < sargs.num();) {
+    bool present;
+    const int nparams = streaming_options().retrieve(sargs[i], present);
+    if (!present || i + 1 + nparams > sargs.num()) return false;
+    i += 1 + nparams;
+  }
+  return true;
+}
+
+// Read the video one frame at a time, apply the operations in sargs (which must satisfy can_stream()), and write the
+// result to stdout.  Only a few frames are held in memory; frames are processed in parallel.
+void stream_video(const string& filename, CArrayView<string> sargs) {
+  HH_TIMER("_stream_video");
+  RVideo rvideo(filename, false, RVideo::k_default_prefetch);
+  showf("Streaming video %s\n", Video::diagnostic_string(rvideo.dims(), rvideo.attrib()).c_str());
+  video.attrib() = rvideo.attrib();
+  if (video.attrib().audio.size() && (trunc_begin || trunc_frames != std::numeric_limits<int>::max())) {
+    Warning("Clearing audio");
+    video.attrib().audio.clear();  // TODO.
+  }
+  // Each operation may replace the frame by one with new dimensions; f is the output frame index.
+  using FrameFunc = std::function<void(Matrix<Pixel>& frame, int f)>;
+  Array<FrameFunc> funcs;
+  Array<unique_ptr<std::atomic<int64_t>>> replace_counts;
+  const Vec2<int> isdims = rvideo.spatial_dims();
+  Vec2<int> sdims = isdims;
+  Args args(sargs);
+  while (args.num()) {
+    const string arg = args.get_string();
+    if (arg == "-cropsides") {
+      const int vl = parse_size(args.get_string(), sdims[1], false);
+      const int vr = parse_size(args.get_string(), sdims[1], false);
+      const int vt = parse_size(args.get_string(), sdims[0], false);
+      const int vb = parse_size(args.get_string(), sdims[0], false);
+      sdims = sdims - V(vt + vb, vl + vr);
+      assertx(sdims[0] >= 0 && sdims[1] >= 0);
+      funcs.push([vl, vr, vt, vb, bndrule = bndrule, color = gcolor](Matrix<Pixel>& frame, int) {
+        frame = hh::crop(frame, V(vt, vl), V(vb, vr), twice(bndrule), &color);
+      });
+    } else if (arg == "-scaleunif") {
+      const Vec2<float> syx = twice(args.get_float());
+      assertx(min(syx) >= 0.f);
+      // Same new dimensions as in hh::scale(const Video&, ...).
+      Vec2<int> newdims = convert<int>(convert<float>(sdims) * syx + .5f);
+      if (video.attrib().suffix != "avi") newdims = (newdims + 1) / 2 * 2;  // make sizes be even integers
+      assertx(product(newdims));
+      sdims = newdims;
+      funcs.push([newdims, filterbs = twice(filterb), color = gcolor](Matrix<Pixel>& frame, int) {
+        Matrix<Pixel> nframe(newdims);
+        scale_Matrix_Pixel(frame, filterbs, &color, nframe);
+        frame = std::move(nframe);
+      });
+      if (max(syx) < 1.f) {
+        video.attrib().bitrate = int(video.attrib().bitrate * pow(float(product(syx)), .8f) + .5f);
+        showf("Reducing bitrate after scaling: %s\n",
+              Video::diagnostic_string(concat(V(rvideo.nframes()), sdims), video.attrib()).c_str());
+      }
+    } else if (arg == "-gamma") {
+      funcs.push([transf = gamma_table(args.get_float())](Matrix<Pixel>& frame, int) {
+        for (Pixel& pix : frame) for_int(z, nz) pix[z] = transf[pix[z]];
+      });
+    } else if (arg == "-transf") {
+      funcs.push([frame = FrameIO::parse_frame(args.get_string())](Matrix<Pixel>& image, int) {
+        transform_pixels(image.array_view(), frame);
+      });
+    } else if (arg == "-replace") {
+      replace_counts.push(make_unique<std::atomic<int64_t>>(0));
+      std::atomic<int64_t>& count = *replace_counts.last();
+      funcs.push([&count, color = gcolor, negate = g_not, newcolor = parse_replace_color(args)](Matrix<Pixel>& frame,
+                                                                                                 int) {
+        count += replace_pixels(frame.array_view(), color, negate, newcolor);
+      });
+    } else if (arg == "-noisegaussian") {
+      // Each frame has its own deterministic random sequence, so the result is independent of the scheduling.
+      const float sd = args.get_float();
+      const uint32_t seed = Random::G.get_unsigned();
+      funcs.push([sd, seed](Matrix<Pixel>& frame, int f) {
+        Random random(seed + uint32_t(f));
+        add_gaussian_noise(frame.array_view(), sd, random);
+      });
+    } else if (arg == "-fliphorizontal") {
+      funcs.push([](Matrix<Pixel>& frame, int) { for_int(y, frame.ysize()) reverse(frame[y]); });
+    } else if (arg == "-flipvertical") {
+      funcs.push([](Matrix<Pixel>& frame, int) {
+        for_int(y, frame.ysize() / 2) swap_ranges(frame[y], frame[frame.ysize() - 1 - y]);
+      });
+    } else if (arg == "-color") {
+      do_color(args);
+    } else if (arg == "-not") {
+      do_not();
+    } else if (arg == "-boundaryrule") {
+      do_boundaryrule(args);
+    } else if (arg == "-filter") {
+      do_filter(args);
+    } else if (arg == "-to") {
+      do_to(args);
+    } else if (arg == "-bitrate") {
+      do_bitrate(args);
+    } else if (arg == "-framerate") {
+      do_framerate(args);
+    } else if (arg == "-noaudio") {
+      do_noaudio();
+    } else {
+      assertnever("streaming option '" + arg + "' is not handled");
+    }
+  }
+  assertx(product(sdims));
+  WVideo wvideo("-", sdims, video.attrib(), false, WVideo::k_default_queued);
+  const int batch_nframes = max(get_max_threads(), 2);
+  Array<Matrix<Pixel>> frames(batch_nframes);
+  for_int(i, trunc_begin) {
+    if (!rvideo.discard_frame()) break;
+  }
+  const int nfexpect = max(min(rvideo.nframes() - trunc_begin, trunc_frames), 0);
+  assertw(nfexpect > 0);
+  int nf = 0;
+  {
+    ConsoleProgress cprogress("Vstream");
+    for (bool eof = false; !eof && nf < trunc_frames;) {
+      if (nfexpect) cprogress.update(float(nf) / nfexpect);
+      int n = 0;
+      while (n < batch_nframes && nf + n < trunc_frames) {
+        frames[n].init(isdims);
+        if (!rvideo.read_swap(frames[n])) {
+          eof = true;
+          break;
+        }
+        n++;
+      }
+      parallel_for_each(range(n), [&](const int i) {
+        for (const FrameFunc& func : funcs) func(frames[i], nf + i);
+        assertx(frames[i].dims() == sdims);
+      });
+      for_int(i, n) wvideo.write_swap(frames[i]);
+      nf += n;
+    }
+  }
+  assertw(nf > 0);
+  if (nf < trunc_frames && abs(nf - nfexpect) > 1) {
+    SHOW(nf, nfexpect);
+    Warning("Video: read a different number of frames");
+  }
+  for (const auto& count : replace_counts) showf("Replaced %lld pixels\n", static_cast<long long>(*count));
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
   my_setenv("NO_DIAGNOSTICS_IN_STDOUT", "1");
   HH_TIMER("Filtervideo");
+  Array<string> all_args;  // Retained to analyze whether the operations can be applied by streaming frames.
+  for_intL(i, 1, argc) all_args.push(argv[i]);
   ParseArgs args(argc, argv);
   HH_ARGSC("(Video coordinates: (x = 0, y = 0) at (left, top).)");
   HH_ARGSC("A video is read from stdin or first arg except with the following arguments:");
@@ -2330,6 +2520,12 @@ int main(int argc, const char** argv) {
       arg0 != "-fromimages" && arg0 != "-readnv12") {
     string filename = "-";
     if (args.num() && (arg0 == "-" || arg0[0] != '-')) filename = args.get_filename();
+    CArrayView<string> sargs = all_args.slice(all_args.num() - args.num(), all_args.num());
+    if (can_stream(sargs)) {
+      stream_video(filename, sargs);
+      hh_clean_up();
+      return 0;
+    }
     read_video(filename, false);
   }
   args.parse();
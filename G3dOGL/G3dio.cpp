@@ -289,7 +289,13 @@ void ReadFiles(bool during_init) {
       continue;
     }
     RFile is(filename);
-    read_file(HH_POSIX(fileno)(is.cfile()), during_init);
+    if (is.cfile()) {
+      read_file(HH_POSIX(fileno)(is.cfile()), during_init);
+    } else {  // The file is decompressed in-process, but RBuffer requires a file descriptor.
+      TmpFile tmp_file("", is());
+      RFile is2(tmp_file.filename());
+      read_file(HH_POSIX(fileno)(is2.cfile()), during_init);
+    }
     if (anglethresh >= 0.f) RecomputeSharpEdges(*g_obs[robn].get_mesh());
     robn++;
   }
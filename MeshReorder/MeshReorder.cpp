@@ -3,9 +3,14 @@
 #include <cstring>  // strcmp() etc.
 
 #include "libHh/Args.h"
+#include "libHh/BinaryIO.h"  // write_binary_std()
+#include "libHh/Bbox.h"
+#include "libHh/BoundingSphere.h"
 #include "libHh/ConsoleProgress.h"
 #include "libHh/FileIO.h"
 #include "libHh/GMesh.h"
+#include "libHh/MeshOp.h"  // locality_face_order()
+#include "libHh/Parallel.h"
 #include "libHh/Queue.h"
 #include "libHh/Random.h"
 #include "libHh/RangeOp.h"
@@ -82,6 +87,9 @@ bool old_strip_order = false;     // obsolete old way of indexing strips
 bool reorder_vertices = false;    // reorder vertices according to first use
 bool duplicate_vertices = false;  // strict linear read order
 bool nooutput = false;            // if 1, do no write out final reordered mesh
+float overdraw_lambda = 1.05f;    // ACMR tolerance when splitting the face order into overdraw clusters
+int meshlet_max_verts = 64;       // maximum number of vertices in a meshlet
+int meshlet_max_faces = 124;      // maximum number of faces in a meshlet
 int verb = 1;                     // verbosity level of output
 
 // Override the variable k used in lookahead simulation.
@@ -94,6 +102,13 @@ Array<int> ar_verts;   // [3*mesh.num_faces()] -> 1..num_vertices()
 Array<Face> ar_faces;  // [mesh.num_faces()] -> original Face
 string gfilename;
 
+// Set by "-meshlets": number of consecutive faces in each meshlet of the final face order.
+Array<int> ar_meshlet_nfaces;
+string meshlets_filename;
+
+// CPU time of the most recent reordering algorithm (reported by do_analyze()), or -1 if none.
+double last_reorder_cpu = -1.;
+
 // This data is only used by "-diff_corners" to compare cache misses
 //  before and after reordering.
 HH_SAC_ALLOCATE_FUNC(Mesh::MFace, int, f_oldfid);
@@ -107,6 +122,7 @@ inline bool same_string(const char* s1, const char* s2) {
 void show_rate(Timer& timer) {
   timer.stop();
   double runtime = timer.cpu();
+  last_reorder_cpu = runtime;
   showdf("reordering rate: %.0f faces / sec\n", mesh.num_faces() / max(runtime, 1e-6));
   timer.start();
 }
@@ -467,6 +483,9 @@ void do_analyze() {
   showdf("%-14.14s v/t=%5.3f v/v=%5.3f slen=%4.1f bv=%4.2f bi=%4.2f bt=%4.2f\n",  //
          nametail.c_str(), float(nmiss) / mesh.num_faces(), float(nmiss) / mesh.num_vertices(),
          float(mesh.num_faces()) / nstrips, b_v, b_i, b_t);
+  if (last_reorder_cpu >= 0.)
+    showdf("%-14.14s acmr=%5.3f reorder_time=%.3f s\n", nametail.c_str(), float(nmiss) / mesh.num_faces(),
+           last_reorder_cpu);
 }
 
 // Analyze the badnwidth of the mesh under the traditional triangle strip
@@ -613,6 +632,345 @@ void do_randomize_faces() {
   }
 }
 
+// Reorder the faces along a space-filling curve for CPU memory locality (rather than for the GPU vertex cache),
+//  and renumber the vertices according to first use.
+void do_locality() {
+  Timer timer("_locality");
+  ar_verts.init(0);
+  ar_faces.init(0);
+  for (Face f : locality_face_order(mesh)) {
+    for (Vertex v : mesh.vertices(f)) ar_verts.push(mesh.vertex_id(v));
+    ar_faces.push(f);
+  }
+  reorder_vertices = true;
+  show_rate(timer);
+}
+
+// Linear-time greedy face reordering (Forsyth 2006), operating directly on the index array ar_verts.
+// At each step, emit the unprocessed face with the highest score among those adjacent to cached vertices;
+//  a vertex score favors recent LRU cache positions and vertices with few remaining faces.
+void do_forsyth() {
+  const int nf = mesh.num_faces(), nv1 = mesh.num_vertices() + 1;
+  const int cs = cache_size;
+  assertx(cs > 3);
+  Timer timer("_forsyth");
+  // Compact vertex -> faces adjacency; vf_num[vi] counts the faces of vertex vi not yet emitted.
+  Array<int> vf_start(nv1 + 1, 0);
+  for (int vi : ar_verts) vf_start[vi + 1]++;
+  for_int(vi, nv1) vf_start[vi + 1] += vf_start[vi];
+  Array<int> vf_num(nv1, 0), vf_faces(3 * nf);
+  for_int(fi, nf) for_int(j, 3) {
+    const int vi = ar_verts[fi * 3 + j];
+    vf_faces[vf_start[vi] + vf_num[vi]++] = fi;
+  }
+  Array<int> cache_pos(nv1, -1);  // -1 if not in cache
+  const auto vertex_score = [&](int vi) {
+    const int nfaces = vf_num[vi];
+    if (!nfaces) return -1.f;
+    const int pos = cache_pos[vi];
+    float score = 0.f;
+    if (pos >= 0) score = pos < 3 ? .75f : std::pow(1.f - float(pos - 3) / float(cs - 3), 1.5f);
+    return score + 2.f / std::sqrt(float(nfaces));
+  };
+  Array<float> vscore(nv1);
+  for_int(vi, nv1) vscore[vi] = vertex_score(vi);
+  const auto face_score = [&](int fi) {
+    return vscore[ar_verts[fi * 3 + 0]] + vscore[ar_verts[fi * 3 + 1]] + vscore[ar_verts[fi * 3 + 2]];
+  };
+  Array<bool> emitted(nf, false);
+  Array<int> cache, ncache;  // cache vertices, most recent first
+  cache.reserve(cs + 3);
+  ncache.reserve(cs + 3);
+  Array<int> new_verts;
+  new_verts.reserve(3 * nf);
+  Array<Face> new_faces;
+  new_faces.reserve(nf);
+  int next_unemitted = 0;  // Cursor for restarts, so that restarts cost O(nf) overall.
+  int fbest = -1;
+  float best_score = -1.f;
+  for_int(fi, nf) {
+    const float score = face_score(fi);
+    if (score > best_score) best_score = score, fbest = fi;
+  }
+  while (fbest >= 0) {
+    emitted[fbest] = true;
+    new_faces.push(ar_faces[fbest]);
+    for_int(j, 3) {
+      const int vi = ar_verts[fbest * 3 + j];
+      new_verts.push(vi);
+      // Remove fbest from the active faces of vi.
+      int* pf = &vf_faces[vf_start[vi]];
+      int k = 0;
+      while (pf[k] != fbest) k++;
+      std::swap(pf[k], pf[--vf_num[vi]]);
+    }
+    ncache.init(0);
+    for_int(j, 3) ncache.push(ar_verts[fbest * 3 + j]);
+    for (int vi : cache)
+      if (vi != ncache[0] && vi != ncache[1] && vi != ncache[2]) ncache.push(vi);
+    for_int(i, ncache.num()) cache_pos[ncache[i]] = i < cs ? i : -1;
+    if (ncache.num() > cs) ncache.init(cs);
+    std::swap(cache, ncache);
+    // Update scores of vertices whose cache position changed (the evicted ones are still listed in ncache).
+    for (int vi : ncache) vscore[vi] = vertex_score(vi);
+    for (int vi : cache) vscore[vi] = vertex_score(vi);
+    fbest = -1;
+    best_score = -1.f;
+    for (int vi : cache) {
+      for_int(k, vf_num[vi]) {
+        const int fi = vf_faces[vf_start[vi] + k];
+        const float score = face_score(fi);
+        if (score > best_score) best_score = score, fbest = fi;
+      }
+    }
+    if (fbest < 0) {  // Dead end: restart at the next unemitted face in the input order.
+      while (next_unemitted < nf && emitted[next_unemitted]) next_unemitted++;
+      if (next_unemitted < nf) fbest = next_unemitted;
+    }
+  }
+  assertx(new_faces.num() == nf);
+  ar_verts = std::move(new_verts);
+  ar_faces = std::move(new_faces);
+  show_rate(timer);
+}
+
+// Split the current face order into clusters at cache restarts (as long as the per-cluster ACMR stays within
+//  overdraw_lambda of the overall ACMR), and sort these clusters so that those facing away from the mesh center
+//  are drawn first, which reduces overdraw (Sander et al. 2007).
+void do_overdraw() {
+  const int nf = mesh.num_faces();
+  Timer timer("_overdraw");
+  auto up_vcache = VertexCache::make(cache_type, 1 + mesh.num_vertices(), cache_size);
+  VertexCache& vcache = *up_vcache;
+  Array<int> fmiss(nf);
+  int nmiss = 0;
+  for_int(fi, nf) {
+    fmiss[fi] = 0;
+    for_int(j, 3) fmiss[fi] += !vcache.access_hits(ar_verts[fi * 3 + j]);
+    nmiss += fmiss[fi];
+  }
+  const float max_acmr = overdraw_lambda * float(nmiss) / max(nf, 1);
+  Array<int> cluster_start;
+  int cluster_nmiss = 0;
+  for_int(fi, nf) {
+    const int cluster_nf = fi - (cluster_start.num() ? cluster_start.last() : 0);
+    if (!fi || (fmiss[fi] == 3 && float(cluster_nmiss) / cluster_nf <= max_acmr)) {
+      cluster_start.push(fi);
+      cluster_nmiss = 0;
+    }
+    cluster_nmiss += fmiss[fi];
+  }
+  cluster_start.push(nf);
+  Point mesh_centroid{};
+  for (Vertex v : mesh.vertices()) mesh_centroid += mesh.point(v);
+  mesh_centroid /= float(max(mesh.num_vertices(), 1));
+  struct S {
+    int fi_beg, fi_end;
+    float sort_key;
+  };
+  Array<S> clusters;
+  for_int(ci, cluster_start.num() - 1) {
+    const int fi_beg = cluster_start[ci], fi_end = cluster_start[ci + 1];
+    Point centroid{};
+    Vector normal{};
+    for (int fi = fi_beg; fi < fi_end; fi++) {
+      const Vec3<Point> triangle =
+          map(V(0, 1, 2), [&](int j) { return mesh.point(mesh.id_vertex(ar_verts[fi * 3 + j])); });
+      centroid += mean(triangle);
+      normal += get_normal_dir(triangle);  // Area-weighted.
+    }
+    centroid /= float(fi_end - fi_beg);
+    clusters.push(S{fi_beg, fi_end, dot(centroid - mesh_centroid, normal)});
+  }
+  const auto by_decreasing_key = [](const S& s1, const S& s2) { return s1.sort_key > s2.sort_key; };
+  std::stable_sort(clusters.begin(), clusters.end(), by_decreasing_key);
+  Array<int> new_verts;
+  new_verts.reserve(3 * nf);
+  Array<Face> new_faces;
+  new_faces.reserve(nf);
+  for (const S& cluster : clusters) {
+    for (int fi = cluster.fi_beg; fi < cluster.fi_end; fi++) {
+      for_int(j, 3) new_verts.push(ar_verts[fi * 3 + j]);
+      new_faces.push(ar_faces[fi]);
+    }
+  }
+  ar_verts = std::move(new_verts);
+  ar_faces = std::move(new_faces);
+  showdf("overdraw: %d clusters\n", clusters.num());
+  show_rate(timer);
+}
+
+// *** Meshlets
+
+// Partition the faces of one face-connected component into meshlets, appending the faces to forder and the
+//  meshlet sizes to meshlet_nfaces.  Each meshlet grows greedily by the adjacent face having the most vertices
+//  already in the meshlet (as in face_nvcached()), within the meshlet_max_verts and meshlet_max_faces bounds.
+void build_component_meshlets(CArrayView<Face> faces, CArrayView<int> fcomp, ArrayView<bool> fprocessed,
+                              Array<Face>& forder, Array<int>& meshlet_nfaces) {
+  const int comp = fcomp[mesh.face_id(faces[0])];
+  Array<Vertex> mverts;      // vertices in current meshlet
+  Array<Face> candidates;    // unprocessed faces adjacent to current meshlet
+  int nfaces = 0;            // number of faces in current meshlet
+  int next_seed = 0;         // cursor into faces
+  const auto close_meshlet = [&] {
+    if (!nfaces) return;
+    meshlet_nfaces.push(nfaces);
+    nfaces = 0;
+    mverts.init(0);
+    candidates.init(0);
+  };
+  for (;;) {
+    Face fbest = nullptr;
+    int best_nshared = -1;
+    int ncandidates = 0;
+    for (Face f : candidates) {
+      if (fprocessed[mesh.face_id(f)]) continue;
+      candidates[ncandidates++] = f;
+      int nshared = 0;
+      for (Vertex v : mesh.vertices(f)) nshared += mverts.contains(v);
+      if (mverts.num() + (3 - nshared) > meshlet_max_verts) continue;
+      if (nshared > best_nshared) best_nshared = nshared, fbest = f;
+    }
+    candidates.resize(ncandidates);
+    if (!fbest) {
+      close_meshlet();
+      while (next_seed < faces.num() && fprocessed[mesh.face_id(faces[next_seed])]) next_seed++;
+      if (next_seed == faces.num()) break;
+      fbest = faces[next_seed];
+    }
+    fprocessed[mesh.face_id(fbest)] = true;
+    forder.push(fbest);
+    nfaces++;
+    for (Vertex v : mesh.vertices(fbest)) {
+      if (mverts.contains(v)) continue;
+      mverts.push(v);
+      for (Face f : mesh.faces(v))
+        if (!fprocessed[mesh.face_id(f)] && fcomp[mesh.face_id(f)] == comp) candidates.push(f);
+    }
+    if (nfaces == meshlet_max_faces) close_meshlet();
+  }
+}
+
+// Reorder the faces into meshlets (bounded clusters of vertices and faces), processing the face-connected
+//  components in parallel.  The meshlet table is written to the given file after the final mesh is assembled,
+//  so this should be the last reordering option.
+void do_meshlets(Args& args) {
+  meshlets_filename = args.get_filename();
+  assertx(meshlet_max_verts >= 3 && meshlet_max_verts <= 256 && meshlet_max_faces >= 1);
+  Timer timer("_meshlets");
+  const int nf = mesh.num_faces();
+  Array<int> fcomp(nf + 1, -1);  // face id -> component index
+  Array<Array<Face>> components;
+  for_int(fi, nf) {
+    Face f = mesh.id_face(1 + fi);
+    if (fcomp[mesh.face_id(f)] >= 0) continue;
+    const int comp = components.add(1);
+    Array<Face>& cfaces = components[comp];
+    Queue<Face> queue;
+    fcomp[mesh.face_id(f)] = comp;
+    for (;;) {
+      cfaces.push(f);
+      for (Face f2 : mesh.faces(f)) {
+        if (fcomp[mesh.face_id(f2)] >= 0) continue;
+        fcomp[mesh.face_id(f2)] = comp;
+        queue.enqueue(f2);
+      }
+      if (queue.empty()) break;
+      f = queue.dequeue();
+    }
+  }
+  Array<bool> fprocessed(nf + 1, false);  // Each component only accesses its own faces.
+  Array<Array<Face>> comp_forder(components.num());
+  Array<Array<int>> comp_meshlet_nfaces(components.num());
+  parallel_for_each(range(components.num()), [&](const int comp) {
+    build_component_meshlets(components[comp], fcomp, fprocessed, comp_forder[comp], comp_meshlet_nfaces[comp]);
+  });
+  ar_verts.init(0);
+  ar_faces.init(0);
+  ar_meshlet_nfaces.init(0);
+  for_int(comp, components.num()) {
+    for (Face f : comp_forder[comp]) {
+      for (Vertex v : mesh.vertices(f)) ar_verts.push(mesh.vertex_id(v));
+      ar_faces.push(f);
+    }
+    ar_meshlet_nfaces.push_array(comp_meshlet_nfaces[comp]);
+  }
+  assertx(ar_faces.num() == nf);
+  showdf("meshlets: %d components, %d meshlets, %.1f faces/meshlet\n", components.num(), ar_meshlet_nfaces.num(),
+         float(nf) / ar_meshlet_nfaces.num());
+  show_rate(timer);
+}
+
+// Write the meshlet table of the final mesh (whose face ids follow the meshlet order) in a binary sidecar file.
+// Format: a text line "Meshlets nmeshlets=%d nvertices=%d ntriangles=%d", followed by (in Big Endian order):
+//  for each meshlet: int vertex_offset, vertex_count, triangle_offset, triangle_count;
+//                    float bsphere_x, bsphere_y, bsphere_z, bsphere_radius, cone_x, cone_y, cone_z, cone_cos;
+//  int[nvertices] vertex indices (0-based mesh vertex ids) referenced by the meshlets;
+//  uchar[3 * ntriangles] triangle corners as indices into the vertices of their meshlet.
+// The normal cone (unit axis and cosine of half-angle) bounds all face normals.  cone_cos is -1 if the meshlet
+// cannot be backface-culled: either it has no nondegenerate face or its cone has a half-angle of at least 90 degrees.
+void write_meshlets() {
+  HH_TIMER("_write_meshlets");
+  const int nmeshlets = ar_meshlet_nfaces.num();
+  Array<int> face_offset(nmeshlets + 1, 0);
+  for_int(i, nmeshlets) face_offset[i + 1] = face_offset[i] + ar_meshlet_nfaces[i];
+  assertx(face_offset.last() == mesh.num_faces());
+  Array<Array<int>> mverts(nmeshlets);
+  Array<Array<uchar>> mtris(nmeshlets);
+  Array<Vec<float, 8>> mbounds(nmeshlets);
+  parallel_for_each(range(nmeshlets), [&](const int i) {
+    Array<Vertex> va;
+    Array<Vector> fnormals;
+    for (int fi = face_offset[i]; fi < face_offset[i + 1]; fi++) {
+      Face f = mesh.id_face(1 + fi);
+      for (Vertex v : mesh.vertices(f)) {
+        int j = va.index(v);
+        if (j < 0) j = va.num(), va.push(v);
+        mtris[i].push(narrow_cast<uchar>(j));
+      }
+      Vector fnormal = get_normal_dir(mesh.triangle_points(f));
+      if (fnormal.normalize()) fnormals.push(fnormal);
+    }
+    mverts[i] = map(va, [&](Vertex v) { return mesh.vertex_id(v) - 1; });
+    // As in SrMesh::compute_bspheres(), let the sphere center be the center of the bounding box.
+    const auto bounding_sphere = [](const auto& points) {
+      const Bbox<float, 3> bbox{points};
+      BoundingSphere bsphere{interp(bbox[0], bbox[1]), 0.f};
+      for (const auto& p : points) bsphere.radius = max(bsphere.radius, dist(Point(p), bsphere.point));
+      return bsphere;
+    };
+    const BoundingSphere bsphere = bounding_sphere(map(va, [&](Vertex v) { return mesh.point(v); }));
+    float cone_cos = -1.f;
+    Vector cone_axis(0.f, 0.f, 0.f);
+    if (fnormals.num()) {
+      const BoundingSphere nsphere = bounding_sphere(fnormals);
+      const float alpha = normal_cone_half_angle(nsphere);
+      cone_axis = nsphere.point;
+      if (cone_axis.normalize() && alpha < TAU / 4) cone_cos = std::cos(alpha);
+    }
+    mbounds[i] = V(bsphere.point[0], bsphere.point[1], bsphere.point[2], bsphere.radius,  //
+                   cone_axis[0], cone_axis[1], cone_axis[2], cone_cos);
+  });
+  int nvertices = 0, ntriangles = 0;
+  for_int(i, nmeshlets) nvertices += mverts[i].num(), ntriangles += mtris[i].num() / 3;
+  WFile fi(meshlets_filename);
+  std::ostream& os = fi();
+  os << sform("Meshlets nmeshlets=%d nvertices=%d ntriangles=%d\n", nmeshlets, nvertices, ntriangles);
+  int vertex_offset = 0, triangle_offset = 0;
+  for_int(i, nmeshlets) {
+    const int vertex_count = mverts[i].num(), triangle_count = mtris[i].num() / 3;
+    write_binary_std(os, V(vertex_offset, vertex_count, triangle_offset, triangle_count).view());
+    write_binary_std(os, mbounds[i].view());
+    vertex_offset += vertex_count;
+    triangle_offset += triangle_count;
+  }
+  for_int(i, nmeshlets) write_binary_std(os, mverts[i]);
+  for_int(i, nmeshlets) write_binary_raw(os, mtris[i]);
+  assertx(os);
+  showdf("Wrote %d meshlets (%.1f verts, %.1f faces each) to %s\n", nmeshlets, float(nvertices) / max(nmeshlets, 1),
+         float(ntriangles) / max(nmeshlets, 1), meshlets_filename.c_str());
+}
+
 // *** MeshStatus
 
 const int random_initial_face = getenv_int("RANDOM_INITIAL_FACE");
@@ -1534,6 +1892,13 @@ int main(int argc, const char** argv) {
   HH_ARGSD(meshify8, ": fast heuristic per ring");
   HH_ARGSD(meshify9, ": like 8, queue of restarts");
   HH_ARGSD(meshify10, ": like 9, go clockwise after restart (simpler, faster, and even better)");
+  HH_ARGSD(locality, ": space-filling curve order for CPU memory locality");
+  HH_ARGSD(forsyth, ": linear-time greedy LRU scoring (fast)");
+  HH_ARGSP(overdraw_lambda, "f : ACMR tolerance for overdraw clusters");
+  HH_ARGSD(overdraw, ": sort clusters of current order to reduce overdraw");
+  HH_ARGSP(meshlet_max_verts, "n : maximum number of vertices per meshlet");
+  HH_ARGSP(meshlet_max_faces, "n : maximum number of faces per meshlet");
+  HH_ARGSD(meshlets, "file.meshlets : partition into meshlets, write table (last reordering)");
   HH_ARGSD(timingtest, "niter : run timing test");
   {
     string arg0 = args.num() ? args.peek_string() : "";
@@ -1557,9 +1922,8 @@ int main(int argc, const char** argv) {
     args.parse();
   }
   hh_clean_up();
-  if (!nooutput) {
-    replace_mesh();
-    mesh.write(std::cout);
-  }
+  if (!nooutput || meshlets_filename != "") replace_mesh();
+  if (meshlets_filename != "") write_meshlets();
+  if (!nooutput) mesh.write(std::cout);
   return 0;
 }
@@ -286,6 +286,13 @@ HH_SAC_ALLOCATE_FUNC(Mesh::MVertex, Point, v_sph);  // Spherical parameterizatio
 
 HH_SAC_ALLOCATE_FUNC(Mesh::MEdge, int, e_index);  // Index into sorted array.
 
+// The queue position must be zero-initialized, hence a constructed Sac field.
+struct struct_e_pqindex {
+  int i{0};  // Position in pqecost (plus one), or 0.
+};
+HH_SACABLE(struct_e_pqindex);
+HH_SAC_ALLOCATE_CD_FUNC(Mesh::MEdge, struct_e_pqindex, func_e_pqindex);
+
 // Information relating to the mesh neighborhood following a speculative edge collapse.
 // Note that this information is independent of orientation of edge (v1, v2).
 struct NewMeshNei : noncopyable {
@@ -320,8 +327,12 @@ struct Param {
 
 constexpr float k_bad_dih = 1e28f;
 
-class LHPqueue : public HPqueue<Edge> {
-  using base = HPqueue<Edge>;
+struct EdgePqIndex {
+  int& operator()(Edge e) const { return func_e_pqindex(e).i; }
+};
+
+class LHPqueue : public IPqueue<Edge, EdgePqIndex> {
+  using base = IPqueue<Edge, EdgePqIndex>;
 
  public:
   void clear() {
@@ -1024,7 +1035,7 @@ void write_mesh(std::ostream& os) {
 }
 
 // Parse wedge attributes at corner c, using computed normals in vnors if corner doesn't have an explicit normal.
-WedgeInfo construct_wi(Corner c, const Vnors& vnors) {
+WedgeInfo construct_wi(Corner c, const Vnors& vnors, GMeshChannel& rgb_channel, GMeshChannel& uv_channel) {
   WedgeInfo wi;
   Vector& nor = wi.nor;
   nor = vnors.get_nor(mesh.corner_face(c));
@@ -1043,10 +1054,10 @@ WedgeInfo construct_wi(Corner c, const Vnors& vnors) {
   if (0 && rnor001) nor = Vector(0.f, 0.f, 1.f);
   A3dColor& col = wi.col;
   fill(col, k_undefined);
-  mesh.parse_corner_key_vec(c, "rgb", col);
+  rgb_channel.get(c, col);
   Uv& uv = wi.uv;
   fill(uv, k_undefined);
-  mesh.parse_corner_key_vec(c, "uv", uv);
+  uv_channel.get(c, uv);
   return wi;
 }
 
@@ -1124,6 +1135,9 @@ void parse_mesh_wedge_identifiers() {
   assertx(!nwidfound || nwidfound == mesh.num_faces() * 3);
   // Initial gwinfo based on wid; more entries are added later if !nwidfound and vertices have multiple wedges.
   gwinfo.init(1 + (nwidfound ? maxwidfound : max_vid));  // Skip gwinfo[0] (wid start at 1).
+  // Each corner is visited several times by construct_wi(), so its attribute strings are parsed just once here.
+  GMeshChannel& rgb_channel = mesh.corner_channel("rgb", 3);
+  GMeshChannel& uv_channel = mesh.corner_channel("uv", 2);
   std::mutex mutex;
   Array<int> chunk_nccolors(num_threads, 0);
   parallel_for_chunk(ar_vertices, num_threads, [&](const int thread_index, auto subrange) {
@@ -1151,7 +1165,7 @@ void parse_mesh_wedge_identifiers() {
       Set<Corner> setcvis;
       for (Corner crep : mesh.corners(v)) {
         if (!setcvis.add(crep)) continue;
-        const WedgeInfo wi = construct_wi(crep, vnors);
+        const WedgeInfo wi = construct_wi(crep, vnors, rgb_channel, uv_channel);
         int wid;
         if (nwidfound) {
           // Array gwinfo is never resized, so locking is unnecessary.
@@ -1173,7 +1187,7 @@ void parse_mesh_wedge_identifiers() {
           for (;;) {
             c = dir ? mesh.clw_corner(c) : mesh.ccw_corner(c);
             if (!c || c == crep) break;
-            WedgeInfo wi2 = construct_wi(c, vnors);
+            WedgeInfo wi2 = construct_wi(c, vnors, rgb_channel, uv_channel);
             bool diff = ((wedge_materials && f_matid(mesh.corner_face(c)) != matid) || compare_wi(wi, wi2) != 0);
             if (nwidfound && sdebug) {
               int wid2 = assertx(to_int(mesh.corner_key(str, c, "wid")));
@@ -1199,6 +1213,7 @@ void parse_mesh_wedge_identifiers() {
         if (c_winfo(c).col[0] != k_undefined) nccolors++;
     }
   });
+  mesh.clear_channels();  // Avoid their maintenance during simplification.
   const int nccolors = sum<int>(chunk_nccolors);
   if (nccolors) {
     have_ccolors = true;
@@ -4690,26 +4705,32 @@ void optimize() {
     }
     // Enter replacement edges.
     Set<Edge> seterecompute;
+    Array<Edge> arerecompute;  // The same edges, in a deterministic order independent of their addresses.
     if (!invertexorder) {
       for (Edge ee : mesh.edges(vs)) {
         pqecost.enter(ee, k_bad_cost);
         seterecompute.enter(ee);
+        arerecompute.push(ee);
       }
       assertx(affectpq >= 2);  // affectpq == 1 no longer supported.
       for (Face f : mesh.faces(vs)) {
         Edge ee = mesh.opp_edge(vs, f);
         float cost1 = pqecost.retrieve(ee);
-        if ((affectpq >= 1 && cost1 == k_bad_cost) || affectpq >= 3) assertx(seterecompute.add(ee));
+        if ((affectpq >= 1 && cost1 == k_bad_cost) || affectpq >= 3) {
+          assertx(seterecompute.add(ee));
+          arerecompute.push(ee);
+        }
       }
       for (Vertex v : mesh.vertices(vs)) {
         for (Edge ee : mesh.edges(v)) {
           float cost1 = pqecost.retrieve(ee);
-          if ((affectpq >= 1 && cost1 == k_bad_cost) || affectpq >= 3) seterecompute.add(ee);
+          if (((affectpq >= 1 && cost1 == k_bad_cost) || affectpq >= 3) && seterecompute.add(ee))
+            arerecompute.push(ee);
         }
       }
     }
-    SSTATV2(Serecompute, seterecompute.num());
-    for (Edge ee : seterecompute) {
+    SSTATV2(Serecompute, arerecompute.num());
+    for (Edge ee : arerecompute) {
       const EcolResult ecol_result = try_ecol(ee, false);
       pqecost.update(ee, ecol_result.cost);
       neval++;
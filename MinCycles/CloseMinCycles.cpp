@@ -61,43 +61,51 @@ constexpr bool k_touch_approx = true;
 
 const Point k_boundary_point_far_away = thrice(1e10f);  // to topologically fill mesh boundaries
 
-// Remember to initialize these sacs, including in cycle closing operations.
-HH_SAC_ALLOCATE_FUNC(Mesh::MVertex, float,
-                     v_dist);  // distance from seed vertex during BFS, or BIGFLOAT if not reached
-HH_SAC_ALLOCATE_FUNC(Mesh::MVertex, Vertex, v_vprev);  // previous vertex during BFS
-// HH_SAC_ALLOCATE_FUNC(Mesh::MVertex, Vertex, v_vtouch);  // previous jump-across vertex during BFS;
-//  implementation as map_vtouch is equally efficient because it is accessed infrequently.
-
-HH_SAC_ALLOCATE_FUNC(Mesh::MEdge, int, e_bfsnum);  // for secondary BFS search
-// HH_SAC_ALLOCATE_FUNC(Mesh::MEdge, bool, e_joined);  // records whether Vertex-Voronoi-regions are joined;
-//  implementation as flags(e).flag(eflag_joined) is equally efficient.
-
-const FlagMask eflag_joined = Mesh::allocate_Edge_flag();  // records whether Vertex-Voronoi-regions are joined
+// Remember to initialize this sac, including in cycle closing operations.
+HH_SAC_ALLOCATE_FUNC(Mesh::MEdge, int, e_index);  // index of edge into the state of each search
 
 bool difference_is_within_relative_eps(float a, float b, float eps) { return abs(a - b) / (max(a, b) + 1e-10f) < eps; }
 
 }  // namespace
 
-inline Flag CloseMinCycles::e_joined(Edge e) { return _mesh.flags(e).flag(eflag_joined); }
-
-// Re-initialize v_dist() and e_joined() on the region that was just searched.
-void CloseMinCycles::flood_reinitialize(Vertex vseed) {
-  v_dist(vseed) = BIGFLOAT;
-  Queue<Vertex> queue;
-  queue.enqueue(vseed);
-  while (!queue.empty()) {
-    Vertex vc = queue.dequeue();
-    ASSERTX(v_dist(vc) == BIGFLOAT);
-    for (Edge e : _mesh.edges(vc)) {
-      e_joined(e) = false;
-      Vertex vn = _mesh.opp_vertex(vc, e);
-      if (v_dist(vn) != BIGFLOAT) {
-        v_dist(vn) = BIGFLOAT;
-        queue.enqueue(vn);
-      }
-    }
+// The state of a search from a seed vertex.  Rather than residing in mesh sacs and flags, it is kept in arrays indexed
+// by vertex id and by e_index(), and it is reset using the lists of touched entries rather than a flood fill.
+struct CloseMinCycles::Search {
+  const GMesh* mesh;
+  Array<float> dist;      // distance from seed vertex during BFS, or BIGFLOAT if not reached
+  Array<Vertex> vprev;    // previous vertex during BFS
+  Array<bool> joined;     // records whether Vertex-Voronoi-regions are joined
+  Array<int> bfsnum;      // for secondary BFS search
+  Array<Vertex> visited;  // vertices whose dist is set
+  Array<int> ejoined;     // indices of the edges whose joined may be set
+  float v_dist(Vertex v) const { return dist[mesh->vertex_id(v)]; }
+  void set_v_dist(Vertex v, float d) {
+    float& vd = dist[mesh->vertex_id(v)];
+    if (vd == BIGFLOAT) visited.push(v);
+    vd = d;
   }
-}
+  Vertex& v_vprev(Vertex v) { return vprev[mesh->vertex_id(v)]; }
+  bool e_joined(Edge e) const { return joined[e_index(e)]; }
+  void set_e_joined(Edge e, bool b) {
+    if (b) ejoined.push(e_index(e));
+    joined[e_index(e)] = b;
+  }
+  int& e_bfsnum(Edge e) { return bfsnum[e_index(e)]; }
+  // Grow the arrays to accommodate new vertices and edges, in their initial state.
+  void resize(int num_vertex_ids, int num_edge_indices) {
+    for (int i = dist.num(); i < num_vertex_ids; i++) dist.push(BIGFLOAT);
+    vprev.resize(num_vertex_ids);
+    for (int i = joined.num(); i < num_edge_indices; i++) joined.push(false);
+    for (int i = bfsnum.num(); i < num_edge_indices; i++) bfsnum.push(0);
+  }
+  // Re-initialize v_dist() and e_joined() on the region that was just searched.
+  void reinitialize() {
+    for (Vertex v : visited) dist[mesh->vertex_id(v)] = BIGFLOAT;
+    for (const int ei : ejoined) joined[ei] = false;
+    visited.init(0);
+    ejoined.init(0);
+  }
+};
 
 // Given a cycle of edges described by a loop of vertices vao, close the associated topological handle by
 //   (1) duplicating each vertex along the cycle, and
@@ -125,9 +133,9 @@ Array<Vertex> CloseMinCycles::close_cycle(const CArrayView<Vertex> vao) {
     _mesh.set_point(vn, p);
     _mesh.set_string(vn, _mesh.get_string(vo));
     // Note that all corner (and their strings) are preserved in split_vertex().
-    v_dist(vn) = 0.f;  // any value != BIGFLOAT
     // Note: Vertex vn is not entered into pqvlbsr, because its corresponding old vertex is already there.
-    for (Edge e : _mesh.edges(vn)) e_bfsnum(e) = 0;  // e_joined(e) will be initialized shortly
+    _num_vertex_ids = max(_num_vertex_ids, _mesh.vertex_id(vn) + 1);
+    for (Edge e : _mesh.edges(vn)) e_index(e) = _num_edge_indices++;  // all edges on vn are new
     // On corners and faces, all sacs, strings, and flags are preserved.
   }
   // Next, fill the two boundaries with create_face() and center_split().
@@ -142,7 +150,7 @@ Array<Vertex> CloseMinCycles::close_cycle(const CArrayView<Vertex> vao) {
       _mesh.set_string(c, _mesh.get_string(c2));
     }
     Vertex vn = _mesh.center_split_face(fn);
-    v_dist(vn) = 0.f;  // any value != BIGFLOAT
+    _num_vertex_ids = max(_num_vertex_ids, _mesh.vertex_id(vn) + 1);
     if (_mark_edges_sharp) {
       // For all edges in the two cycles after the closure, label them with the "sharp" attribute.
       for (Face f : _mesh.faces(vn)) {
@@ -156,10 +164,9 @@ Array<Vertex> CloseMinCycles::close_cycle(const CArrayView<Vertex> vao) {
       // Label the two vertices at the centers of the face fans.
       _mesh.update_string(vn, "filledcenter", "");
     }
-    // Clean-up / initialize the edge data.
-    for (Face f : _mesh.faces(vn))
-      for (Edge e : _mesh.edges(f)) e_bfsnum(e) = 0;      // e_joined(e) will be initialized shortly
-    for (Vertex v : _mesh.vertices(vn)) v_dist(v) = 0.f;  // any value != BIGFLOAT
+    // Initialize the edge data.
+    for (Edge e : _mesh.edges(vn)) e_index(e) = _num_edge_indices++;
+    for (Face f : _mesh.faces(vn)) e_index(_mesh.opp_edge(vn, f)) = _num_edge_indices++;
     if (1) {  // heuristically characterize as handle/tunnel based on geometric embedding
       for (Face f : _mesh.faces(vn)) {
         Edge e = _mesh.opp_edge(vn, f);                    // Face f2 = _mesh.opp_face(f, e);
@@ -183,11 +190,11 @@ Array<Vertex> CloseMinCycles::close_cycle(const CArrayView<Vertex> vao) {
 }
 
 // Given Edge e adjacent to two already BFS-visited vertices, determine if connecting them would form a nonseparating cycle.
-bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
+bool CloseMinCycles::would_be_nonseparating_cycle(Search& search, Edge e12, bool exact) const {
   HH_STIMER("__would_be_nonseparating_cycle");
-  assertx(v_dist(_mesh.vertex1(e12)) != BIGFLOAT && v_dist(_mesh.vertex2(e12)) != BIGFLOAT);
-  assertx(!e_joined(e12));
-  e_joined(e12) = true;  // must be undone before function return if the cycle is non-separating
+  assertx(search.v_dist(_mesh.vertex1(e12)) != BIGFLOAT && search.v_dist(_mesh.vertex2(e12)) != BIGFLOAT);
+  assertx(!search.e_joined(e12));
+  search.set_e_joined(e12, true);  // must be undone before function return if the cycle is non-separating
   // If resulting components of !e_joined edges starting from
   //  left and right sides of e12 is connected, then we have a non-separating cycle.
   // To quickly detect small dead-ends, perform two simultaneous BFS.
@@ -213,15 +220,15 @@ bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
           for (Corner c : {_mesh.clw_corner(cc), _mesh.clw_corner(_mesh.ccw_face_corner(cc))}) {
             Edge e = _mesh.clw_face_edge(c);
             if (1) {  // about 3X faster
-              if (e_joined(e)) {
-                ASSERTX(e_bfsnum(e) != bfsnum + 0 && e_bfsnum(e) != bfsnum + 1);
+              if (search.e_joined(e)) {
+                ASSERTX(search.e_bfsnum(e) != bfsnum + 0 && search.e_bfsnum(e) != bfsnum + 1);
                 continue;
               }
-              if (e_bfsnum(e) == bfsnum + i) continue;
-              if (e_bfsnum(e) == bfsnum + (1 - i)) return true;  // from lambda
-              e_bfsnum(e) = bfsnum + i;
+              if (search.e_bfsnum(e) == bfsnum + i) continue;
+              if (search.e_bfsnum(e) == bfsnum + (1 - i)) return true;  // from lambda
+              search.e_bfsnum(e) = bfsnum + i;
             } else {
-              if (e_joined(e)) {
+              if (search.e_joined(e)) {
                 ASSERTX(!sets[0].contains(e) && !sets[1].contains(e));
                 continue;
               }
@@ -237,12 +244,12 @@ bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
     if (0) {
       Vertex v1 = _mesh.vertex1(e12), v2 = _mesh.vertex2(e12);
       showdf("would_be_nonseparating_cycle v_dist(%d)=%g v_dist(%d)=%g e12=%g exact=%d connected=%d count=%d\n",
-             _mesh.vertex_id(v1), v_dist(v1), _mesh.vertex_id(v2), v_dist(v2), _mesh.length(e12), exact, connected,
-             count);
+             _mesh.vertex_id(v1), search.v_dist(v1), _mesh.vertex_id(v2), search.v_dist(v2), _mesh.length(e12), exact,
+             connected, count);
     }
   }
   if (connected) {
-    e_joined(e12) = false;
+    search.set_e_joined(e12, false);
     // In principle, if the cycle is non-separating (i.e. connected == true),
     //   then we could find the shortest "non-separating dual cycle".
     // This would let us characterize the second "dimension" of this topological handle [Wood et al. 2004],
@@ -262,7 +269,7 @@ bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
       Vec2<Array<Edge>> esides;
       for_int(i, 2) {
         for (Edge e : _mesh.edges(_mesh.face(e12, i)))
-          if (!e_joined(e)) esides[i].push(e);
+          if (!search.e_joined(e)) esides[i].push(e);
       }
       for_int(i, 2) {
         if (esides[i].num() != 1) continue;
@@ -270,14 +277,14 @@ bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
         queue.enqueue(esides[i][0]);
         while (queue.length() == 1) {
           Edge ec = queue.dequeue();
-          assertx(!e_joined(ec));
-          assertx(v_dist(_mesh.vertex1(ec)) != BIGFLOAT);
-          assertx(v_dist(_mesh.vertex2(ec)) != BIGFLOAT);
-          e_joined(ec) = true;
+          assertx(!search.e_joined(ec));
+          assertx(search.v_dist(_mesh.vertex1(ec)) != BIGFLOAT);
+          assertx(search.v_dist(_mesh.vertex2(ec)) != BIGFLOAT);
+          search.set_e_joined(ec, true);
           ++count;
           for (Face f : _mesh.faces(ec))
             for (Edge e : _mesh.edges(f))
-              if (!e_joined(e)) queue.enqueue(e);
+              if (!search.e_joined(e)) queue.enqueue(e);
         }
       }
       HH_SSTAT(Szipper, count);
@@ -291,12 +298,13 @@ bool CloseMinCycles::would_be_nonseparating_cycle(Edge e12, bool exact) {
 // Determine if the associated cycle is non-separating (i.e. spans a topological handle).
 // If it is, optionally process the cycle.
 // If was_a_nonseparating_cycle, return the num_edges.
-std::optional<int> CloseMinCycles::look_for_cycle(Vertex v1, Vertex v2, bool process, float verify_dist) {
+std::optional<int> CloseMinCycles::look_for_cycle(Search& search, Vertex v1, Vertex v2, bool process,
+                                                  float verify_dist) {
   HH_STIMER("__look_for_cycle");
   if (verb) Warning("Looking for cycle");
   Edge e12 = _mesh.edge(v1, v2);
-  assertx(!e_joined(e12));
-  if (!would_be_nonseparating_cycle(e12, true)) {
+  assertx(!search.e_joined(e12));
+  if (!would_be_nonseparating_cycle(search, e12, true)) {
     if (verb) Warning("not a cycle");
     return {};
   }
@@ -306,7 +314,7 @@ std::optional<int> CloseMinCycles::look_for_cycle(Vertex v1, Vertex v2, bool pro
     epath[0].push(e12);
     for_int(i, 2) {
       for (Vertex v = _mesh.vertex(e12, i);;) {
-        Vertex vn = v_vprev(v);
+        Vertex vn = search.v_vprev(v);
         if (!vn) break;
         Edge e = _mesh.edge(v, vn);
         epath[i].push(e);
@@ -328,7 +336,7 @@ std::optional<int> CloseMinCycles::look_for_cycle(Vertex v1, Vertex v2, bool pro
     for (Edge e : ecycle) len += _mesh.length(e);
     if (0)
       showdf("Cycle edges=%d length=%g v1d=%g v2d=%g e12=%g\n",  //
-             ecycle.num(), len, v_dist(v1), v_dist(v2), _mesh.length(e12));
+             ecycle.num(), len, search.v_dist(v1), search.v_dist(v2), _mesh.length(e12));
     HH_SSTAT(Scyclene, ecycle.num());
     HH_SSTAT(Scyclelen, len);
     assertw(difference_is_within_relative_eps(len, verify_dist * 2.f, 1e-6f));
@@ -345,9 +353,7 @@ std::optional<int> CloseMinCycles::look_for_cycle(Vertex v1, Vertex v2, bool pro
       SHOWL;
       for (Vertex v : vao) SHOW(_mesh.vertex_id(v));
     }
-    Array<Vertex> van = close_cycle(vao);
-    // Re-initialize v_dist() and e_joined() for that portion of the mesh disconnected from vseed.
-    flood_reinitialize(van[0]);  // pick any new vertex
+    close_cycle(vao);
   }
   return {num_edges};
 }
@@ -355,12 +361,13 @@ std::optional<int> CloseMinCycles::look_for_cycle(Vertex v1, Vertex v2, bool pro
 // Find the smallest size cycle containing vertex vseed -- report search radius (BIGFLOAT if no cycle found)
 //   and farthest vertex in cycle from vseed.
 // If parameter "process" is true, modify the mesh to close the cycle.
-// The caller must clean up e_joined() and v_dist() after this function completes.
-auto CloseMinCycles::min_cycle_from_vertex(Vertex vseed, bool process) -> std::optional<MinCycleResult> {
+// The caller must clean up the search state using search.reinitialize() after this function completes.
+auto CloseMinCycles::min_cycle_from_vertex(Search& search, Vertex vseed, bool process)
+    -> std::optional<MinCycleResult> {
   if (sdebug) {  // verify that previous search has cleanly reinitialized all fields.
     Warning("sdebug");
-    for (Edge e : _mesh.edges()) assertx(!e_joined(e));
-    for (Vertex v : _mesh.vertices()) assertx(v_dist(v) == BIGFLOAT);
+    for (Edge e : _mesh.edges()) assertx(!search.e_joined(e));
+    for (Vertex v : _mesh.vertices()) assertx(search.v_dist(v) == BIGFLOAT);
   }
   Map<Vertex, Vertex> map_vtouch;
   const auto v_vtouch = [&](Vertex v) -> Vertex& { return map_vtouch[v]; };
@@ -373,10 +380,10 @@ auto CloseMinCycles::min_cycle_from_vertex(Vertex vseed, bool process) -> std::o
   //    i.e. v_dist(v) != BIGFLOAT for type (2).
   HPqueue<Vertex> hpq;
   {  // this first iteration is special
-    v_dist(vseed) = 0.f;
-    v_vprev(vseed) = nullptr;
+    search.set_v_dist(vseed, 0.f);
+    search.v_vprev(vseed) = nullptr;
     for (Vertex v : _mesh.vertices(vseed)) {
-      v_vprev(v) = vseed;
+      search.v_vprev(v) = vseed;
       hpq.enter(v, dist(_mesh.point(vseed), _mesh.point(v)));
     }
   }
@@ -386,15 +393,16 @@ auto CloseMinCycles::min_cycle_from_vertex(Vertex vseed, bool process) -> std::o
     Vertex vnew = hpq.remove_min();
     if (0)
       showf("pqmin: v=%d lb=%g v_dist(v)=%g v_vprev(v)=%d v_vtouch(v)=%d\n",  //
-            _mesh.vertex_id(vnew), vdist, v_dist(vnew), v_dist(vnew) == BIGFLOAT ? _mesh.vertex_id(v_vprev(vnew)) : -1,
-            v_dist(vnew) != BIGFLOAT ? _mesh.vertex_id(v_vtouch(vnew)) : -1);
-    if (v_dist(vnew) != BIGFLOAT) {  // a candidate cycle edge
+            _mesh.vertex_id(vnew), vdist, search.v_dist(vnew),
+            search.v_dist(vnew) == BIGFLOAT ? _mesh.vertex_id(search.v_vprev(vnew)) : -1,
+            search.v_dist(vnew) != BIGFLOAT ? _mesh.vertex_id(v_vtouch(vnew)) : -1);
+    if (search.v_dist(vnew) != BIGFLOAT) {  // a candidate cycle edge
       if (verb) Warning("Front is touching itself");
-      if (e_joined(_mesh.edge(vnew, v_vtouch(vnew)))) {
+      if (search.e_joined(_mesh.edge(vnew, v_vtouch(vnew)))) {
         if (verb) Warning("joined in the meantime");
         continue;
       }
-      if (auto result = look_for_cycle(vnew, v_vtouch(vnew), process, vdist)) {
+      if (auto result = look_for_cycle(search, vnew, v_vtouch(vnew), process, vdist)) {
         // We have found a cycle; exit from function
         const float search_radius = vdist;
         Vertex farthest_vertex = v_vtouch(vnew);
@@ -404,56 +412,57 @@ auto CloseMinCycles::min_cycle_from_vertex(Vertex vseed, bool process) -> std::o
       continue;  // not a non-separating cycle; ignore this event
     }
     // Dijkstra BFS visit of vnew, approached from vprev.
-    Vertex vprev = v_vprev(vnew);
+    Vertex vprev = search.v_vprev(vnew);
     {
       Edge e = _mesh.edge(vprev, vnew);
-      v_dist(vnew) = vdist;
-      ASSERTX(difference_is_within_relative_eps(vdist, v_dist(vprev) + _mesh.length(e), 1e-5f));
-      ASSERTX(!e_joined(e));
-      e_joined(e) = true;
+      search.set_v_dist(vnew, vdist);
+      ASSERTX(difference_is_within_relative_eps(vdist, search.v_dist(vprev) + _mesh.length(e), 1e-5f));
+      ASSERTX(!search.e_joined(e));
+      search.set_e_joined(e, true);
     }
     // Update unvisited neighbors using ordinary BFS Dijkstra rules.
     for (Vertex v : _mesh.vertices(vnew)) {
-      if (v_dist(v) != BIGFLOAT) continue;  // already visited
+      if (search.v_dist(v) != BIGFLOAT) continue;  // already visited
       float elen = dist(_mesh.point(vnew), _mesh.point(v));
-      float pdist = v_dist(vnew) + elen;  // possible distance
-      if (hpq.enter_update_if_smaller(v, pdist)) v_vprev(v) = vnew;
+      float pdist = search.v_dist(vnew) + elen;  // possible distance
+      if (hpq.enter_update_if_smaller(v, pdist)) search.v_vprev(v) = vnew;
     }
     // Update unjoined visited neighbors for cycle events.
     {
       Vertex vccw, vclw;  // most ccw|clw contiguous already-visited vertices
       for (vccw = vprev;;) {
-        ASSERTX(v_dist(vccw) != BIGFLOAT);
+        ASSERTX(search.v_dist(vccw) != BIGFLOAT);
         Vertex vn = _mesh.ccw_vertex(vnew, vccw);
-        if (vn == vprev || !e_joined(_mesh.edge(vccw, vn))) break;
-        e_joined(_mesh.edge(vnew, vn)) = true;
+        if (vn == vprev || !search.e_joined(_mesh.edge(vccw, vn))) break;
+        search.set_e_joined(_mesh.edge(vnew, vn), true);
         vccw = vn;
       }
       for (vclw = vprev;;) {
-        ASSERTX(v_dist(vclw) != BIGFLOAT);
+        ASSERTX(search.v_dist(vclw) != BIGFLOAT);
         Vertex vn = _mesh.clw_vertex(vnew, vclw);
-        if (vn == vccw || !e_joined(_mesh.edge(vclw, vn))) break;
-        e_joined(_mesh.edge(vnew, vn)) = true;
+        if (vn == vccw || !search.e_joined(_mesh.edge(vclw, vn))) break;
+        search.set_e_joined(_mesh.edge(vnew, vn), true);
         vclw = vn;
       }
       Vertex vp = vccw;
       // Consider each vertex v not already in current advancing BFS front.
       for (Vertex v = _mesh.ccw_vertex(vnew, vp); v != vclw; vp = v, v = _mesh.ccw_vertex(vnew, vp)) {
-        if (v_dist(v) == BIGFLOAT) {
-          ASSERTX(!e_joined(_mesh.edge(vnew, v)));
+        if (search.v_dist(v) == BIGFLOAT) {
+          ASSERTX(!search.e_joined(_mesh.edge(vnew, v)));
         } else {
           Edge e = _mesh.edge(vnew, v);
-          if (e_joined(e)) continue;  // may have been joined in the meantime during this loop
+          if (search.e_joined(e)) continue;  // may have been joined in the meantime during this loop
           if (verb) Warning("Front is about to touch itself");
-          if (!would_be_nonseparating_cycle(e, false)) {
+          if (!would_be_nonseparating_cycle(search, e, false)) {
             if (verb) Warning("Not would_be_nonseparating_cycle");
             continue;
           }
           // NOTE: must consider halfway point on potential cycle from vseed to vnew to v to vseed!
-          ASSERTX(v_dist(v) <= v_dist(vnew));  // visited earlier
+          ASSERTX(search.v_dist(v) <= search.v_dist(vnew));  // visited earlier
           float elen = dist(_mesh.point(vnew), _mesh.point(v));
-          float pdist = (v_dist(vnew) + v_dist(v) + elen) * .5f;  // possible distance (radius) (half cycle length)
-          assertw(pdist * (1.f + 1e-6f) >= v_dist(vnew));
+          // possible distance (radius) (half cycle length)
+          float pdist = (search.v_dist(vnew) + search.v_dist(v) + elen) * .5f;
+          assertw(pdist * (1.f + 1e-6f) >= search.v_dist(vnew));
           if (hpq.enter_update_if_smaller(v, pdist)) v_vtouch(v) = vnew;
         }
       }
@@ -476,16 +485,19 @@ auto CloseMinCycles::min_cycle_from_vertex(Vertex vseed, bool process) -> std::o
 //   in the search region cannot contain small cycles.
 void CloseMinCycles::find_cycles() {
   HH_TIMER("_find_cycles");
+  Search search;
+  search.mesh = &_mesh;
   if (0) {  // debug
     // results in 2 separate components, so not a topological handle
     close_cycle(V(_mesh.id_vertex(50), _mesh.id_vertex(53), _mesh.id_vertex(59), _mesh.id_vertex(49)));
     return;
   }
   if (0) {  // debug
-    const auto result = min_cycle_from_vertex(_mesh.id_vertex(49), true);
+    search.resize(_num_vertex_ids, _num_edge_indices);
+    const auto result = min_cycle_from_vertex(search, _mesh.id_vertex(49), true);
     SHOW(result->search_radius);
     for (Vertex v : _mesh.vertices())
-      if (v_dist(v) != BIGFLOAT) showf("vdist(%d)=%g\n", _mesh.vertex_id(v), v_dist(v));
+      if (search.v_dist(v) != BIGFLOAT) showf("vdist(%d)=%g\n", _mesh.vertex_id(v), search.v_dist(v));
     return;
   }
   HPqueue<Vertex> pqvlbsr;  // lower-bound on search radius for min cycle about vertex
@@ -515,7 +527,8 @@ void CloseMinCycles::find_cycles() {
       break;
     }
     ++iter;
-    const auto result = min_cycle_from_vertex(vseed, false);
+    search.resize(_num_vertex_ids, _num_edge_indices);
+    const auto result = min_cycle_from_vertex(search, vseed, false);
     const float sr = result ? result->search_radius : BIGFLOAT;
     ubsr = min(ubsr, sr);  // if find a cycle, possibly reduce the upper-bound on the minimal search radius
     if (verb)
@@ -529,39 +542,23 @@ void CloseMinCycles::find_cycles() {
       SHOW((lbsr - ubsr) / ubsr - 1.f);
       assertx(ubsr >= lbsr);
     }
-    if (0 && sr == BIGFLOAT) {  // this test is invalid if the mesh has multiple connected components
-      showdf("No more cycles at all\n");
-      break;  // efficiency shortcut: no need to clean up v_dist() and e_joined().
-    }
-    // Update pqvlbsr and re-initialize v_dist() and e_joined().
+    // Update pqvlbsr and re-initialize the search state.
     {
       pqvlbsr.update(vseed, sr);  // should never change again because it is the exact distance
-      // The following is like flood_reinitialize(vseed) but it also updates pqvlbsr.
-      v_dist(vseed) = BIGFLOAT;
-      Queue<Vertex> queue;
-      queue.enqueue(vseed);
-      while (!queue.empty()) {
-        Vertex vc = queue.dequeue();
-        ASSERTX(v_dist(vc) == BIGFLOAT);
-        for (Edge e : _mesh.edges(vc)) {
-          e_joined(e) = false;
-          Vertex vn = _mesh.opp_vertex(vc, e);
-          if (v_dist(vn) != BIGFLOAT) {
-            // Vertex vn was found to have distance v_dist(vn) from vseed.
-            // Since the minimal cycle about vseed has length sr * 2, we can infer that the minimal cycle
-            //  about vn cannot be smaller than (sr - v_dist(vn)) * 2.
-            float nlb = sr - v_dist(vn);  // new lower-bound radius
-            if (nlb < 0.f) {
-              if (0) SHOW(nlb);
-              assertx(nlb > -sr * 1e-6f);
-              nlb = 0.f;
-            }
-            pqvlbsr.enter_update_if_greater(vn, nlb);
-            v_dist(vn) = BIGFLOAT;
-            queue.enqueue(vn);
-          }
+      for (Vertex vn : search.visited) {
+        if (vn == vseed) continue;
+        // Vertex vn was found to have distance v_dist(vn) from vseed.
+        // Since the minimal cycle about vseed has length sr * 2, we can infer that the minimal cycle
+        //  about vn cannot be smaller than (sr - v_dist(vn)) * 2.
+        float nlb = sr - search.v_dist(vn);  // new lower-bound radius
+        if (nlb < 0.f) {
+          if (0) SHOW(nlb);
+          assertx(nlb > -sr * 1e-6f);
+          nlb = 0.f;
         }
+        pqvlbsr.enter_update_if_greater(vn, nlb);
       }
+      search.reinitialize();
       lbsr = pqvlbsr.min_priority();
       if (!(ubsr >= lbsr)) assertnever(SSHOW(_mesh.vertex_id(pqvlbsr.min()), lbsr));
     }
@@ -569,7 +566,6 @@ void CloseMinCycles::find_cycles() {
     // Process the cycle if its radius is within some fraction of the lower-bound minimal cycle radius lbsr.
     if (sr <= _frac_cycle_length * lbsr) {  // was: "if (sr == lbsr)"
       if (verb) showdf("After %d iter, processing cycle of length %g\n", iter + 1, sr * 2.f);
-      assertx(result);
       if (result->num_edges > _max_cycle_nedges) {
         showdf("Stopping because next cycle has %d>%d edges\n", result->num_edges, _max_cycle_nedges);
         break;
@@ -577,14 +573,14 @@ void CloseMinCycles::find_cycles() {
       bool restart_at_farthest = true;  // may improve loop if _frac_cycle_length > 1.f (e.g. holes3.m)
       if (!assertw(_frac_cycle_length > (1.f + 1e-6f))) restart_at_farthest = false;  // fix 2014-09-11
       if (restart_at_farthest) vseed = result->farthest_vertex;
-      const auto result2 = assertx(min_cycle_from_vertex(vseed, true));
+      const auto result2 = assertx(min_cycle_from_vertex(search, vseed, true));
       assertx(result2->search_radius <= sr * (1.f + 1e-6f));
       if (!restart_at_farthest) assertx(result2->search_radius == sr);
       assertw(result2->num_edges <= _max_cycle_nedges);
-      flood_reinitialize(vseed);  // again re-initialize v_dist() and e_joined()
+      search.reinitialize();  // again re-initialize v_dist() and e_joined()
       if (sdebug) {
         Warning("slow");
-        for (Edge e : _mesh.edges()) assertx(!e_joined(e));
+        for (Edge e : _mesh.edges()) assertx(!search.e_joined(e));
       }
       ++nprocessed;
       --_cgenus;
@@ -633,14 +629,9 @@ void CloseMinCycles::compute() {
   }
   for (Vertex v : _mesh.vertices()) {
     assertx(_mesh.degree(v) > 0);  // no isolated vertices
-    v_dist(v) = BIGFLOAT;
-    // v_vtouch(v) is undefined
-    // v_vprev(v) is undefined
-  }
-  for (Edge e : _mesh.edges()) {
-    e_joined(e) = false;
-    e_bfsnum(e) = 0;
+    _num_vertex_ids = max(_num_vertex_ids, _mesh.vertex_id(v) + 1);
   }
+  for (Edge e : _mesh.edges()) e_index(e) = _num_edge_indices++;
   {
     HH_TIMER("__genus");
     float fgenus = mesh_genus(_mesh);  // somewhat slow implementation
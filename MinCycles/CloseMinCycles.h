@@ -25,21 +25,23 @@ class CloseMinCycles {
   void compute();
 
  private:
+  struct Search;
   GMesh& _mesh;
   int _cgenus{std::numeric_limits<int>::max()};  // current mesh genus
   int _tot_handles{0};
   int _tot_tunnels{0};
-  Flag e_joined(Edge e);
-  void flood_reinitialize(Vertex vseed);
+  int _num_vertex_ids{0};    // bound on vertex ids, which index the state of each search
+  int _num_edge_indices{0};  // number of edge indices assigned so far, which index the state of each search
   Array<Vertex> close_cycle(const CArrayView<Vertex> vao);
-  bool would_be_nonseparating_cycle(Edge e12, bool exact);
-  std::optional<int> look_for_cycle(Vertex v1, Vertex v2, bool process, float verify_dist);  // Ret: num_edges.
+  bool would_be_nonseparating_cycle(Search& search, Edge e12, bool exact) const;
+  std::optional<int> look_for_cycle(Search& search, Vertex v1, Vertex v2, bool process,
+                                    float verify_dist);  // Ret: num_edges.
   struct MinCycleResult {
     float search_radius;
     Vertex farthest_vertex;
     int num_edges;
   };
-  std::optional<MinCycleResult> min_cycle_from_vertex(Vertex vseed, bool process);
+  std::optional<MinCycleResult> min_cycle_from_vertex(Search& search, Vertex vseed, bool process);
   void find_cycles();
 };
 
@@ -493,56 +493,106 @@ class SphereMapper::Implementation {
 
   static constexpr float k_spatial_fade = 0.3f;
 
+  // Greedily color the vertices such that no two adjacent vertices share a color.  The optimization of a vertex reads
+  // only the sph values of its one-ring, so the vertices of each color may be relocated concurrently.
+  static Array<int> color_vertices(CArrayView<int> ring_offsets, CArrayView<int> ring_vertices, int& num_colors) {
+    const int nv = ring_offsets.num() - 1;
+    Array<int> vertex_color(nv, -1);
+    Array<int> color_stamp;  // Vertex v that last marked the color as used by a neighbor.
+    num_colors = 0;
+    for_int(v, nv) {
+      for_intL(k, ring_offsets[v], ring_offsets[v + 1])
+        if (const int color = vertex_color[ring_vertices[k]]; color >= 0) color_stamp[color] = v;
+      int color = 0;
+      while (color < num_colors && color_stamp[color] == v) color++;
+      if (color == num_colors) {
+        num_colors++;
+        color_stamp.push(-1);
+      }
+      vertex_color[v] = color;
+    }
+    return vertex_color;
+  }
+
+  // Total objective over the mesh faces, evaluated concurrently over a flat array of per-face terms.
+  double total_energy() const {
+    Array<Precision> face_energy(_pmi._faces.num());
+    parallel_for_each({2'000}, range(face_energy.num()), [&](const int f) {
+      face_energy[f] = stretch_for_face(f);
+      if (_matid_is_hole[_pmi._faces[f].attrib.matid]) face_energy[f] *= _options.hole_weight;
+    });
+    double energy = 0.;
+    for (const Precision e : face_energy) energy += e;
+    return energy;
+  }
+
   void optimize_all() {
     HH_STIMER("_optimize_all");
+    const double start_time = get_precise_time();
     set_stretch_scaling();
     const int nv = _pmi._vertices.num();
     if (_options.verbose >= 2) std::cerr << sform("nv=%d", nv) << std::flush;
     const Array<int> someface = _pmi.gather_someface();
-    Array<Point> ar_sph(nv);
-    Array<float> ar_displacement(nv);
-    Array<int> ar_vertex(range(nv));
+    // Flat one-ring adjacency (compressed sparse rows), fixed during the optimization.
+    Array<int> ring_offsets(nv + 1), ring_vertices;
+    ring_offsets[0] = 0;
+    for_int(v, nv) {
+      for (const auto& [vv, unused_ff] : _pmi.ccw_vertices(v, someface[v])) ring_vertices.push(vv);
+      ring_offsets[v + 1] = ring_vertices.num();
+    }
+    int num_colors;
+    const Array<int> vertex_color = color_vertices(ring_offsets, ring_vertices, num_colors);
+    Array<float> ar_displacement(nv), ar_move(nv);
     Matrix<float> ar_random(nv, 2);  // For reproducible results under parallelism.
-    const auto by_decreasing_displacement = [&](int v1, int v2) { return ar_displacement[v1] > ar_displacement[v2]; };
+    Array<int> active_vertices, color_offsets(num_colors + 1), color_active(nv);
+    int num_sweeps = 0;
 
     for_int(iter, _optim_global_iter) {
       fill(ar_displacement, 3.f);  // Some value larger than the unit sphere diameter.
-      int num_active = nv;
       for (int update_iter = 0;; update_iter++) {
-        if (!assertw(update_iter < 2000) || !num_active) break;
+        active_vertices.init(0);
+        for_int(v, nv)
+          if (ar_displacement[v] > _optim_movetol) active_vertices.push(v);
+        if (!assertw(update_iter < 2000) || !active_vertices.num()) break;
+        num_sweeps++;
 
-        ArrayView<int> active_vertices = ar_vertex.head(num_active);
         for (const int v : active_vertices) for_int(c, 2) ar_random[v][c] = Random::G.unif();
 
-        parallel_for_each({10'000}, range(num_active), [&](int i) {
-          const int v = active_vertices[i];
-          ar_sph[v] = optimize_vertex_rand(v, someface[v], ar_random[v][0], ar_random[v][1]);
-          ar_displacement[v] += dist(ar_sph[v], _sphmap[v]);
-        });
-
-        sort(active_vertices, by_decreasing_displacement);
-
-        Array<bool> locked(nv, false);
-        for (const int v : active_vertices) {
-          if (locked[v]) continue;
-          assertx(ar_displacement[v] > _optim_movetol);
-          const float displacement = dist(ar_sph[v], _sphmap[v]);
-          _sphmap[v] = ar_sph[v];
-          ar_displacement[v] = 0.f;
-          for (const auto& [vv, unused_ff] : _pmi.ccw_vertices(v, someface[v])) {
-            locked[vv] = true;
-            ar_displacement[vv] += displacement * k_spatial_fade;
-          }
+        // Bucket the active vertices by color (counting sort, preserving vertex order).
+        fill(color_offsets, 0);
+        for (const int v : active_vertices) color_offsets[vertex_color[v] + 1]++;
+        for_int(color, num_colors) color_offsets[color + 1] += color_offsets[color];
+        {
+          Array<int> next(color_offsets.head(num_colors));
+          for (const int v : active_vertices) color_active[next[vertex_color[v]]++] = v;
+        }
+
+        // Gauss-Seidel over the colors: the vertices within a color are independent.
+        for_int(color, num_colors) {
+          const CArrayView<int> vertices = color_active.slice(color_offsets[color], color_offsets[color + 1]);
+          parallel_for_each({10'000}, range(vertices.num()), [&](const int i) {
+            const int v = vertices[i];
+            const Point sph = optimize_vertex_rand(v, someface[v], ar_random[v][0], ar_random[v][1]);
+            ar_move[v] = dist(sph, _sphmap[v]);
+            _sphmap[v] = sph;
+          });
         }
-        if (_options.verbose >= 2 && update_iter % 10 == 0) std::cerr << "." << std::flush;
 
-        sort(ar_vertex, by_decreasing_displacement);
-        num_active = 0;
-        while (num_active < nv && ar_displacement[ar_vertex[num_active]] > _optim_movetol) num_active++;
+        for (const int v : active_vertices) ar_displacement[v] = 0.f;
+        for (const int v : active_vertices)
+          for_intL(k, ring_offsets[v], ring_offsets[v + 1])
+            ar_displacement[ring_vertices[k]] += ar_move[v] * k_spatial_fade;
+        if (_options.verbose >= 2 && update_iter % 10 == 0) std::cerr << "." << std::flush;
       }
       if (_options.verbose >= 2) std::cerr << "|" << std::flush;
       update_visualizer_optimize_all();
     }
+    if (_options.verbose >= 2) {
+      const double time = get_precise_time() - start_time;
+      std::cerr << sform(" colors=%d sweeps=%d time=%.2fs energy=%.6g\n", num_colors, num_sweeps, time,
+                         total_energy())
+                << std::flush;
+    }
   }
 
   void goto_nverts(int target_nv) {
@@ -572,7 +622,6 @@ class SphereMapper::Implementation {
     if (_options.verbose >= 2) std::cerr << "finest_" << std::flush;
 
     optimize_all();
-    if (_options.verbose >= 2) std::cerr << "\n" << std::flush;
     for_int(f, _pmi._faces.num()) assertx(!face_flipped(f));
   }
 
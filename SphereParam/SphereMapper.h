@@ -14,7 +14,7 @@ namespace hh {
 class SphereMapper {
  public:
   struct Options {
-    int verbose{1};                   // 0=quiet; 1=default; 2=more.
+    int verbose{1};                   // 0=quiet; 1=default; 2=more (e.g. time and energy per level).
     int effort{2};                    // Level (0..5) of thoroughness in optimization (slower but more accurate).
     bool visualize{false};            // Launch a piped process to visualize progress of spherical parameterization.
     bool wait_on_visualizer{false};   // Wait for user to close the visualizer window.
@@ -41,6 +41,7 @@ string rotate_s3d;               // Filename for s3d file.
 Array<string> key_names{"sph"};  // Set of string attributes written to output mesh.
 string signal_;                  // Surface signal ("G", "N", or "C") (for geometry, normal, or color).
 bool feather_texture = true;     // Blend texture discontinuities in do_write_texture().
+bool cache_resample_map = false;  // Save/reuse the texel-to-surface map next to param_file in texture outputs.
 int verbose = 1;
 bool first_domain_face = false;
 bool nooutput = false;
@@ -1102,21 +1103,14 @@ void do_sample_map(Args& args) {
   }
 }
 
-// Returns k_undefined_vector if undefined.
-Vector interp_f_normal(const GMesh& mesh, Face f, const Bary& bary) {
+// Given normal_channel == mesh.corner_channel("normal", 3); returns k_undefined_vector if undefined.
+Vector interp_f_normal(const GMesh& mesh, GMeshChannel& normal_channel, Face f, const Bary& bary) {
   const Vec3<Corner> corners = mesh.triangle_corners(f);
   Vector sum_normal{};
   int num_defined = 0;
   for_int(i, 3) {
-    Corner c = corners[i];
     Vector normal;
-    if (GMesh::string_has_key(mesh.get_string(c), "normal")) {
-      assertx(mesh.parse_corner_key_vec(c, "normal", normal));
-    } else if (Vertex v = mesh.corner_vertex(c); v_normal(v) != k_undefined_vector) {
-      normal = v_normal(v);
-    } else {
-      continue;
-    }
+    if (!normal_channel.get(corners[i], normal)) continue;
     num_defined++;
     sum_normal += normal * bary[i];
   }
@@ -1125,21 +1119,14 @@ Vector interp_f_normal(const GMesh& mesh, Face f, const Bary& bary) {
   return normalized(sum_normal);
 }
 
-// Returns k_undefined_vector if undefined.
-Vector interp_f_rgb(const GMesh& mesh, Face f, const Bary& bary) {
+// Given rgb_channel == mesh.corner_channel("rgb", 3); returns k_undefined_vector if undefined.
+Vector interp_f_rgb(const GMesh& mesh, GMeshChannel& rgb_channel, Face f, const Bary& bary) {
   const Vec3<Corner> corners = mesh.triangle_corners(f);
   Vector sum_rgb{};
   int num_defined = 0;
   for_int(i, 3) {
-    Corner c = corners[i];
     Vector rgb;
-    if (GMesh::string_has_key(mesh.get_string(c), "rgb")) {
-      assertx(mesh.parse_corner_key_vec(c, "rgb", rgb));
-    } else if (Vertex v = mesh.corner_vertex(c); v_rgb(v) != k_undefined_vector) {
-      rgb = v_rgb(v);
-    } else {
-      continue;
-    }
+    if (!rgb_channel.get(corners[i], rgb)) continue;
     num_defined++;
     sum_rgb += rgb * bary[i];
   }
@@ -1177,6 +1164,10 @@ void internal_remesh() {
   const MeshSearch mesh_search(param_mesh, options);
 
   HH_TIMER("_resample");
+  // Each face is sampled many times, so its attribute strings are parsed just once here.
+  GMeshChannel& normal_channel = param_mesh.corner_channel("normal", 3);
+  GMeshChannel& rgb_channel = param_mesh.corner_channel("rgb", 3);
+  GMeshChannel& face_rgb_channel = param_mesh.face_channel("rgb", 3);
   const int num_threads = get_max_threads();
   parallel_for_chunk(Array<Vertex>(g_mesh.vertices()), num_threads, [&](const int thread_index, auto subrange) {
     dummy_use(thread_index);
@@ -1191,12 +1182,12 @@ void internal_remesh() {
       const Vec3<Point> triangle = map(g_mesh.triangle_vertices(param_f), v_domainp);
       const Point newp = interp(triangle, bary);
       g_mesh.set_point(v, newp);
-      v_normal(v) = interp_f_normal(param_mesh, param_f, bary);
+      v_normal(v) = interp_f_normal(param_mesh, normal_channel, param_f, bary);
       if (checkern) {
         // Ignore mesh color since checkering.
       } else {
-        Vector rgb = interp_f_rgb(param_mesh, param_f, bary), rgb2;
-        if (rgb == k_undefined_vector && parse_key_vec(param_mesh.get_string(param_f), "rgb", rgb2)) rgb = rgb2;
+        Vector rgb = interp_f_rgb(param_mesh, rgb_channel, param_f, bary), rgb2;
+        if (rgb == k_undefined_vector && face_rgb_channel.get(param_f, rgb2)) rgb = rgb2;
         v_rgb(v) = rgb;
       }
     }
@@ -1249,8 +1240,17 @@ void do_signal(Args& args) {
   assertx(contains(V<string>("G", "N", "C"), signal_));
 }
 
-void assign_signal(Pixel& pixel, const GMesh& mesh, const Bbox<float, 3>& bbox, const Frame& rotate_frame, Face f,
-                   const Bary& bary) {
+// Return the corner channel of the normal or rgb signal, or nullptr for the geometry signal.
+GMeshChannel* signal_channel(const GMesh& mesh) {
+  switch (signal_[0]) {
+    case 'N': return &mesh.corner_channel("normal", 3);
+    case 'C': return &mesh.corner_channel("rgb", 3);
+    default: return nullptr;
+  }
+}
+
+void assign_signal(Pixel& pixel, const GMesh& mesh, GMeshChannel* channel, const Bbox<float, 3>& bbox,
+                   const Frame& rotate_frame, Face f, const Bary& bary) {
   pixel[3] = 255;
   switch (signal_[0]) {
     case 'G': {
@@ -1265,7 +1265,7 @@ void assign_signal(Pixel& pixel, const GMesh& mesh, const Bbox<float, 3>& bbox,
       break;
     }
     case 'N': {
-      const Vector normal = interp_f_normal(mesh, f, bary) * rotate_frame;
+      const Vector normal = interp_f_normal(mesh, *channel, f, bary) * rotate_frame;
       for_int(z, 3) {
         assertx(abs(normal[z]) <= 1.f + 1e-6f);
         pixel[z] = uint8_t((normal[z] * .5f + .5f) * 255.f + .5f);
@@ -1273,7 +1273,7 @@ void assign_signal(Pixel& pixel, const GMesh& mesh, const Bbox<float, 3>& bbox,
       break;
     }
     case 'C': {
-      Vector rgb = interp_f_rgb(mesh, f, bary);
+      Vector rgb = interp_f_rgb(mesh, *channel, f, bary);
       for_int(z, 3) {
         assertx(rgb[z] >= 0.f && rgb[z] <= 1.f + 1e-6f);
         pixel[z] = uint8_t(rgb[z] * 255.f + .5f);
@@ -1351,6 +1351,80 @@ void apply_feathering(Image& image) {
   }
 }
 
+// Correspondence from each texel of an image to a point on the surface param_mesh.  Computing it requires chaining
+// searches across meshes, whereas resampling any signal given the map is a pure gather.
+struct ResampleMap {
+  Matrix<int> face_ids;  // Id of the face in param_mesh, or 0 if the texel lies outside the domain.
+  Grid<3, float> barys;  // Barycentric coordinates of the point within the face.
+};
+
+// A cached map is stored next to param_file, as a text header line followed by Big Endian face ids and barycentrics.
+string resample_map_filename(const string& suffix) { return param_file + "." + suffix + ".rmap"; }
+
+// Read a cached map if it is newer than all its source files, its header matches, and all its face ids are in
+// param_mesh.  Ret: success.
+bool read_resample_map(const string& suffix, const string& header, CArrayView<string> sources,
+                       const GMesh& param_mesh, ResampleMap& rmap) {
+  if (!cache_resample_map || file_requires_pipe(param_file)) return false;
+  const string filename = resample_map_filename(suffix);
+  if (!file_exists(filename)) return false;
+  for (const string& source : sources)
+    if (get_path_modification_time(source) > get_path_modification_time(filename)) return false;
+  RFile fi(filename);
+  string line;
+  if (!my_getline(fi(), line) || line != header) return false;
+  rmap.face_ids.init(V(gridn, gridn));
+  rmap.barys.init(V(gridn, gridn, 3));
+  if (!read_binary_std(fi(), rmap.face_ids.array_view()) || !read_binary_std(fi(), rmap.barys.array_view())) {
+    Warning("Resample map is truncated");
+    return false;
+  }
+  for (const int face_id : rmap.face_ids) {
+    if (face_id && !param_mesh.id_retrieve_face(face_id)) {
+      Warning("Resample map refers to a face absent from param_mesh");
+      return false;
+    }
+  }
+  if (verbose) showdf("Read resample map %s\n", filename.c_str());
+  return true;
+}
+
+void write_resample_map(const string& suffix, const string& header, const ResampleMap& rmap) {
+  if (!cache_resample_map) return;
+  if (file_requires_pipe(param_file)) {
+    Warning("Cannot cache resample map for piped param_file");
+    return;
+  }
+  const string filename = resample_map_filename(suffix);
+  WFile fi(filename);
+  std::ostream& os = fi();
+  os << header << "\n";
+  write_binary_std(os, rmap.face_ids.array_view());
+  write_binary_std(os, rmap.barys.array_view());
+  assertx(os);
+  if (verbose) showdf("Wrote resample map %s\n", filename.c_str());
+}
+
+// Resample the signal of param_mesh into the image by gathering at the texel correspondences.
+void resample_signal(Image& image, const ResampleMap& rmap, const GMesh& param_mesh, const Bbox<float, 3>& bbox,
+                     const Frame& rotate_frame) {
+  HH_TIMER("_resample_signal");
+  assertx(rmap.face_ids.dims() == image.dims());
+  GMeshChannel* channel = signal_channel(param_mesh);  // Created before the concurrent accesses.
+  parallel_for_each({200}, range(image.ysize()), [&](const int y) {
+    for_int(x, image.xsize()) {
+      Pixel& pixel = image[y][x];
+      const int face_id = rmap.face_ids[y][x];
+      if (!face_id) {
+        pixel = Pixel(255, 255, 255, 255);
+        continue;
+      }
+      const Bary bary(rmap.barys[y][x][0], rmap.barys[y][x][1], rmap.barys[y][x][2]);
+      assign_signal(pixel, param_mesh, channel, bbox, rotate_frame, param_mesh.id_face(face_id), bary);
+    }
+  });
+}
+
 void do_write_texture(Args& args) {
   const string image_name = args.get_filename();
   assertx(signal_ != "");
@@ -1359,26 +1433,10 @@ void do_write_texture(Args& args) {
   assertx(gridn);
   assertx(g_mesh.empty());
 
-  const GMesh domain_mesh = read_sphparam_mesh(domain_file);  // Map: domain D -> sphere S (v -> v_sph(v)).
-  GMesh param_mesh = read_sphparam_mesh(param_file);          // Map (initially): mesh M -> sphere S (v -> v_sph(v)).
+  GMesh param_mesh = read_sphparam_mesh(param_file);  // Map (initially): mesh M -> sphere S (v -> v_sph(v)).
   const Bbox bbox{transform(param_mesh.vertices(), [&](Vertex v) { return param_mesh.point(v); })};
   const Frame rotate_frame = get_rotate_frame();
 
-  GMesh mesh_i;  // Map: image I -> domain D  (v -> v_domainp(v)).
-  {
-    const int orig_gridn = std::exchange(gridn, 1);  // Create an untessellated domain mesh.
-    scheme = "domain";  // The choice does not matter because the domain is not tessellated.
-    create(true);
-    gridn = orig_gridn;
-    //
-    mesh_i.copy(g_mesh);
-    for (Vertex v : mesh_i.vertices()) {
-      Vertex vv = g_mesh.id_vertex(g_mesh.vertex_id(v));
-      v_domainp(v) = g_mesh.point(vv);
-      mesh_i.set_point(v, concat(v_imageuv(vv), V(0.f)));
-    }
-  }
-
   // Invert the mapping of param_mesh to create the map: sphere S -> mesh M (v -> v_domainp(v)).
   for (Vertex v : param_mesh.vertices()) {
     v_domainp(v) = param_mesh.point(v);
@@ -1391,51 +1449,78 @@ void do_write_texture(Args& args) {
     v_rgb(v) = rgb;
   }
 
-  MeshSearch::Options options_i;
-  options_i.bbox = Bbox(Point(0.f, 0.f, 0.f), Point(1.f, 1.f, 0.f));
-  const MeshSearch msearch_i(mesh_i, options_i);                // Map: image I -> domain D (v -> v_domainp(v)).
-  const MeshSearch msearch_d(domain_mesh, {true});              // Map: domain D -> sphere S (v -> v_sph(v)).
-  const MeshSearch msearch_s(param_mesh, {true, false, true});  // Map: sphere S -> mesh M (v -> v_domainp(v)).
+  const string suffix = sform("%s%d", domain.c_str(), gridn);
+  const string header = sform("ResampleMap texture domain=%s gridn=%d nfaces=%d", domain.c_str(), gridn,
+                              param_mesh.num_faces());
+  ResampleMap rmap;
+  if (!read_resample_map(suffix, header, V<string>(param_file, domain_file), param_mesh, rmap)) {
+    const GMesh domain_mesh = read_sphparam_mesh(domain_file);  // Map: domain D -> sphere S (v -> v_sph(v)).
+
+    GMesh mesh_i;  // Map: image I -> domain D  (v -> v_domainp(v)).
+    {
+      const int orig_gridn = std::exchange(gridn, 1);  // Create an untessellated domain mesh.
+      scheme = "domain";  // The choice does not matter because the domain is not tessellated.
+      create(true);
+      gridn = orig_gridn;
+      //
+      mesh_i.copy(g_mesh);
+      for (Vertex v : mesh_i.vertices()) {
+        Vertex vv = g_mesh.id_vertex(g_mesh.vertex_id(v));
+        v_domainp(v) = g_mesh.point(vv);
+        mesh_i.set_point(v, concat(v_imageuv(vv), V(0.f)));
+      }
+    }
 
-  HH_TIMER("_write_texture");
-  const int imagesize = gridn;
-  Image image(V(imagesize, imagesize));
-  const int num_threads = get_max_threads();
-  // for_int(y, image.ysize()) {
-  parallel_for_chunk(range(image.ysize()), num_threads, [&](const int thread_index, auto subrange) {
-    dummy_use(thread_index);
-    Face hint_f_d = nullptr, hint_f_s = nullptr;
-    for (const int y : subrange) {
-      for_int(x, image.xsize()) {
-        // We flip the image vertically because the OpenGL Uv coordinate origin is at the image lower-left.
-        const int yy = image.ysize() - 1 - y;
-        Pixel& pixel = image[yy][x];
-        Point p_i, p_d, p_s;
-        p_i = Point((x + 0.5f) / image.xsize(), (y + 0.5f) / image.ysize(), 0.f);  // Dual sampling.
-        {
-          auto [f, bary, unused_clp, d2] = msearch_i.search(p_i, nullptr);
-          if (d2 > 0.f) {
-            pixel = Pixel(255, 255, 255, 255);
-            continue;
+    MeshSearch::Options options_i;
+    options_i.bbox = Bbox(Point(0.f, 0.f, 0.f), Point(1.f, 1.f, 0.f));
+    const MeshSearch msearch_i(mesh_i, options_i);                // Map: image I -> domain D (v -> v_domainp(v)).
+    const MeshSearch msearch_d(domain_mesh, {true});              // Map: domain D -> sphere S (v -> v_sph(v)).
+    const MeshSearch msearch_s(param_mesh, {true, false, true});  // Map: sphere S -> mesh M (v -> v_domainp(v)).
+
+    HH_TIMER("_resample_map");
+    rmap.face_ids.init(V(gridn, gridn));
+    rmap.barys.init(V(gridn, gridn, 3));
+    const int num_threads = get_max_threads();
+    parallel_for_chunk(range(gridn), num_threads, [&](const int thread_index, auto subrange) {
+      dummy_use(thread_index);
+      Face hint_f_d = nullptr, hint_f_s = nullptr;
+      for (const int y : subrange) {
+        for_int(x, gridn) {
+          // We flip the image vertically because the OpenGL Uv coordinate origin is at the image lower-left.
+          const int yy = gridn - 1 - y;
+          Point p_i, p_d, p_s;
+          p_i = Point((x + 0.5f) / gridn, (y + 0.5f) / gridn, 0.f);  // Dual sampling.
+          {
+            auto [f, bary, unused_clp, d2] = msearch_i.search(p_i, nullptr);
+            if (d2 > 0.f) {
+              rmap.face_ids[yy][x] = 0;
+              continue;
+            }
+            const Vec3<Point> triangle = map(mesh_i.triangle_vertices(f), v_domainp);
+            p_d = interp(triangle, bary);
           }
-          const Vec3<Point> triangle = map(mesh_i.triangle_vertices(f), v_domainp);
-          p_d = interp(triangle, bary);
-        }
-        {
-          auto [f, bary, unused_clp, d2] = msearch_d.search(p_d, hint_f_d);
-          hint_f_d = f;
-          if (d2 >= 1e-12f) assertnever(SSHOW(p_i, p_d, f, bary, unused_clp, d2));
-          const Vec3<Vertex> face_vertices = domain_mesh.triangle_vertices(f);
-          Vector sum{};
-          for_int(i, 3) sum += bary[i] * v_sph(face_vertices[i]);
-          p_s = normalized(sum);
+          {
+            auto [f, bary, unused_clp, d2] = msearch_d.search(p_d, hint_f_d);
+            hint_f_d = f;
+            if (d2 >= 1e-12f) assertnever(SSHOW(p_i, p_d, f, bary, unused_clp, d2));
+            const Vec3<Vertex> face_vertices = domain_mesh.triangle_vertices(f);
+            Vector sum{};
+            for_int(i, 3) sum += bary[i] * v_sph(face_vertices[i]);
+            p_s = normalized(sum);
+          }
+          auto [f, bary] = msearch_s.search_on_sphere(p_s, hint_f_s);
+          hint_f_s = f;
+          rmap.face_ids[yy][x] = param_mesh.face_id(f);
+          for_int(i, 3) rmap.barys[yy][x][i] = bary[i];
         }
-        auto [f, bary] = msearch_s.search_on_sphere(p_s, hint_f_s);
-        hint_f_s = f;
-        assign_signal(pixel, param_mesh, bbox, rotate_frame, f, bary);
       }
-    }
-  });
+    });
+    write_resample_map(suffix, header, rmap);
+  }
+
+  HH_TIMER("_write_texture");
+  Image image(V(gridn, gridn));
+  resample_signal(image, rmap, param_mesh, bbox, rotate_frame);
   if (feather_texture) apply_feathering(image);
   image.write_file(image_name);
   nooutput = true;
@@ -1548,28 +1633,36 @@ void do_write_lonlat_texture(Args& args) {
     default: assertnever("signal '" + signal_ + "' not recognized");
   }
 
-  const MeshSearch mesh_search(param_mesh, {true});
-
-  const int imagesize = gridn;
-  Image image(V(imagesize, imagesize));
-
-  const int num_threads = get_max_threads();
-  parallel_for_chunk(range(image.ysize()), num_threads, [&](const int thread_index, auto subrange) {
-    dummy_use(thread_index);
-    Face hint_f = nullptr;
-    for (const int y : subrange) {
-      for_int(x, image.xsize()) {
-        // We flip the image vertically because the OpenGL Uv coordinate origin is at the image lower-left.
-        const int yy = image.ysize() - 1 - y;
-        Pixel& pixel = image[yy][x];
-        const Uv lonlat((x + .5f) / image.xsize(), (y + .5f) / image.ysize());  // Dual sampling.
-        const Point sph = sph_from_lonlat(lonlat);
-        auto [f, bary] = mesh_search.search_on_sphere(sph, hint_f);
-        hint_f = f;
-        assign_signal(pixel, param_mesh, bbox, rotate_frame, f, bary);
+  const string suffix = sform("lonlat%d", gridn);
+  const string header = sform("ResampleMap lonlat gridn=%d nfaces=%d", gridn, param_mesh.num_faces());
+  ResampleMap rmap;
+  if (!read_resample_map(suffix, header, V<string>(param_file), param_mesh, rmap)) {
+    const MeshSearch mesh_search(param_mesh, {true});
+    HH_TIMER("_resample_map");
+    rmap.face_ids.init(V(gridn, gridn));
+    rmap.barys.init(V(gridn, gridn, 3));
+    const int num_threads = get_max_threads();
+    parallel_for_chunk(range(gridn), num_threads, [&](const int thread_index, auto subrange) {
+      dummy_use(thread_index);
+      Face hint_f = nullptr;
+      for (const int y : subrange) {
+        for_int(x, gridn) {
+          // We flip the image vertically because the OpenGL Uv coordinate origin is at the image lower-left.
+          const int yy = gridn - 1 - y;
+          const Uv lonlat((x + .5f) / gridn, (y + .5f) / gridn);  // Dual sampling.
+          const Point sph = sph_from_lonlat(lonlat);
+          auto [f, bary] = mesh_search.search_on_sphere(sph, hint_f);
+          hint_f = f;
+          rmap.face_ids[yy][x] = param_mesh.face_id(f);
+          for_int(i, 3) rmap.barys[yy][x][i] = bary[i];
+        }
       }
-    }
-  });
+    });
+    write_resample_map(suffix, header, rmap);
+  }
+
+  Image image(V(gridn, gridn));
+  resample_signal(image, rmap, param_mesh, bbox, rotate_frame);
 
   image.write_file(image_name);
   nooutput = true;
@@ -1792,6 +1885,7 @@ int main(int argc, const char** argv) {
   HH_ARGSD(remesh, ": resample mesh and triangulate");
   HH_ARGSD(signal, "l : select G, N, or C");
   HH_ARGSP(feather_texture, "bool : blend across texture border discontinuities");
+  HH_ARGSP(cache_resample_map, "bool : save/reuse texel->surface map as param_file.*.rmap");
   HH_ARGSD(write_texture, "image : resample signal as texturemap (dual sampling)");
   HH_ARGSD(write_primal_texture, "image : resample signal as texturemap (primal sampling)");
   HH_ARGSD(write_lonlat_texture, "image : resample signal as (lon, lat) texture");
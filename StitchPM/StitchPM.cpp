@@ -1,10 +1,18 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include <mutex>    // std::mutex, std::lock_guard
+#include <sstream>  // std::ostringstream
+#include <thread>   // std::thread
+
 #include "libHh/Args.h"
+#include "libHh/BinaryIO.h"
 #include "libHh/FileIO.h"
 #include "libHh/GMesh.h"
-#include "libHh/Matrix.h"
+#include "libHh/Image.h"
+#include "libHh/MeshOp.h"  // Vnors
 #include "libHh/PMesh.h"
+#include "libHh/Parallel.h"
 #include "libHh/Stat.h"
+#include "libHh/StringOp.h"  // get_path_extension()
 #include "libHh/Timer.h"
 using namespace hh;
 
@@ -15,39 +23,200 @@ int blockx;
 int blocky;
 int blocks;
 
-Matrix<PMesh> pmeshes;
-PMesh pmesh;
-
-void read_pms() {
-  pmeshes.init(blockx, blocky);
-  for_int(bx, blockx) {
-    for_int(by, blocky) {
-      string filename = sform("%s.x%d.y%d.pm", rootname.c_str(), bx, by);
-      RFile fi(filename);
-      if (!bx && !by) {
-        for (string line; fi().peek() == '#';) {
-          assertx(my_getline(fi(), line));
-          if (line.size() > 1) showff("|%s\n", line.substr(2).c_str());
-        }
-      }
-      pmeshes[bx][by].read(fi());
-    }
+int window = 0;  // Number of tiles read concurrently; 0 means the number of threads.
+
+string heightfield;       // Float grid (as written by "Filterimage -tofloats") or elevation image, for -create.
+float zscale = 1.f;       // For an elevation image, scale applied to the pixel values (0..255).
+string simplify_args;     // Additional MeshSimplify arguments for the simplification of each block.
+int jobs = 0;             // Number of concurrent block simplifications; 0 means the number of threads.
+float memory = 0.f;       // Memory budget in megabytes; 0 means the available memory.
+string program_directory;  // Directory of this executable, in which MeshSimplify etc. are sought first.
+
+// Estimated peak memory per vertex of a block: the block mesh created in this process plus the MeshSimplify
+// process simplifying it; and the tile PM decoded for stitching.  The measured peaks for 64x64 blocks are about
+// 2.4 KB and 30 bytes.  The larger constants allow for allocator overhead and for rougher terrain, whose tiles retain
+// more vertex splits; overestimating only reduces concurrency, whereas underestimating may cause swapping.
+constexpr double k_simplify_bytes_per_vertex = 3000.;
+constexpr double k_stitch_bytes_per_vertex = 100.;
+
+// The tiles are stitched in the order (bx, by) with by varying fastest.  They are streamed twice: first to assemble
+// the stitched base mesh, then to renumber and write out their vertex split records.  At any time, only a window of
+// consecutive tiles is held in memory.
+Vec2<int> tile_coordinates(int t) { return V(t / blocky, t % blocky); }
+
+string tile_filename(int t) {
+  const auto [bx, by] = tile_coordinates(t);
+  return sform("%s.x%d.y%d.pm", rootname.c_str(), bx, by);
+}
+
+// Return the number (at most num) of concurrent units of work, each requiring unit_bytes, that fit in the memory
+// budget after reserved_bytes.
+int num_within_budget(int num, double unit_bytes, double reserved_bytes = 0.) {
+  const double budget = memory ? memory * double(1 << 20) : double(available_memory());
+  if (!budget) return num;  // Unknown available memory.
+  const int max_num = int(min((budget - reserved_bytes) / unit_bytes, double(num)));
+  if (max_num < 1) Warning("Memory budget is insufficient for a single tile");
+  return max(max_num, 1);
+}
+
+// Apply func(t, tile_data) to each tile t in order, where the tile_data are produced concurrently by read(t) over a
+// sliding window of consecutive tiles.
+template <typename TileData, typename Read, typename Func> void stream_tiles(Read read, Func func) {
+  const int num_tiles = blockx * blocky;
+  const int window_size =
+      window ? window : num_within_budget(get_max_threads(), k_stitch_bytes_per_vertex * square(blocks + 1.));
+  assertx(window_size > 0);
+  Array<TileData> tile_data;
+  for (int t0 = 0; t0 < num_tiles; t0 += window_size) {
+    const int num = min(window_size, num_tiles - t0);
+    tile_data.init(num);
+    parallel_for_each(range(num), [&](const int i) { tile_data[i] = read(t0 + i); });
+    for_int(i, num) func(t0 + i, tile_data[i]);
   }
-  // Other assertions
-  for_int(bx, blockx) {
-    for_int(by, blocky) {
-      const PMesh& pmxy = pmeshes[bx][by];
-      const AWMesh& bmeshxy = pmxy._base_mesh;
-      // Assert all vertices have one wedge.
-      for_int(wi, bmeshxy._wedges.num()) assertx(bmeshxy._wedges[wi].vertex == wi);
-      // Assert that we have all info.
-      assertx(pmxy._info._full_nvertices);
-      assertx(pmxy._info._full_nwedges);
-      assertx(pmxy._info._full_nfaces);
+}
+
+// Reader of the successive rows of a height field.  A float grid is read incrementally, so that only the rows of the
+// current band of blocks are held in memory; an image is necessarily decoded entirely.
+class HeightFieldReader {
+ public:
+  explicit HeightFieldReader(const string& filename) {
+    if (to_lower(get_path_extension(filename)) == "floats") {
+      _fi = make_unique<RFile>(filename);
+      Vec2<float> fdims;  // Grid dimensions (x, y).
+      assertx(read_binary_std((*_fi)(), fdims.view()));
+      _dims = convert<int>(fdims).rev();
+    } else {
+      const Image image(filename);
+      _image_heights.init(image.dims());
+      for_int(y, image.ysize()) for_int(x, image.xsize()) _image_heights[y][x] = image[y][x][0] * zscale;
+      _dims = _image_heights.dims();
     }
+    assertx(min(_dims) >= 2);
+  }
+  const Vec2<int>& dims() const { return _dims; }  // (ny, nx).
+  double resident_bytes() const { return double(_image_heights.size()) * sizeof(float); }  // Held until destroyed.
+  void read_row(ArrayView<float> row) {
+    assertx(row.num() == _dims[1] && _y < _dims[0]);
+    if (_fi)
+      assertx(read_binary_std((*_fi)(), row));
+    else
+      row.assign(_image_heights[_y]);
+    _y++;
+  }
+
+ private:
+  unique_ptr<RFile> _fi;
+  Matrix<float> _image_heights;
+  Vec2<int> _dims;
+  int _y{0};
+};
+
+// Create the mesh of a block of the height field, with the vertex order of "Filterimage -blocks s -bx x -by y
+// -tomesh" (the 4 * s boundary vertices first, as expected by compute_nvi()) and with the vertex normals of
+// "Filtermesh -assign_normals".  The grid spacing is uniform, such that the larger side of the height field spans
+// [0, 1].
+void create_block_mesh(int t, CMatrixView<float> heights, float spacing, GMesh& mesh) {
+  const auto [bx, by] = tile_coordinates(t);
+  const int n = blocks + 1;
+  assertx(heights.dims() == twice(n));
+  Matrix<Vertex> verts(n, n);
+  const auto assign_vertex = [&](int y, int x) {
+    verts[y][x] = mesh.create_vertex();
+    const Vec2<int> yx = V(by, bx) * blocks + V(y, x);
+    mesh.set_point(verts[y][x], Point(yx[1] * spacing, yx[0] * spacing, heights[y][x]));
+  };
+  for_int(x, n) assign_vertex(0, x);
+  for_int(x, n) assign_vertex(n - 1, x);
+  for_intL(y, 1, n - 1) assign_vertex(y, 0);
+  for_intL(y, 1, n - 1) assign_vertex(y, n - 1);
+  for_intL(y, 1, n - 1) for_intL(x, 1, n - 1) assign_vertex(y, x);
+  const string sblock = sform("block=\"x%dy%d\"", bx, by);
+  for_int(y, n - 1) for_int(x, n - 1) {
+    mesh.set_string(mesh.create_face(verts[y][x], verts[y + 1][x + 1], verts[y + 1][x]), sblock.c_str());
+    mesh.set_string(mesh.create_face(verts[y][x], verts[y][x + 1], verts[y + 1][x + 1]), sblock.c_str());
+  }
+  string str;
+  for (Vertex v : mesh.vertices()) mesh.update_string(v, "normal", csform_vec(str, Vnors(mesh, v).unique_nor()));
+}
+
+// Name of a program of this package, preferably located alongside this executable.
+string program_path(const string& name) {
+  const string path = program_directory + "/" + name;
+  return program_directory != "" && (file_exists(path) || file_exists(path + ".exe")) ? path : name;
+}
+
+// Simplify the block mesh into the tile PM, as in "meshtopm.sh -vsgeom -terrain -no_simp_bnd", keeping the block
+// boundary vertices in the base mesh so that the tiles can be stitched.
+void simplify_block(int t, const GMesh& mesh) {
+  const TmpFile tmp_mesh("m"), tmp_prog("prog"), tmp_base("base.m"), tmp_rprog("rprog"), tmp_log("log");
+  {
+    WFile fo(tmp_mesh.filename());
+    mesh.write(fo());
+  }
+  const auto quote = [](const string& s) { return quote_arg_for_shell(s); };
+  const string command =
+      (program_path("MeshSimplify") + " " + quote(tmp_mesh.filename()) + " -vsgeom -terrain -no_simp_bnd " +
+       simplify_args + " -prog " + quote(tmp_prog.filename()) + " -simplify >" + quote(tmp_base.filename()) +
+       " && " + program_path("reverselines") + " " + quote(tmp_prog.filename()) + " >" +
+       quote(tmp_rprog.filename()) + " && " + program_path("Filterprog") + " -fbase " + quote(tmp_base.filename()) +
+       " -fprog " + quote(tmp_rprog.filename()) + " -pm >" + quote(tile_filename(t)));
+  if (my_sh("(" + command + ") 2>" + quote(tmp_log.filename())) != 0) {
+    tmp_log.write_to(std::cerr);
+    assertnever("Simplification of tile " + tile_filename(t) + " failed");
   }
 }
 
+// Split the height field into blocks, and simplify them into the tile PMs using concurrent MeshSimplify processes.
+// The height field is read sequentially, one band of blocks at a time.  Each worker thread claims the next block in
+// band order, copies its heights (reading the next band if necessary), and runs the simplification.  The number of
+// concurrent simplifications is limited by the memory budget.
+void do_create() {
+  assertx(heightfield != "" && rootname != "" && blocks > 0);
+  HeightFieldReader reader(heightfield);
+  const Vec2<int> dims = reader.dims();
+  const Vec2<int> num_blocks = (dims - 1) / blocks;  // (blocky, blockx).
+  if (num_blocks * blocks + 1 != dims) Warning("Height field is cropped to a whole number of blocks");
+  assertx(min(num_blocks) > 0);
+  assertx(!blockx || blockx == num_blocks[1]);
+  assertx(!blocky || blocky == num_blocks[0]);
+  blockx = num_blocks[1], blocky = num_blocks[0];
+  const int num_tiles = blockx * blocky;
+  const float spacing = 1.f / (max(dims) - 1);
+  const double band_bytes = (blocks + 1.) * dims[1] * sizeof(float);
+  const int num_jobs = num_within_budget(min(jobs ? jobs : get_max_threads(), num_tiles),
+                                         k_simplify_bytes_per_vertex * square(blocks + 1.),
+                                         band_bytes + reader.resident_bytes());
+  showdf("Creating %dx%d tiles of size %d using %d concurrent simplifications\n", blockx, blocky, blocks, num_jobs);
+  std::mutex mutex;
+  int next_block = 0;                 // In band order, i.e. by * blockx + bx.
+  Matrix<float> band(blocks + 1, dims[1]);  // Rows [by * blocks, (by + 1) * blocks] of the height field.
+  int band_by = -1;
+  const auto worker = [&] {
+    for (;;) {
+      int t;
+      Matrix<float> heights(twice(blocks + 1));
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (next_block == num_tiles) break;
+        const int by = next_block / blockx, bx = next_block % blockx;
+        next_block++;
+        for (; band_by < by; band_by++) {  // The blocks are claimed in band order, so the bands advance in order.
+          if (band_by >= 0) band[0].assign(band[blocks]);
+          for_intL(y, band_by >= 0 ? 1 : 0, blocks + 1) reader.read_row(band[y]);
+        }
+        for_int(y, blocks + 1) heights[y].assign(band[y].slice(bx * blocks, (bx + 1) * blocks + 1));
+        t = bx * blocky + by;
+      }
+      GMesh mesh;
+      create_block_mesh(t, heights, spacing, mesh);
+      simplify_block(t, mesh);
+    }
+  };
+  Array<std::thread> threads;
+  for_int(i, num_jobs) threads.push(std::thread(worker));
+  for (std::thread& thread : threads) thread.join();
+}
+
 int compute_nvi(int bx, int by, int vi) {
   int x, y;
   if (vi <= blocks) {
@@ -102,35 +271,61 @@ int compute_nvi(int bx, int by, int vi) {
   }
 }
 
+struct TileBase {
+  PMeshInfo info;
+  AWMesh base_mesh;
+  Array<string> comments;  // Header comment lines of the first tile.
+};
+
+TileBase read_tile_base(int t) {
+  TileBase tile;
+  RFile fi(tile_filename(t));
+  if (!t) {
+    for (string line; fi().peek() == '#';) {
+      assertx(my_getline(fi(), line));
+      if (line.size() > 1) tile.comments.push(line.substr(2));
+    }
+  }
+  PMeshRStream pmrs(fi());
+  pmrs.read_base_mesh(&tile.base_mesh);
+  tile.info = pmrs._info;
+  // Assert all vertices have one wedge.
+  for_int(wi, tile.base_mesh._wedges.num()) assertx(tile.base_mesh._wedges[wi].vertex == wi);
+  // Assert that we have all info.
+  assertx(tile.info._full_nvertices);
+  assertx(tile.info._full_nwedges);
+  assertx(tile.info._full_nfaces);
+  return tile;
+}
+
+// Read the tile and return its vertex split records, renumbered and serialized for the stitched PMesh.
+string read_tile_vsplits(int t, int base_face_offset, int face_offset, const PMeshInfo& pminfo) {
+  RFile fi(tile_filename(t));
+  PMeshRStream pmrs(fi());
+  int nfaces = pmrs.base_mesh()._faces.num();
+  Array<int> f_renumber(pmrs._info._full_nfaces);  // [old_face_id] -> new_face_id
+  for_int(f, nfaces) f_renumber[f] = base_face_offset + f;
+  std::ostringstream oss;
+  int nvsplits = 0;
+  while (const Vsplit* pvspl = pmrs.next_vsplit()) {
+    Vsplit vspl = *pvspl;
+    vspl.flclw = f_renumber[vspl.flclw];
+    for_int(count, vspl.adds_two_faces() ? 2 : 1) f_renumber[nfaces++] = face_offset++;
+    vspl.write(oss, pminfo);
+    nvsplits++;
+  }
+  assertx(nfaces == pmrs._info._full_nfaces);
+  assertx(nvsplits == pmrs._info._tot_nvsplits);
+  return std::move(oss).str();
+}
+
 void do_stitch() {
   assertx(blockx > 0 && blocky > 0 && blocks > 0);
-  read_pms();
+  const int num_tiles = blockx * blocky;
+  PMesh pmesh;
   // First, construct stitched base mesh.
   AWMesh& bmesh = pmesh._base_mesh;
-  Matrix<int> m_basematid;  // [bx][by] -> first matid in base mesh
-  m_basematid.init(blockx, blocky);
-  assertx(!bmesh._materials.num());
-  string str;
-  for_int(bx, blockx) {
-    for_int(by, blocky) {
-      const PMesh& pmxy = pmeshes[bx][by];
-      const AWMesh& bmeshxy = pmxy._base_mesh;
-      m_basematid[bx][by] = bmesh._materials.num();
-      for_int(matid, bmeshxy._materials.num()) {
-        string s = bmeshxy._materials.get(matid);
-        int nmatid = bmesh._materials.num();
-        s = GMesh::string_update(s, "matid", csform(str, "%d", nmatid));
-        if (!GMesh::string_has_key(s.c_str(), "rgb")) {
-          int odd = (bx + by) % 2;
-          Vector rgb(.6f + .2f * odd, .6f + .2f * !odd, .6f);
-          s = GMesh::string_update(s, "rgb", csform_vec(str, rgb));
-        }
-        bmesh._materials.set(nmatid, s);
-      }
-    }
-  }
-  Matrix<Array<int>> f_renumber;  // [bx][by][old_face_id] -> new_face_id
-  f_renumber.init(blockx, blocky);
+  Array<int> tile_base_face_offset(num_tiles), tile_new_faces(num_tiles);
   // Vertices of stitched base mesh are numbered as:
   // - first, (blocky + 1) rows of length (blockx * blocks + 1)
   // - next, (blockx + 1) broken columns of length (blocky * (blocks - 1))
@@ -138,85 +333,94 @@ void do_stitch() {
   int tot_bnd_vertices = ((blocky + 1) * (blockx * blocks + 1) + (blockx + 1) * (blocky * (blocks - 1)));
   bmesh._vertices.init(tot_bnd_vertices);
   bmesh._wedges.init(tot_bnd_vertices);
-  for_int(bx, blockx) {
-    for_int(by, blocky) {
-      const PMesh& pmxy = pmeshes[bx][by];
-      const AWMesh& bmeshxy = pmxy._base_mesh;
-      int vertex_offset = bmesh._vertices.num();
-      int nbnd_vertices = 4 * blocks;
-      int nint_vertices = bmeshxy._vertices.num() - nbnd_vertices;
-      bmesh._vertices.add(nint_vertices);
-      bmesh._wedges.add(nint_vertices);
-      f_renumber[bx][by].init(pmxy._info._full_nfaces);
-      for_int(fi, bmeshxy._faces.num()) {
-        int nfi = bmesh._faces.add(1);
-        f_renumber[bx][by][fi] = nfi;
-        for_int(j, 3) {
-          int vi = bmeshxy._faces[fi].wedges[j], nvi;
-          if (vi >= 4 * blocks) {  // vertex internal to block
-            nvi = vertex_offset + vi - (4 * blocks);
-          } else {  // vertex on block boundary
-            nvi = compute_nvi(bx, by, vi);
-          }
-          bmesh._faces[nfi].wedges[j] = nvi;
-          // Next are inefficient (done many times!). ok for now.
-          bmesh._vertices[nvi].attrib = bmeshxy._vertices[vi].attrib;
-          // copy *one* of the normals
-          //  (will have different normals at stitch boundary, so this is inexact!)
-          bmesh._wedges[nvi].attrib = bmeshxy._wedges[vi].attrib;
-        }
-        bmesh._faces[nfi].attrib.matid = bmeshxy._faces[fi].attrib.matid + m_basematid[bx][by];
+  int tot_nvsplits = 0;
+  string str;
+  stream_tiles<TileBase>(read_tile_base, [&](const int t, const TileBase& tile) {
+    const auto [bx, by] = tile_coordinates(t);
+    for (const string& comment : tile.comments) showff("|%s\n", comment.c_str());
+    const AWMesh& bmeshxy = tile.base_mesh;
+    if (!t) pmesh._info = tile.info;  // including _has_*
+    const int basematid = bmesh._materials.num();  // first matid in base mesh
+    for_int(matid, bmeshxy._materials.num()) {
+      string s = bmeshxy._materials.get(matid);
+      int nmatid = bmesh._materials.num();
+      s = GMesh::string_update(s, "matid", csform(str, "%d", nmatid));
+      if (!GMesh::string_has_key(s.c_str(), "rgb")) {
+        int odd = (bx + by) % 2;
+        Vector rgb(.6f + .2f * odd, .6f + .2f * !odd, .6f);
+        s = GMesh::string_update(s, "rgb", csform_vec(str, rgb));
       }
+      bmesh._materials.set(nmatid, s);
     }
-  }
-  for_int(vi, bmesh._vertices.num()) bmesh._wedges[vi].vertex = vi;
-  // Initialize some fields.
-  pmesh._info = pmeshes[0][0]._info;  // including _has_*
-  pmesh._info._full_bbox.clear();
-  pmesh._vsplits.init(0);
-  // Finally, collect together all vertex split records.
-  int pmesh_nvertices = bmesh._vertices.num();
-  int pmesh_nfaces = bmesh._faces.num();
-  for_int(bx, blockx) {
-    for_int(by, blocky) {
-      const PMesh& pmxy = pmeshes[bx][by];
-      int pmxy_nfaces = pmxy._base_mesh._faces.num();
-      for_int(vspli, pmxy._vsplits.num()) {
-        const Vsplit& vspl = pmxy._vsplits[vspli];
-        pmesh._vsplits.push(vspl);
-        pmesh._vsplits.last().flclw = f_renumber[bx][by][vspl.flclw];
-        for_int(count, vspl.adds_two_faces() ? 2 : 1) f_renumber[bx][by][pmxy_nfaces++] = pmesh_nfaces++;
-        pmesh_nvertices++;
-      }
-      assertx(pmxy_nfaces == pmxy._info._full_nfaces);
-      pmesh._info._full_bbox.union_with(pmxy._info._full_bbox);
-      if (1) {  // optional (save memory)
-        f_renumber[bx][by].init(0);
-        pmeshes[bx][by]._base_mesh._vertices.clear();
-        pmeshes[bx][by]._base_mesh._wedges.clear();
-        pmeshes[bx][by]._base_mesh._faces.clear();
-        pmeshes[bx][by]._base_mesh._fnei.clear();
-        pmeshes[bx][by]._vsplits.clear();
+    int vertex_offset = bmesh._vertices.num();
+    int nbnd_vertices = 4 * blocks;
+    int nint_vertices = bmeshxy._vertices.num() - nbnd_vertices;
+    bmesh._vertices.add(nint_vertices);
+    bmesh._wedges.add(nint_vertices);
+    tile_base_face_offset[t] = bmesh._faces.num();
+    tile_new_faces[t] = tile.info._full_nfaces - bmeshxy._faces.num();
+    for_int(fi, bmeshxy._faces.num()) {
+      int nfi = bmesh._faces.add(1);
+      for_int(j, 3) {
+        int vi = bmeshxy._faces[fi].wedges[j], nvi;
+        if (vi >= 4 * blocks) {  // vertex internal to block
+          nvi = vertex_offset + vi - (4 * blocks);
+        } else {  // vertex on block boundary
+          nvi = compute_nvi(bx, by, vi);
+        }
+        bmesh._faces[nfi].wedges[j] = nvi;
+        // Next are inefficient (done many times!). ok for now.
+        bmesh._vertices[nvi].attrib = bmeshxy._vertices[vi].attrib;
+        // copy *one* of the normals
+        //  (will have different normals at stitch boundary, so this is inexact!)
+        bmesh._wedges[nvi].attrib = bmeshxy._wedges[vi].attrib;
       }
+      bmesh._faces[nfi].attrib.matid = bmeshxy._faces[fi].attrib.matid + basematid;
     }
-  }
+    tot_nvsplits += tile.info._tot_nvsplits;
+    if (!t) pmesh._info._full_bbox.clear();
+    pmesh._info._full_bbox.union_with(tile.info._full_bbox);
+  });
+  for_int(vi, bmesh._vertices.num()) bmesh._wedges[vi].vertex = vi;
   // Fill in the PMesh information fields.
-  pmesh._info._tot_nvsplits = pmesh_nvertices - bmesh._vertices.num();
+  const int pmesh_nvertices = bmesh._vertices.num() + tot_nvsplits;
+  pmesh._info._tot_nvsplits = tot_nvsplits;
   pmesh._info._full_nvertices = pmesh_nvertices;
   pmesh._info._full_nwedges = pmesh_nvertices;
+  Array<int> tile_face_offset(num_tiles);  // [t] -> first new_face_id of the faces introduced by its vsplits
+  int pmesh_nfaces = bmesh._faces.num();
+  for_int(t, num_tiles) {
+    tile_face_offset[t] = pmesh_nfaces;
+    pmesh_nfaces += tile_new_faces[t];
+  }
   pmesh._info._full_nfaces = pmesh_nfaces;
-  // Write out stitched PMesh.
-  pmesh.write(std::cout);
+  // Write out stitched PMesh, streaming the vertex split records of each tile.
+  pmesh.write_header_and_base_mesh(std::cout);
+  const PMeshInfo& pminfo = pmesh._info;
+  stream_tiles<string>(
+      [&](const int t) { return read_tile_vsplits(t, tile_base_face_offset[t], tile_face_offset[t], pminfo); },
+      [&](int, const string& vsplits) { std::cout.write(vsplits.data(), vsplits.size()); });
+  PMesh::write_trailer(std::cout);
 }
 
 }  // namespace
 
 int main(int argc, const char** argv) {
+  const string argv0 = argv[0];
+  if (argv0.find_first_of("/\\") != string::npos) program_directory = get_path_head(argv0);
   ParseArgs args(argc, argv);
   HH_ARGSP(rootname, "rootname : prefix of PM files (*.x0.y0.pm)");
   HH_ARGSP(blockx, "nx : number of blocks along x axis");
   HH_ARGSP(blocky, "ny : number of blocks along y axis");
   HH_ARGSP(blocks, "n : block size (num_vertices - 1 per side)");
+  HH_ARGSP(window, "n : number of tiles read concurrently (default: number of threads)");
+  HH_ARGSC("", ":");
+  HH_ARGSP(heightfield, "file : height field grid (*.floats) or elevation image to split into tiles");
+  HH_ARGSP(zscale, "fac : for an elevation image, scale pixel values");
+  HH_ARGSP(simplify_args, "'args' : additional MeshSimplify arguments for each tile (e.g. '-mresid 1e-3')");
+  HH_ARGSP(jobs, "n : number of concurrent tile simplifications (default: number of threads)");
+  HH_ARGSP(memory, "mb : memory budget in megabytes (default: available memory)");
+  HH_ARGSD(create, ": split the height field into blocks and simplify each into a tile PM");
   HH_ARGSD(stitch, ": stitch the PM's together");
   showdf("%s", args.header().c_str());
   HH_TIMER("StitchPM");
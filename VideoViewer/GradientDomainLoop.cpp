@@ -704,7 +704,8 @@ void solve_using_offsets(const Vec3<int>& odims, const string& video_filename, C
       for_int(f, onf) integrally_downscale_Nv12_to_Image(video_nv12[f], hvideo[f]);
     } else {
       const bool use_nv12 = true;
-      RVideo rvideo(video_filename, use_nv12);  // note that attrib() should already be set in pwvideo
+      // Note that attrib() should already be set in pwvideo.
+      RVideo rvideo(video_filename, use_nv12, RVideo::k_default_prefetch);
       assertx(rvideo.spatial_dims() == sdims);
       Nv12 frame(sdims);
       ConsoleProgress cprogress("Read and scale down");
@@ -716,7 +717,7 @@ void solve_using_offsets(const Vec3<int>& odims, const string& video_filename, C
       }
       for_int(f, onf) {
         cprogress.update(float(f) / onf);
-        assertx(rvideo.read(frame));
+        assertx(rvideo.read_swap(frame));
         const int DSh = DS / 2;
         assertx(DS == 1 || DSh * 2 == DS);
         integrally_downscale_Nv12_to_Image(frame, hvideo[f]);
@@ -986,7 +987,8 @@ void solve_using_offsets(const Vec3<int>& odims, const string& video_filename, C
             showf(" stream %d (%d of %d for period[%d]==%-3d): input %-3d->%-3d (%d)\n",  //
                   si, streami, nstreams, pi, period, rvideo_fi[si], fi, fi - rvideo_fi[si]);
           if (fi >= 0 && fi < rvideo_fi[si]) {
-            prvideos[si] = make_unique<RVideo>(video_filename, use_nv12);  // open or re-open at beginning
+            // Open or re-open at beginning; prefetch a few frames to overlap decoding across the streams.
+            prvideos[si] = make_unique<RVideo>(video_filename, use_nv12, 2);
             rvideo_fi[si] = -1;
           }
           while (rvideo_fi[si] < fi) {
@@ -996,7 +998,7 @@ void solve_using_offsets(const Vec3<int>& odims, const string& video_filename, C
               continue;
             }
             if (verbose >= 3) showf("  reading stream frame %d\n", rvideo_fi[si]);
-            assertx(prvideos[si]->read(rvideoframes[si]));
+            assertx(prvideos[si]->read_swap(rvideoframes[si]));
           }
         }
       }
@@ -1044,8 +1046,8 @@ void solve_using_offsets(const Vec3<int>& odims, const string& video_filename, C
           }
         }
       });
-      if (pwvideo) pwvideo->write(sframe);
       if (videoloop.size()) convert_Nv12_to_Image(sframe, videoloop[f]);
+      if (pwvideo) pwvideo->write_swap(sframe);  // Every pixel of sframe is overwritten in the next frame.
     }
   }
 }
@@ -0,0 +1,87 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_BENCH_BENCH_H_
+#define MESH_PROCESSING_BENCH_BENCH_H_
+
+#include <algorithm>  // sort()
+
+#include "libHh/Array.h"
+#include "libHh/Timer.h"
+
+#if 0
+{
+  Bench bench;
+  bench.run("Pqueue.enter_remove_min", [&] { ... }, num_items);
+  bench.run_with_setup("Mesh.collapse_edge", [&] { mesh = make_mesh(); }, [&] { ... }, num_items);
+}
+#endif
+
+namespace hh {
+
+// Microbenchmark harness: each benchmark is repeated until its total measured time reaches getenv("HH_BENCH_SECONDS")
+// (default .5 sec), and a single line of JSON with the timing statistics of its repetitions is written to stdout.
+// The statistics include "median_s", the median time in seconds of one repetition, and "relative", the ratio of
+// that median to the median time of a fixed reference workload measured in the same process.  ./bench_compare
+// compares the relative times against a stored baseline, so that the baseline is largely independent of the speed
+// of the machine.
+class Bench {
+ public:
+  Bench() {
+    my_setenv("SHOW_STATS", "-2");
+    my_setenv("SHOW_TIMES", "-1");
+    Timer::set_show_times(-1);
+    _reference_s = median(measure([] {}, reference_workload));
+  }
+  // Time func() for each repetition; num_items (if nonzero) is the number of operations performed per repetition.
+  template <typename Func> void run(const string& name, Func func, int64_t num_items = 0) {
+    run_with_setup(name, [] {}, func, num_items);
+  }
+  // Same, but setup() is called (untimed) before each repetition.
+  template <typename Setup, typename Func>
+  void run_with_setup(const string& name, Setup setup, Func func, int64_t num_items = 0) {
+    const Array<double> times = measure(setup, func);
+    double sum = 0.;
+    for (const double time : times) sum += time;
+    const double median_s = median(times);
+    string s = sform("{\"name\": \"%s\", \"reps\": %d, \"min_s\": %.6g, \"median_s\": %.6g, \"mean_s\": %.6g",
+                     name.c_str(), times.num(), times[0], median_s, sum / times.num());
+    if (num_items) s += sform(", \"items\": %lld, \"items_per_s\": %.6g", (long long)num_items, num_items / median_s);
+    s += sform(", \"relative\": %.6g", median_s / _reference_s);
+    std::cout << s << "}" << std::endl;
+  }
+
+ private:
+  static constexpr int k_min_reps = 3, k_max_reps = 10'000;
+  const double _min_seconds = getenv_float("HH_BENCH_SECONDS", .5f);
+  double _reference_s;  // Median time of reference_workload().
+
+  // Return the sorted times of the repetitions.
+  template <typename Setup, typename Func> Array<double> measure(Setup setup, Func func) const {
+    setup(), func();  // Warm-up repetition.
+    Array<double> times;
+    double sum = 0.;
+    while ((sum < _min_seconds || times.num() < k_min_reps) && times.num() < k_max_reps) {
+      setup();
+      const int64_t counter_start = get_precise_counter();
+      func();
+      times.push(double(get_precise_counter() - counter_start) * get_seconds_per_counter());
+      sum += times.last();
+    }
+    std::sort(times.begin(), times.end());
+    return times;
+  }
+  static double median(CArrayView<double> sorted_times) { return sorted_times[sorted_times.num() / 2]; }
+  // A fixed mix of arithmetic, branching, and memory accesses: sort pseudorandom integers.
+  static void reference_workload() {
+    const int num = 100'000;
+    Array<unsigned> values(num);
+    unsigned state = 1;
+    for (unsigned& value : values) value = state = state * 1664525u + 1013904223u;
+    std::sort(values.begin(), values.end());
+    static volatile unsigned sink;
+    sink = values[num / 2];
+  }
+};
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_BENCH_BENCH_H_
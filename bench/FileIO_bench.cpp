@@ -0,0 +1,35 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/FileIO.h"
+#include "libHh/StringOp.h"
+using namespace hh;
+
+namespace {
+
+int64_t g_sink;
+
+// Write and read back a compressed text file similar to a mesh file.
+void bench_gzip(Bench& bench) {
+  const int num_lines = 200'000;
+  string s;
+  for_int(i, num_lines) s += sform("Vertex %d  %g %g %g\n", i + 1, i * .25, i * .5, i * .75);
+  TmpFile tmp_file("gz");
+  bench.run(
+      "FileIO.gzip_write", [&] { WFile(tmp_file.filename())() << s; }, num_lines);
+  bench.run(
+      "FileIO.gzip_read",
+      [&] {
+        RFile fi(tmp_file.filename());
+        string line;
+        while (my_getline(fi(), line)) g_sink += line.size();
+      },
+      num_lines);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_gzip(bench);
+  return 0;
+}
@@ -0,0 +1,52 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/FlatHash.h"
+#include "libHh/Map.h"
+#include "libHh/Random.h"
+#include "libHh/Set.h"
+#include "libHh/Univ.h"
+using namespace hh;
+
+namespace {
+
+int64_t g_sink;
+
+// Insert keys, look up present and absent keys, and remove all keys, as in the id maps of Mesh.
+template <typename MapT> void bench_map(Bench& bench, const string& name) {
+  const int num = 200'000;
+  Random random(1);
+  Array<int> keys(num);
+  for (int& key : keys) key = int(random.get_unsigned(1u << 30));
+  bench.run(
+      name + ".enter_retrieve_remove",
+      [&] {
+        MapT map;
+        for_int(i, num) map[keys[i]] = i;
+        for (const int key : keys) g_sink += map.retrieve(key) + map.retrieve(key + 1);
+        for (const int key : keys) g_sink += map.remove(key);
+      },
+      num);
+}
+
+// Add elements with many duplicates, as in the visited sets of Spatial searches.
+template <typename SetT> void bench_set(Bench& bench, const string& name) {
+  const int num = 200'000;
+  bench.run(
+      name + ".add",
+      [&] {
+        SetT set;
+        for_int(i, num) g_sink += set.add(Conv<int>::e((i * 7) % (num / 4)));
+      },
+      num);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_map<Map<int, int>>(bench, "Map");
+  bench_map<FlatMap<int, int>>(bench, "FlatMap");
+  bench_set<Set<Univ>>(bench, "Set");
+  bench_set<FlatSet<Univ>>(bench, "FlatSet");
+  return 0;
+}
@@ -0,0 +1,89 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/GridOp.h"
+#include "libHh/Image.h"
+#include "libHh/Random.h"
+using namespace hh;
+
+namespace {
+
+double g_sink;
+
+void bench_scale(Bench& bench) {
+  Image image(V(2048, 2048));
+  Random random(1);
+  for (Pixel& pix : image) pix = Pixel(uint8_t(random.get_unsigned(256)), uint8_t(random.get_unsigned(256)), 128, 255);
+  const auto filterbs = twice(FilterBnd(Filter::get("spline"), Bndrule::reflected));
+  bench.run(
+      "Image.scale_down",
+      [&] {
+        const Image newimage = scale(image, twice(.37f), filterbs);
+        g_sink += newimage[0][0][0];
+      },
+      image.size());
+  bench.run(
+      "Image.scale_up",
+      [&] {
+        const Image newimage = scale(image, twice(1.3f), filterbs);
+        g_sink += newimage[0][0][0];
+      },
+      image.size());
+}
+
+// Blur with a large radius, whose cost per pixel should be independent of the radius.
+void bench_blur(Bench& bench) {
+  Image image(V(1024, 1024));
+  Random random(1);
+  for (Pixel& pix : image) pix = Pixel(uint8_t(random.get_unsigned(256)), uint8_t(random.get_unsigned(256)), 128, 255);
+  for (const float sdv : {4.f, 50.f}) {
+    bench.run(
+        sform("Image.gaussian_blur_%g", sdv),
+        [&] {
+          Grid<2, Pixel> grid = gaussian_blur_d(image, 0, sdv, Bndrule::reflected);
+          grid = gaussian_blur_d(grid, 1, sdv, Bndrule::reflected);
+          g_sink += grid[0][0][0];
+        },
+        image.size());
+  }
+}
+
+// Convert a 1080p video frame between RGBA and NV12 (YUV 4:2:0), as done for each frame in video I/O.
+void bench_nv12(Bench& bench) {
+  Image image(V(1080, 1920));
+  Random random(1);
+  for (Pixel& pix : image)
+    pix = Pixel(uint8_t(random.get_unsigned(256)), uint8_t(random.get_unsigned(256)),
+                uint8_t(random.get_unsigned(256)), 255);
+  Nv12 nv12(image.dims());
+  bench.run(
+      "Image.rgba_to_nv12",
+      [&] {
+        convert_Image_to_Nv12(image, nv12);
+        g_sink += nv12.get_Y()[0][0];
+      },
+      image.size());
+  bench.run(
+      "Image.nv12_to_rgba",
+      [&] {
+        convert_Nv12_to_Image(nv12, image);
+        g_sink += image[0][0][0];
+      },
+      image.size());
+  bench.run(
+      "Image.nv12_to_bgra",
+      [&] {
+        convert_Nv12_to_Image_BGRA(nv12, image);
+        g_sink += image[0][0][0];
+      },
+      image.size());
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_scale(bench);
+  bench_blur(bench);
+  bench_nv12(bench);
+  return 0;
+}
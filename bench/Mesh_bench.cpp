@@ -0,0 +1,143 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include <sstream>
+
+#include "bench/Bench.h"
+#include "libHh/GMesh.h"
+#include "libHh/Matrix.h"
+#include "libHh/MeshOp.h"
+#include "libHh/MeshSearch.h"
+#include "libHh/Random.h"
+using namespace hh;
+
+namespace {
+
+double g_sink;  // Keeps the traversals from being optimized away.
+
+// Triangulated n x n grid over a smooth height field.  Vertices and faces are created in a random order, so that
+// consecutive ids (and allocations) are scattered across the surface as in meshes produced by editing operations.
+GMesh make_grid_mesh(int n) {
+  Random random(1);
+  GMesh mesh;
+  Matrix<Vertex> matv(n, n);
+  Array<int> order(n * n);
+  for_int(i, order.num()) order[i] = i;
+  shuffle(order, random);
+  for (const int i : order) {
+    const int y = i / n, x = i % n;
+    Vertex v = mesh.create_vertex();
+    matv[y][x] = v;
+    const float u = x / (n - 1.f), w = y / (n - 1.f);
+    mesh.set_point(v, Point(u, w, .1f * std::sin(u * 7.f) * std::cos(w * 5.f)));
+  }
+  order.init((n - 1) * (n - 1));
+  for_int(i, order.num()) order[i] = i;
+  shuffle(order, random);
+  for (const int i : order) {
+    const int y = i / (n - 1), x = i % (n - 1);
+    mesh.create_face(matv[y][x], matv[y + 1][x], matv[y + 1][x + 1]);
+    mesh.create_face(matv[y][x], matv[y + 1][x + 1], matv[y][x + 1]);
+  }
+  return mesh;
+}
+
+// Visit the vertices and adjacent faces of all faces, in face-id order.
+void traverse(const GMesh& mesh, CArrayView<Face> faces) {
+  double sum = 0.;
+  for (Face f : faces) {
+    for (Vertex v : mesh.vertices(f)) sum += mesh.point(v)[2];
+    for (Face f2 : mesh.faces(f)) sum += mesh.face_id(f2);
+  }
+  g_sink += sum;
+}
+
+void bench_traversal(Bench& bench) {
+  GMesh mesh = make_grid_mesh(400);
+  Array<Face> faces(mesh.ordered_faces());
+  bench.run("Mesh.traverse", [&] { traverse(mesh, faces); }, faces.num());
+  reorder_for_locality(mesh);
+  faces = Array<Face>(mesh.ordered_faces());
+  bench.run("Mesh.traverse_after_reorder_for_locality", [&] { traverse(mesh, faces); }, faces.num());
+}
+
+void bench_collapse_edge(Bench& bench) {
+  const int n = 150, num_collapses = n * n / 4;
+  GMesh mesh;
+  bench.run_with_setup(
+      "Mesh.collapse_edge", [&] { mesh = make_grid_mesh(n); },
+      [&] {
+        int ncollapsed = 0;
+        for (int i = 1; ncollapsed < num_collapses; i++) {
+          assertx(i <= n * n);
+          Vertex v = mesh.id_retrieve_vertex(i);
+          if (!v) continue;
+          for (Edge e : mesh.edges(v)) {
+            if (!mesh.nice_edge_collapse(e)) continue;
+            mesh.collapse_edge(e);
+            ncollapsed++;
+            break;
+          }
+        }
+      },
+      num_collapses);
+}
+
+void bench_clear(Bench& bench) {
+  const int n = 200;
+  GMesh mesh;
+  bench.run_with_setup(
+      "Mesh.clear", [&] { mesh = make_grid_mesh(n); }, [&] { mesh.clear(); }, 2 * (n - 1) * (n - 1));
+}
+
+void bench_read_write(Bench& bench) {
+  const GMesh mesh = make_grid_mesh(200);
+  string str;
+  {
+    std::ostringstream oss;
+    mesh.write(oss);
+    str = oss.str();
+  }
+  bench.run(
+      "GMesh.read",
+      [&] {
+        std::istringstream iss(str);
+        GMesh mesh2;
+        mesh2.read(iss);
+        g_sink += mesh2.num_faces();
+      },
+      mesh.num_faces());
+  bench.run(
+      "GMesh.write",
+      [&] {
+        std::ostringstream oss;
+        mesh.write(oss);
+        g_sink += double(oss.tellp());
+      },
+      mesh.num_faces());
+}
+
+void bench_mesh_search(Bench& bench) {
+  const GMesh mesh = make_grid_mesh(200);
+  const MeshSearch mesh_search(mesh, {});
+  const int num_queries = 1'000;
+  Array<Point> points(num_queries);
+  Random random(2);
+  for (Point& p : points) p = Point(random.unif(), random.unif(), random.unif() * .2f - .1f);
+  bench.run(
+      "MeshSearch.search",
+      [&] {
+        for (const Point& p : points) g_sink += mesh_search.search(p, nullptr).d2;
+      },
+      num_queries);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_traversal(bench);
+  bench_collapse_edge(bench);
+  bench_clear(bench);
+  bench_read_write(bench);
+  bench_mesh_search(bench);
+  return 0;
+}
@@ -0,0 +1,30 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include <atomic>
+
+#include "bench/Bench.h"
+#include "libHh/Parallel.h"
+using namespace hh;
+
+namespace {
+
+void bench_dispatch(Bench& bench) {
+  const int num_loops = 100, num_elements = 1'000;
+  std::atomic<int64_t> sum{0};
+  bench.run(
+      "parallel_for_each.dispatch",
+      [&] {
+        for_int(loop, num_loops) parallel_for_each(range(num_elements), [&](const int i) {
+          if (i == loop) sum += i;
+        });
+      },
+      num_loops);
+  assertx(sum > 0);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_dispatch(bench);
+  return 0;
+}
@@ -0,0 +1,35 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/Pool.h"
+using namespace hh;
+
+namespace {
+
+struct Node {
+  Node* next;
+  int64_t data[3];
+  HH_POOL_ALLOCATION(Node);
+};
+
+HH_ALLOCATE_POOL(Node);
+HH_INITIALIZE_POOL(Node);
+
+void bench_pool(Bench& bench) {
+  const int num = 200'000;
+  Array<Node*> nodes(num);
+  bench.run(
+      "Pool.alloc_free",
+      [&] {
+        for_int(i, num) nodes[i] = new Node;
+        for_int(i, num) delete nodes[i];
+      },
+      num);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_pool(bench);
+  return 0;
+}
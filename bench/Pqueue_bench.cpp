@@ -0,0 +1,75 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/Pqueue.h"
+#include "libHh/Random.h"
+using namespace hh;
+
+namespace {
+
+int64_t g_sink;
+
+Array<int> g_pq_index;  // Intrusive index slots for IPqueue.
+struct PqIndex {
+  int& operator()(int i) const { return g_pq_index[i]; }
+};
+
+void bench_pqueue(Bench& bench) {
+  const int num = 100'000;
+  Random random(1);
+  Array<float> priorities(num);
+  for (float& pri : priorities) pri = random.unif();
+  bench.run(
+      "Pqueue.enter_remove_min",
+      [&] {
+        Pqueue<int> pq;
+        for_int(i, num) pq.enter(i, priorities[i]);
+        while (!pq.empty()) g_sink += pq.remove_min();
+      },
+      num);
+  bench.run(
+      "HPqueue.enter_update_remove_min",
+      [&] {
+        HPqueue<int> pq;
+        for_int(i, num) pq.enter(i, priorities[i]);
+        for_int(i, num / 2) pq.update(i * 2, priorities[i]);
+        while (!pq.empty()) g_sink += pq.remove_min();
+      },
+      num);
+  g_pq_index.init(num, 0);
+  bench.run(
+      "IPqueue.enter_update_remove_min",
+      [&] {
+        IPqueue<int, PqIndex> pq;
+        for_int(i, num) pq.enter(i, priorities[i]);
+        for_int(i, num / 2) pq.update(i * 2, priorities[i]);
+        while (!pq.empty()) g_sink += pq.remove_min();
+      },
+      num);
+  bench.run(
+      "HPqueue.sort",
+      [&] {
+        HPqueue<int> pq;
+        for_int(i, num) pq.enter_unsorted(i, priorities[i]);
+        pq.sort();
+        g_sink += pq.min();
+      },
+      num);
+  bench.run(
+      "IPqueue.sort",
+      [&] {
+        IPqueue<int, PqIndex> pq;
+        for_int(i, num) pq.enter_unsorted(i, priorities[i]);
+        pq.sort();
+        g_sink += pq.min();
+        pq.clear();
+      },
+      num);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_pqueue(bench);
+  return 0;
+}
@@ -0,0 +1,71 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#define HH_MULTIGRID_TIMER(name)  // Override before "Multigrid.h".
+#include "bench/Bench.h"
+#include "libHh/Lls.h"
+#include "libHh/Multigrid.h"
+#include "libHh/Random.h"
+using namespace hh;
+
+namespace {
+
+double g_sink;
+
+void bench_multigrid(Bench& bench) {
+  const Vec2<int> dims = twice(513);
+  Grid<2, float> grid_rhs(dims);
+  Random random(1);
+  for (float& v : grid_rhs) v = random.unif() - .5f;
+  unique_ptr<Multigrid<2, float>> multigrid;
+  bench.run_with_setup(
+      "Multigrid.solve",
+      [&] {
+        multigrid = make_unique<Multigrid<2, float>>(dims);
+        fill(multigrid->initial_estimate(), 0.f);
+        multigrid->set_desired_mean(0.);
+        multigrid->rhs().assign(grid_rhs);
+      },
+      [&] {
+        multigrid->solve();
+        g_sink += multigrid->result()[0][0];
+      },
+      product(dims));
+}
+
+// Smooth a noisy 1D signal: each x_i is softly constrained to its sample b_i and to its neighbors.
+void bench_sparse_lls(Bench& bench) {
+  const int n = 20'000, m = n + (n - 1);
+  Random random(2);
+  Array<float> samples(n);
+  for_int(i, n) samples[i] = std::sin(i * .01f) + (random.unif() - .5f) * .3f;
+  unique_ptr<SparseLls> lls;
+  bench.run_with_setup(
+      "SparseLls.solve",
+      [&] {
+        lls = make_unique<SparseLls>(m, n, 1);
+        for_int(i, n) {
+          lls->enter_a_rc(i, i, .2f);
+          lls->enter_b_rc(i, 0, .2f * samples[i]);
+          lls->enter_xest_rc(i, 0, 0.f);
+        }
+        for_int(i, n - 1) {
+          lls->enter_a_rc(n + i, i, 1.f);
+          lls->enter_a_rc(n + i, i + 1, -1.f);
+          lls->enter_b_rc(n + i, 0, 0.f);
+        }
+        lls->set_max_iter(200);
+      },
+      [&] {
+        assertw(lls->solve());
+        g_sink += lls->get_x_rc(0, 0);
+      },
+      n);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_multigrid(bench);
+  bench_sparse_lls(bench);
+  return 0;
+}
@@ -0,0 +1,36 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "bench/Bench.h"
+#include "libHh/Random.h"
+#include "libHh/Spatial.h"
+using namespace hh;
+
+namespace {
+
+double g_sink;
+
+void bench_knn(Bench& bench) {
+  const int num_points = 100'000, num_queries = 2'000, k = 8;
+  Random random(1);
+  Array<Point> points(num_points);
+  for (Point& p : points) p = Point(random.unif(), random.unif(), random.unif());
+  IPointSpatial spatial(40, points);
+  Array<Point> queries(num_queries);
+  for (Point& p : queries) p = Point(random.unif(), random.unif(), random.unif());
+  bench.run(
+      "SpatialSearch.knn8",
+      [&] {
+        for (const Point& p : queries) {
+          SpatialSearch<int> ss(&spatial, p);
+          for_int(i, k) g_sink += ss.next().d2;
+        }
+      },
+      num_queries);
+}
+
+}  // namespace
+
+int main() {
+  Bench bench;
+  bench_knn(bench);
+  return 0;
+}
@@ -386,6 +386,7 @@ void ParseArgs::problem(const string& s) {
   if (_iarg && _iarg - 1 != _icur) mes += " at '" + _args[_iarg - 1] + "'";
   if (_icur >= 0) mes += " when parsing option '" + _args[_icur] + "'";
   if (_curopt && _args[_icur] != _curopt->str) mes += " (interpreted as '" + _curopt->str + "')";
+  if (_throw_on_problem) throw std::runtime_error(mes);
   mes += ".\n";
   std::cerr << mes;
   if (_argv0 != "") {
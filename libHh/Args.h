@@ -111,6 +111,7 @@ class ParseArgs : public Args {
   void other_args_ok() { _other_args_ok = true; }          // Non -* are ok (filenames); after "--", all args ok.
   void other_options_ok() { _other_options_ok = true; }    // Unrecognized -* are ok.
   void disallow_prefixes() { _disallow_prefixes = true; }  // Options implicitly end with '[' if none is present.
+  void throw_on_problem() { _throw_on_problem = true; }    // Errors throw std::runtime_error instead of exiting.
   // Note: usually, other_options_ok() implies that disallow_prefixes() should be set too.
   static bool special_arg(const string& s);  // True if "-?" or "--help" or "--version".
   void print_help();
@@ -135,6 +136,7 @@ class ParseArgs : public Args {
   bool _other_args_ok{false};
   bool _other_options_ok{false};
   bool _disallow_prefixes{false};
+  bool _throw_on_problem{false};
   Array<option> _aroptions;
   const option* _curopt{nullptr};  // Option currently being parsed.
   int _icur{-1};                   // Index of current option in _args.
@@ -3,6 +3,7 @@
 #define MESH_PROCESSING_LIBHH_BOUNDINGSPHERE_H_
 
 #include "libHh/Geometry.h"
+#include "libHh/MathOp.h"  // my_acos()
 
 namespace hh {
 
@@ -34,6 +35,18 @@ inline BoundingSphere bsphere_union(const BoundingSphere& bsphere1, const Boundi
   }
 }
 
+// Given a sphere bounding a set of unit normals, return the half-angle of the cone about the direction of the
+// sphere center that contains all these normals (used for backface culling of a surface region).
+inline float normal_cone_half_angle(const BoundingSphere& nsphere) {
+  const Vector dir_b = nsphere.point;
+  const float mag_b = mag(dir_b);
+  if (!mag_b) return TAU / 2;
+  // cos(theta) == (b ^ 2 + c ^ 2 - a ^ 2) / (2 * b * c)
+  float v = (square(mag_b) + 1.f - square(nsphere.radius)) / (2.f * mag_b);
+  if (v < -1.f) v = -1.f;  // (triangle inequality failed, ok)
+  return my_acos(v);
+}
+
 }  // namespace hh
 
 #endif  // MESH_PROCESSING_LIBHH_BOUNDINGSPHERE_H_
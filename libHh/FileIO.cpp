@@ -41,13 +41,27 @@ HH_REFERENCE_LIB("urlmon.lib");   // URLDownloadToCacheFile()
 #include <ext/stdio_filebuf.h>  // __gnu_cxx::stdio_filebuf<char>
 #endif
 
+// On the unix and cygwin configurations, zlib is linked along with libpng (see make/Makefile_defs), so ".gz" files
+// are (de)compressed in-process rather than through a "gzip" pipe.
+#if !defined(HH_NO_ZLIB) && !defined(HH_NO_IMAGE_LIBS) && !defined(_MSC_VER)
+#define HH_FILEIO_HAVE_ZLIB
+#endif
+
+#if defined(HH_FILEIO_HAVE_ZLIB)
+#include <zlib.h>
+
+#include <condition_variable>
+#include <thread>
+#endif
+
 #include <atomic>
 #include <cctype>   // isalnum()
 #include <cstring>  // memmove()
 #include <fstream>  // ifstream, ofstream
 #include <mutex>    // mutex, lock_guard
 
-#include "libHh/RangeOp.h"  // contains()
+#include "libHh/Parallel.h"  // parallel_for_each(), get_max_threads()
+#include "libHh/RangeOp.h"   // contains()
 #include "libHh/StringOp.h"
 #include "libHh/Vec.h"
 
@@ -217,6 +231,223 @@ class ocfstream : public std::ostream {
 
 #endif  // defined(IO_USE_CFSTREAM)
 
+#if defined(HH_FILEIO_HAVE_ZLIB)
+
+// An implementation of streambuf that decompresses a gzip (or zlib) file, which may contain several concatenated
+// members (e.g., as written by ogzstreambuf or by "pigz").  A separate thread reads and inflates the next few blocks
+// ahead of their use, so that decompression overlaps the parsing of the stream.
+class igzstreambuf : public std::streambuf {
+ public:
+  igzstreambuf(FILE* file) : _file(file), _blocks(k_num_blocks, Array<char>(k_block_size)) {
+    setg(nullptr, nullptr, nullptr);
+    _thread = std::thread([this] { inflate_blocks(); });
+  }
+  ~igzstreambuf() override { stop(); }
+  // Terminate the inflating thread, after which the file is no longer accessed and may be closed.
+  void stop() {
+    if (!_thread.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+  }
+
+ protected:
+  virtual int_type underflow() override {  // Advance to the next inflated block if the current one is consumed.
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_current >= 0) {
+      _num_consumed = _current + 1;
+      _cv.notify_all();
+    }
+    _cv.wait(lock, [&] { return _num_inflated > _num_consumed || _done; });
+    if (_num_inflated == _num_consumed) {
+      if (_error != "") {
+        showdf("gzip decompression: %s\n", _error.c_str());
+        Warning("Error in gzip decompression");
+      }
+      return traits_type::eof();
+    }
+    _current = _num_consumed;
+    Array<char>& block = _blocks[_current % k_num_blocks];
+    const int size = _block_sizes[_current % k_num_blocks];
+    setg(block.data(), block.data(), block.data() + size);
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  static constexpr int k_num_blocks = 4;
+  static constexpr int k_block_size = 256 * 1024;
+  static constexpr int k_input_size = 64 * 1024;
+  FILE* _file;
+  Array<Array<char>> _blocks;      // Ring buffer of inflated blocks.
+  Vec<int, k_num_blocks> _block_sizes;
+  std::thread _thread;
+  std::mutex _mutex;  // Protects the members below.
+  std::condition_variable _cv;
+  int64_t _num_inflated{0};  // Blocks [_num_consumed, _num_inflated) are ready for the reader.
+  int64_t _num_consumed{0};
+  int64_t _current{-1};  // Block currently in the get area.
+  bool _done{false};     // The inflating thread has finished.
+  bool _stop{false};     // The reader is destroyed.
+  string _error;
+  //
+  void inflate_blocks() {
+    z_stream zs = {};
+    assertx(inflateInit2(&zs, 15 + 32) == Z_OK);  // Accept either a gzip or a zlib header.
+    Array<uint8_t> input(k_input_size);
+    bool input_eof = false;
+    string error;
+    for (int64_t i = 0; error == "";) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [&] { return i - _num_consumed < k_num_blocks || _stop; });
+        if (_stop) break;
+      }
+      Array<char>& block = _blocks[i % k_num_blocks];
+      zs.next_out = reinterpret_cast<uint8_t*>(block.data());
+      zs.avail_out = k_block_size;
+      bool stream_end = false;
+      while (zs.avail_out) {
+        if (!zs.avail_in && !input_eof) {
+          zs.next_in = input.data();
+          zs.avail_in = unsigned(fread(input.data(), 1, input.num(), _file));
+          if (!zs.avail_in) input_eof = true;
+        }
+        const int ret = inflate(&zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+          // Continue with the next gzip member, if any.
+          if (!zs.avail_in && !input_eof) {
+            zs.next_in = input.data();
+            zs.avail_in = unsigned(fread(input.data(), 1, input.num(), _file));
+            if (!zs.avail_in) input_eof = true;
+          }
+          if (!zs.avail_in) {
+            stream_end = true;
+            break;
+          }
+          assertx(inflateReset(&zs) == Z_OK);
+        } else if (ret == Z_BUF_ERROR && input_eof) {
+          error = "truncated stream";
+          break;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+          error = zs.msg ? zs.msg : "error " + std::to_string(ret);
+          break;
+        }
+      }
+      const int size = k_block_size - int(zs.avail_out);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _block_sizes[i % k_num_blocks] = size;
+      if (size) _num_inflated = ++i;
+      _cv.notify_all();
+      if (stream_end) break;
+    }
+    inflateEnd(&zs);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _error = error;
+    _done = true;
+    _cv.notify_all();
+  }
+};
+
+// An implementation of streambuf that gzip-compresses into a FILE*.  The output is split into blocks which are
+// compressed concurrently and independently, each as a separate gzip member; the concatenation is still a valid
+// gzip file (as with "pigz --independent").  Flushing the stream does not force out a partial block.
+class ogzstreambuf : public std::streambuf {
+ public:
+  ogzstreambuf(FILE* file) : _file(file) {
+    const int num_blocks = clamp(get_max_threads(), 1, k_max_blocks);
+    _buffer.init(num_blocks * k_block_size);
+    _compressed.init(num_blocks);
+    setp(_buffer.data(), _buffer.data() + _buffer.num());
+  }
+  // Compress the remaining data; return success of all writes.
+  bool finish() {
+    compress_buffer();
+    return _ok;
+  }
+
+ protected:
+  virtual int_type overflow(int_type ch) override {  // The buffer is full.
+    compress_buffer();
+    if (ch != traits_type::eof()) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return _ok ? traits_type::not_eof(ch) : traits_type::eof();
+  }
+  virtual int sync() override { return _ok && fflush(_file) == 0 ? 0 : -1; }
+
+ private:
+  static constexpr int k_block_size = 256 * 1024;
+  static constexpr int k_max_blocks = 16;
+  static constexpr int k_level = 6;  // Same default level as "gzip".
+  FILE* _file;
+  Array<char> _buffer;
+  Array<Array<uint8_t>> _compressed;  // For each block in _buffer.
+  bool _ok{true};
+  //
+  void compress_buffer() {
+    const int size = int(pptr() - pbase());
+    if (!size) return;
+    const int num_blocks = (size + k_block_size - 1) / k_block_size;
+    parallel_for_each(range(num_blocks), [&](const int i) {
+      const int block_size = std::min(size - i * k_block_size, k_block_size);
+      z_stream zs = {};
+      assertx(deflateInit2(&zs, k_level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);  // gzip header.
+      Array<uint8_t>& compressed = _compressed[i];
+      compressed.init(int(deflateBound(&zs, block_size)));
+      zs.next_in = reinterpret_cast<uint8_t*>(_buffer.data() + i * k_block_size);
+      zs.avail_in = block_size;
+      zs.next_out = compressed.data();
+      zs.avail_out = compressed.num();
+      assertx(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+      compressed.resize(compressed.num() - int(zs.avail_out));
+      assertx(deflateEnd(&zs) == Z_OK);
+    });
+    for_int(i, num_blocks) {
+      if (fwrite(_compressed[i].data(), 1, _compressed[i].num(), _file) != size_t(_compressed[i].num())) _ok = false;
+    }
+    setp(_buffer.data(), _buffer.data() + _buffer.num());
+  }
+};
+
+#endif  // defined(HH_FILEIO_HAVE_ZLIB)
+
+bool filename_is_gzip(const string& filename) { return ends_with(filename, ".gz"); }
+
+// Return the command words that decompress a file to stdout, or {} if the file is not decompressed using a pipe.
+Array<string> decompression_command(const string& filename) {
+#if !defined(HH_FILEIO_HAVE_ZLIB)
+  if (filename_is_gzip(filename)) return {"gzip", "-d", "-c"};
+#endif
+  if (ends_with(filename, ".Z")) return {"gzip", "-d", "-c"};  // gzip supports .Z (replacement for zcat).
+  if (ends_with(filename, ".zst")) return {"zstd", "-d", "-c", "-q"};
+  if (ends_with(filename, ".lz4")) return {"lz4", "-d", "-c", "-q"};
+  return {};
+}
+
+// Return the command that compresses stdin into a file, or "" if the file is not compressed using a pipe.
+string compression_command(const string& filename) {
+#if !defined(HH_FILEIO_HAVE_ZLIB)
+  if (filename_is_gzip(filename)) return "gzip";
+#endif
+  if (ends_with(filename, ".Z")) return "compress";
+  if (ends_with(filename, ".zst")) return "zstd -q";
+  if (ends_with(filename, ".lz4")) return "lz4 -q";
+  return "";
+}
+
+FILE* my_fopen(const string& filename, const char* mode) {
+#if defined(_WIN32)
+  return _wfopen(utf16_from_utf8(filename).c_str(), utf16_from_utf8(mode).c_str());
+#else
+  return fopen(filename.c_str(), mode);
+#endif
+}
+
 }  // namespace
 
 // *** RFile::Implementation and WFile::Implementation.
@@ -287,6 +518,46 @@ class WFile::Implementation {
 #error
 #endif
 
+#if defined(HH_FILEIO_HAVE_ZLIB)
+
+class RFile::GzipImplementation {
+ public:
+  explicit GzipImplementation(FILE* file) : _file(file), _buf(file), _istream(&_buf) {}
+  ~GzipImplementation() {
+    _buf.stop();  // The inflating thread may still be reading _file.
+    assertw(!fclose(_file));
+  }
+  std::istream* get_stream() { return &_istream; }
+
+ private:
+  FILE* _file;
+  igzstreambuf _buf;
+  std::istream _istream;
+};
+
+class WFile::GzipImplementation {
+ public:
+  explicit GzipImplementation(FILE* file) : _file(file), _buf(file), _ostream(&_buf) {}
+  ~GzipImplementation() {
+    _ostream.flush();
+    assertw(_buf.finish());
+    assertw(!fclose(_file));
+  }
+  std::ostream* get_stream() { return &_ostream; }
+
+ private:
+  FILE* _file;
+  ogzstreambuf _buf;
+  std::ostream _ostream;
+};
+
+#else
+
+class RFile::GzipImplementation {};
+class WFile::GzipImplementation {};
+
+#endif  // defined(HH_FILEIO_HAVE_ZLIB)
+
 // *** RFile.
 
 RFile::RFile(string filename) {
@@ -311,27 +582,35 @@ RFile::RFile(string filename) {
   if (ends_with(filename, "|")) {
     _file_ispipe = true;
     _file = my_popen(original_filename.substr(0, original_filename.size() - 1), mode);  // No quoting at all.
-  } else if (ends_with(filename, ".gz") || ends_with(filename, ".Z")) {
-    _file_ispipe = true;
-    _file = my_popen(V<string>("gzip", "-d", "-c", filename), mode);  // gzip supports .Z (replacement for zcat).
   } else if (filename == "-") {
     // assertw(!HH_POSIX(isatty)(0));
     _file = stdin;
     _is = &std::cin;
-  } else if (file_exists(filename)) {
-    if (!assertw(!file_exists(filename + ".Z")) || !assertw(!file_exists(filename + ".gz")))
-      showdf("** Using uncompressed version of '%s'\n", filename.c_str());
-#if defined(_WIN32)
-    _file = _wfopen(utf16_from_utf8(filename).c_str(), L"rb");
-#else
-    _file = fopen(filename.c_str(), "rb");
+  } else {
+    if (file_exists(filename)) {
+      if (!filename_is_gzip(filename) && !ends_with(filename, ".Z") &&
+          (!assertw(!file_exists(filename + ".Z")) || !assertw(!file_exists(filename + ".gz"))))
+        showdf("** Using uncompressed version of '%s'\n", filename.c_str());
+    } else if (file_exists(filename + ".gz")) {
+      filename += ".gz";
+    } else if (file_exists(filename + ".Z")) {
+      filename += ".Z";
+    }
+    if (Array<string> sargv = decompression_command(filename); sargv.num()) {
+      _file_ispipe = true;
+      sargv.push(filename);
+      _file = my_popen(sargv, mode);
+#if defined(HH_FILEIO_HAVE_ZLIB)
+    } else if (filename_is_gzip(filename)) {
+      // Decompressed in-process; _file remains nullptr since its contents are compressed.
+      if (FILE* file = my_fopen(filename, "rb")) {
+        _gzimpl = make_unique<GzipImplementation>(file);
+        _is = _gzimpl->get_stream();
+      }
 #endif
-  } else if (file_exists(filename + ".gz")) {
-    _file_ispipe = true;
-    _file = my_popen(V<string>("gzip", "-d", "-c", filename + ".gz"), mode);
-  } else if (file_exists(filename + ".Z")) {
-    _file_ispipe = true;
-    _file = my_popen(V<string>("gzip", "-d", "-c", filename + ".Z"), mode);
+    } else {
+      _file = my_fopen(filename, "rb");
+    }
   }
   if (_file && !_is) {
     _impl = make_unique<Implementation>(_file);
@@ -349,6 +628,7 @@ RFile::~RFile() {
 #endif
   }
   _impl = nullptr;
+  _gzimpl = nullptr;
   if (_file) {
     if (_file_ispipe) {
       int ret = my_pclose(_file);
@@ -372,21 +652,22 @@ WFile::WFile(string filename) {
   if (starts_with(filename, "|")) {
     _file_ispipe = true;
     _file = my_popen(original_filename.substr(1), mode);  // No quoting at all.
-  } else if (ends_with(filename, ".Z")) {
-    _file_ispipe = true;
-    _file = my_popen(("compress >" + portable_simple_quote(filename)), mode);
-  } else if (ends_with(filename, ".gz")) {
+  } else if (const string command = compression_command(filename); command != "") {
     _file_ispipe = true;
-    _file = my_popen(("gzip >" + portable_simple_quote(filename)), mode);
+    _file = my_popen((command + " >" + portable_simple_quote(filename)), mode);
+#if defined(HH_FILEIO_HAVE_ZLIB)
+  } else if (filename_is_gzip(filename)) {
+    // Compressed in-process; _file remains nullptr since its contents are compressed.
+    if (FILE* file = my_fopen(filename, "wb")) {
+      _gzimpl = make_unique<GzipImplementation>(file);
+      _os = _gzimpl->get_stream();
+    }
+#endif
   } else if (filename == "-") {
     _file = stdout;
     _os = &std::cout;
   } else {
-#if defined(_WIN32)
-    _file = _wfopen(utf16_from_utf8(filename).c_str(), L"wb");
-#else
-    _file = fopen(filename.c_str(), "wb");
-#endif
+    _file = my_fopen(filename, "wb");
   }
   if (_file && !_os) {
     _impl = make_unique<Implementation>(_file);
@@ -399,6 +680,7 @@ WFile::~WFile() {
   std::lock_guard<std::mutex> lock(s_mutex);  // For pclose(), and just to be safe, for fclose() as well.
   if (_os) _os->flush();
   _impl = nullptr;
+  _gzimpl = nullptr;
   if (_file) {
     fflush(_file);
     if (_file_ispipe) {
@@ -447,7 +729,8 @@ bool is_pipe(const string& name) { return starts_with(name, "|") || ends_with(na
 bool is_url(const string& name) { return starts_with(name, "https://") || starts_with(name, "http://"); }
 
 bool file_requires_pipe(const string& name) {
-  return name == "-" || ends_with(name, ".Z") || ends_with(name, ".gz") || is_pipe(name) || is_url(name);
+  return name == "-" || ends_with(name, ".Z") || ends_with(name, ".gz") || ends_with(name, ".zst") ||
+         ends_with(name, ".lz4") || is_pipe(name) || is_url(name);
 }
 
 // Return: 0 if error.
@@ -7,37 +7,43 @@
 namespace hh {
 
 // Create a read stream (FILE and istream) from a file, compressed file, URL, or input pipe command.
-// Supports "-" (std::cin), ".Z", ".gz", "https://...", and "command args... |".
+// Supports "-" (std::cin), ".gz", ".Z", ".zst", ".lz4", "https://...", and "command args... |".
+// Files ".gz" are decompressed in-process (when zlib is available), and the others through a pipe command.
 // Note that it is best to close stdin within an input pipe: "command </dev/null ... |"!
 class RFile : noncopyable {
  public:
   explicit RFile(string filename);
   ~RFile();
   std::istream& operator()() const { return *_is; }
-  FILE* cfile() { return _file; }
+  FILE* cfile() { return _file; }  // nullptr if the file is decompressed in-process.
 
  private:
   bool _file_ispipe{false};
   FILE* _file{nullptr};
   class Implementation;
   unique_ptr<Implementation> _impl;
+  class GzipImplementation;
+  unique_ptr<GzipImplementation> _gzimpl;
   std::istream* _is{nullptr};
 };
 
 // Create a write stream (FILE and ostream) to a file, compressed file, or output pipe command.
-// Supports "-" (std::cout), ".Z", ".gz", and "| command args...".
+// Supports "-" (std::cout), ".gz", ".Z", ".zst", ".lz4", and "| command args...".
+// Files ".gz" are compressed in-process (when zlib is available) using multiple threads.
 class WFile : noncopyable {
  public:
   explicit WFile(string filename);
   ~WFile();
   std::ostream& operator()() const { return *_os; }
-  FILE* cfile() { return _file; }
+  FILE* cfile() { return _file; }  // nullptr if the file is compressed in-process.
 
  private:
   bool _file_ispipe{false};
   FILE* _file{nullptr};
   class Implementation;
   unique_ptr<Implementation> _impl;
+  class GzipImplementation;
+  unique_ptr<GzipImplementation> _gzimpl;
   std::ostream* _os{nullptr};
 };
 
@@ -60,7 +66,8 @@ bool is_pipe(const string& name);
 // Check if filename is a URL ("https://" or "http://").
 bool is_url(const string& name);
 
-// Check if filename would be read using a pipe stream ("-", ".Z", ".gz", "| command", "command |", "https://").
+// Check if filename would be read as a stream rather than as a plain file ("-", ".Z", ".gz", ".zst", ".lz4",
+// "| command", "command |", "https://").
 bool file_requires_pipe(const string& name);
 
 // Retrieve modification time of file or directory.
@@ -0,0 +1,646 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_LIBHH_FLATHASH_H_
+#define MESH_PROCESSING_LIBHH_FLATHASH_H_
+
+#include <cstring>      // memset(), memcpy()
+#include <functional>   // std::hash<>, std::equal_to<>
+#include <iterator>     // std::forward_iterator_tag
+#include <new>          // placement new
+#include <type_traits>  // std::void_t, std::bool_constant
+#include <utility>      // std::pair, std::exchange()
+
+#include "libHh/Random.h"
+
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(_M_X64) || defined(__SSE2__)
+#define HH_FLATHASH_SSE2
+#include <emmintrin.h>  // __m128i, _mm_movemask_epi8(), etc.
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>  // _BitScanForward()
+#endif
+
+#if 0
+{
+  FlatMap<int, Vertex> map;  // Same interface as Map<>.
+  FlatSet<Edge> set;         // Same interface as Set<>.
+  Value& value = map.enter(key, Value{}, is_new);  // Unlike Map, references are invalidated by later insertions.
+}
+#endif
+
+namespace hh {
+
+// FlatMap and FlatSet have the same interface as Map and Set, but are implemented using an open-addressing hash
+// table that stores the elements contiguously, with one metadata byte per slot (as in the "Swiss table" design).
+// A lookup first compares 7 bits of the hash against a group of 16 metadata bytes (using SSE2 if available), so it
+// seldom accesses more than one element.  They are selected per instantiation instead of Map and Set when the
+// following differences are acceptable:
+// - Insertions may move all elements, so references and iterators are invalidated by enter() and add().
+//   Removals never move the other elements, so it is safe to remove elements while iterating over the table.
+//   The table does not shrink after removals, except by an explicit shrink_to_fit().
+// - The iteration order differs.
+// - get_one_key(), get_one(), and remove_one() scan the table from its start, so emptying a table by repeatedly
+//   removing its first element takes quadratic time.
+
+namespace details {
+
+template <typename Hash, typename = void> struct is_dense_hash : std::false_type {};
+template <typename Hash> struct is_dense_hash<Hash, std::void_t<decltype(Hash::k_dense)>>
+    : std::bool_constant<Hash::k_dense> {};
+
+// Hash table of elements of type Slot, each identified by the key KeyOf()(slot).
+template <typename Slot, typename Key, typename KeyOf, typename Hash, typename Equal> class FlatHashTable {
+  using type = FlatHashTable;
+  static constexpr int k_group_width = 16;
+  static constexpr int8_t k_empty = -128, k_deleted = -2, k_sentinel = -1;  // Full slots have values 0..127.
+
+ public:
+  class const_iterator;
+  class iterator;
+  FlatHashTable() = default;
+  explicit FlatHashTable(Hash hash, Equal equal = Equal()) : _hash(std::move(hash)), _equal(std::move(equal)) {}
+  FlatHashTable(const type& t) : _hash(t._hash), _equal(t._equal) {
+    reserve(t._size);
+    for (const Slot& slot : t) insert_new(hash_of(KeyOf()(slot)), slot);
+  }
+  FlatHashTable(type&& t) noexcept { swap(*this, t); }
+  ~FlatHashTable() { destroy_all(); }
+  type& operator=(const type& t) {
+    if (&t != this) {
+      type tnew(t);
+      swap(*this, tnew);
+    }
+    return *this;
+  }
+  type& operator=(type&& t) noexcept {
+    type tnew(std::move(t));
+    swap(*this, tnew);
+    return *this;
+  }
+  friend void swap(type& l, type& r) noexcept {
+    using std::swap;
+    swap(l._ctrl, r._ctrl), swap(l._slots, r._slots), swap(l._capacity, r._capacity);
+    swap(l._size, r._size), swap(l._growth_left, r._growth_left), swap(l._hash, r._hash), swap(l._equal, r._equal);
+  }
+  const Hash& hash_function() const { return _hash; }
+  const Equal& key_eq() const { return _equal; }
+  size_t size() const { return _size; }
+  bool empty() const { return !_size; }
+  void clear() {
+    destroy_all();
+    _ctrl = nullptr, _slots = nullptr, _capacity = 0, _size = 0, _growth_left = 0;
+  }
+  void reserve(size_t n) {
+    if (n > _size + _growth_left) resize(capacity_for(n));
+  }
+  void shrink_to_fit() {
+    if (!_size) return clear();
+    if (capacity_for(_size) < _capacity) resize(capacity_for(_size));
+  }
+  // Return the index of the slot with the key, or -1 if it is absent.
+  ptrdiff_t find(const Key& key) const {
+    if (!_size) return -1;
+    const uint64_t h = hash_of(key);
+    const int8_t h2 = int8_t(h & 0x7F);
+    size_t offset = size_t(h >> 7) & _capacity;
+    for (size_t step = 0;; offset = (offset + step) & _capacity) {
+      const Group group(_ctrl + offset);
+      for (uint32_t mask = group.match(h2); mask; mask &= mask - 1) {
+        const size_t i = (offset + lowest_bit(mask)) & _capacity;
+        if (_equal(KeyOf()(_slots[i]), key)) return ptrdiff_t(i);
+      }
+      if (group.match_empty()) return -1;
+      step += k_group_width;
+      ASSERTX(step <= _capacity + 1);
+    }
+  }
+  // Return the slot with the key, inserting Slot(args...) if it is absent.
+  template <typename... Args> std::pair<Slot*, bool> insert(const Key& key, Args&&... args) {
+    const ptrdiff_t i = find(key);
+    if (i >= 0) return {&_slots[i], false};
+    return {insert_new(hash_of(key), std::forward<Args>(args)...), true};
+  }
+  // Remove the slot at index i.
+  void erase_index(size_t i) {
+    ASSERTX(i < _capacity && _ctrl[i] >= 0);
+    _slots[i].~Slot();
+    // A slot can become empty rather than deleted if no probe sequence can have passed over it, i.e., if there was
+    // never a full group around it.
+    const size_t index_before = (i - k_group_width) & _capacity;
+    const uint32_t empty_after = Group(_ctrl + i).match_empty();
+    const uint32_t empty_before = Group(_ctrl + index_before).match_empty();
+    const bool was_never_full = empty_before && empty_after &&
+                                leading_zeros16(empty_before) + lowest_bit(empty_after) < k_group_width;
+    set_ctrl(i, was_never_full ? k_empty : k_deleted);
+    if (was_never_full) _growth_left++;
+    _size--;
+  }
+  bool erase(const Key& key) {
+    const ptrdiff_t i = find(key);
+    if (i < 0) return false;
+    erase_index(size_t(i));
+    return true;
+  }
+  Slot& slot(size_t i) { return _slots[i]; }
+  const Slot& slot(size_t i) const { return _slots[i]; }
+  // Removals do not shrink the table, so its load factor may be arbitrarily low.  Therefore, after a few random
+  // probes, scan cyclically from the last probe (which favors the elements that follow long runs of free slots).
+  size_t random_index(Random& random) const {
+    assertx(_size);
+    size_t i = 0;
+    for_int(attempt, 8) {
+      i = random.get_size_t() & _capacity;
+      if (i < _capacity && _ctrl[i] >= 0) return i;
+    }
+    for (;;) {
+      i = i + 1 < _capacity ? i + 1 : 0;
+      if (_ctrl[i] >= 0) return i;
+    }
+  }
+  size_t first_index() const { return next_index(0); }
+  size_t next_index(size_t i) const {
+    while (i < _capacity && _ctrl[i] < 0) i++;
+    return i;
+  }
+  size_t end_index() const { return _capacity; }
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Slot;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Slot*;
+    using reference = const Slot&;
+    const_iterator() = default;
+    const_iterator(const type* t, size_t i) : _t(t), _i(i) {}
+    bool operator==(const const_iterator& rhs) const { return _i == rhs._i; }
+    bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+    const Slot& operator*() const { return _t->_slots[_i]; }
+    const Slot* operator->() const { return &_t->_slots[_i]; }
+    const_iterator& operator++() {
+      _i = _t->next_index(_i + 1);
+      return *this;
+    }
+    size_t index() const { return _i; }
+
+   private:
+    const type* _t{nullptr};
+    size_t _i{0};
+  };
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Slot;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Slot*;
+    using reference = Slot&;
+    iterator() = default;
+    iterator(type* t, size_t i) : _t(t), _i(i) {}
+    bool operator==(const iterator& rhs) const { return _i == rhs._i; }
+    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+    Slot& operator*() const { return _t->_slots[_i]; }
+    Slot* operator->() const { return &_t->_slots[_i]; }
+    iterator& operator++() {
+      _i = _t->next_index(_i + 1);
+      return *this;
+    }
+    operator const_iterator() const { return const_iterator(_t, _i); }
+    size_t index() const { return _i; }
+
+   private:
+    type* _t{nullptr};
+    size_t _i{0};
+  };
+  const_iterator begin() const { return const_iterator(this, first_index()); }
+  const_iterator end() const { return const_iterator(this, end_index()); }
+  iterator begin() { return iterator(this, first_index()); }
+  iterator end() { return iterator(this, end_index()); }
+
+ private:
+  // The metadata array _ctrl has _capacity + 1 + (k_group_width - 1) bytes: one per slot, a sentinel, and a copy
+  // of the first bytes so that a group can be loaded at any slot index.  _capacity is zero or 2^k - 1 with k >= 4.
+  int8_t* _ctrl{nullptr};
+  Slot* _slots{nullptr};
+  size_t _capacity{0};
+  size_t _size{0};
+  size_t _growth_left{0};
+  Hash _hash;
+  Equal _equal;
+
+  struct Group {
+#if defined(HH_FLATHASH_SSE2)
+    explicit Group(const int8_t* p) : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+    uint32_t match(int8_t h2) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)); }
+    uint32_t match_empty() const { return match(k_empty); }
+    uint32_t match_empty_or_deleted() const {
+      return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(k_sentinel), _ctrl));
+    }
+    __m128i _ctrl;
+#else
+    explicit Group(const int8_t* p) { std::memcpy(_ctrl, p, k_group_width); }
+    uint32_t match(int8_t h2) const {
+      uint32_t mask = 0;
+      for_int(i, k_group_width) mask |= uint32_t(_ctrl[i] == h2) << i;
+      return mask;
+    }
+    uint32_t match_empty() const { return match(k_empty); }
+    uint32_t match_empty_or_deleted() const {
+      uint32_t mask = 0;
+      for_int(i, k_group_width) mask |= uint32_t(_ctrl[i] < k_sentinel) << i;
+      return mask;
+    }
+    int8_t _ctrl[k_group_width];
+#endif
+  };
+  static int lowest_bit(uint32_t mask) {
+    ASSERTXX(mask);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+  static int leading_zeros16(uint32_t mask) {  // Number of leading zero bits in a 16-bit mask.
+    int n = 0;
+    for (uint32_t bit = 1u << 15; bit && !(mask & bit); bit >>= 1) n++;
+    return n;
+  }
+  uint64_t hash_of(const Key& key) const {
+    // Mix the bits, since std::hash<> is the identity for integers and pointers.
+    const uint64_t hash = _hash(key), h = hash * 0x9E3779B97F4A7C15ull;
+    if constexpr (is_dense_hash<Hash>::value) return (hash << 7) | ((h >> 32) & 0x7F);  // Probe start is the key.
+    return h ^ (h >> 32);
+  }
+  static size_t capacity_for(size_t n) {  // Smallest 2^k - 1 whose 7/8 load holds n elements.
+    size_t capacity = k_group_width - 1;
+    while (capacity - capacity / 8 < n) capacity = capacity * 2 + 1;
+    return capacity;
+  }
+  void set_ctrl(size_t i, int8_t h) {
+    _ctrl[i] = h;
+    _ctrl[((i - (k_group_width - 1)) & _capacity) + (k_group_width - 1)] = h;  // Mirrored copy if i < 15.
+  }
+  size_t find_first_non_full(uint64_t h) const {
+    size_t offset = size_t(h >> 7) & _capacity;
+    for (size_t step = 0;; offset = (offset + step) & _capacity) {
+      const uint32_t mask = Group(_ctrl + offset).match_empty_or_deleted();
+      if (mask) return (offset + lowest_bit(mask)) & _capacity;
+      step += k_group_width;
+      ASSERTX(step <= _capacity + 1);
+    }
+  }
+  template <typename... Args> Slot* insert_new(uint64_t h, Args&&... args) {
+    if (!_capacity) resize(capacity_for(1));
+    size_t i = find_first_non_full(h);
+    if (!_growth_left && _ctrl[i] != k_deleted) {
+      // Reclaim the deleted slots if they are numerous; otherwise double the capacity.
+      resize(_size * 32 <= _capacity * 25 ? _capacity : _capacity * 2 + 1);
+      i = find_first_non_full(h);
+    }
+    if (_ctrl[i] == k_empty) _growth_left--;
+    set_ctrl(i, int8_t(h & 0x7F));
+    _size++;
+    return new (&_slots[i]) Slot(std::forward<Args>(args)...);
+  }
+  void resize(size_t new_capacity) {
+    int8_t* old_ctrl = _ctrl;
+    Slot* old_slots = _slots;
+    const size_t old_capacity = _capacity;
+    const size_t ctrl_size = new_capacity + k_group_width;
+    _ctrl = static_cast<int8_t*>(::operator new(slots_offset(new_capacity) + sizeof(Slot) * new_capacity));
+    std::memset(_ctrl, k_empty, ctrl_size);
+    _ctrl[new_capacity] = k_sentinel;
+    _slots = reinterpret_cast<Slot*>(_ctrl + slots_offset(new_capacity));
+    _capacity = new_capacity;
+    _growth_left = new_capacity - new_capacity / 8 - _size;
+    for_size_t(i, old_capacity) {
+      if (old_ctrl[i] < 0) continue;
+      const uint64_t h = hash_of(KeyOf()(old_slots[i]));
+      const size_t inew = find_first_non_full(h);
+      set_ctrl(inew, int8_t(h & 0x7F));
+      new (&_slots[inew]) Slot(std::move(old_slots[i]));
+      old_slots[i].~Slot();
+    }
+    ::operator delete(old_ctrl);
+  }
+  static size_t slots_offset(size_t capacity) {  // Slots follow the metadata bytes, suitably aligned.
+    const size_t align = alignof(Slot);
+    return (capacity + k_group_width + align - 1) / align * align;
+  }
+  void destroy_all() {
+    if (!_ctrl) return;
+    for_size_t(i, _capacity)
+      if (_ctrl[i] >= 0) _slots[i].~Slot();
+    ::operator delete(_ctrl);
+  }
+};
+
+template <typename Key, typename Value> struct FlatMapKeyOf {
+  const Key& operator()(const std::pair<Key, Value>& slot) const { return slot.first; }
+};
+
+template <typename T> struct FlatSetKeyOf {
+  const T& operator()(const T& slot) const { return slot; }
+};
+
+}  // namespace details
+
+// Hash for nonnegative integer keys that are mostly dense, like the element ids in Mesh.  The probe sequence starts
+// at the key itself, so consecutive keys occupy consecutive slots and the iteration order approximately follows the
+// key order (which preserves memory locality when the elements were allocated in key order).
+struct FlatDenseHash {
+  static constexpr bool k_dense = true;
+  size_t operator()(int i) const { return size_t(i); }
+};
+
+// Open-addressing replacement for Map<Key, Value, Hash, Equal> (see above).
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+class FlatMap {
+  using type = FlatMap<Key, Value, Hash, Equal>;
+  using value_type = std::pair<Key, Value>;
+  using base = details::FlatHashTable<value_type, Key, details::FlatMapKeyOf<Key, Value>, Hash, Equal>;
+  using biter = typename base::iterator;
+  using bciter = typename base::const_iterator;
+
+ public:
+  class keys_range;
+  class values_range;
+  class cvalues_range;
+  using Hashf = Hash;
+  using Equalf = Equal;
+  FlatMap() = default;
+  explicit FlatMap(Hashf hashf) : _map(std::move(hashf)) {}
+  explicit FlatMap(Hashf hashf, Equalf equalf) : _map(std::move(hashf), std::move(equalf)) {}
+  FlatMap(std::initializer_list<std::pair<const Key, Value>> list) {
+    for (auto& [key, value] : list) enter(key, value);
+  }
+  void clear() { _map.clear(); }
+  void reserve(int n) { _map.reserve(n); }
+  void shrink_to_fit() { _map.shrink_to_fit(); }  // Reduce memory after many removals; invalidates iterators.
+  void enter(const Key& key, const Value& value) {  // Key must be new!
+    auto [_, is_new] = _map.insert(key, key, value);
+    ASSERTX(is_new);
+  }
+  void enter(Key&& key, const Value& value) {
+    auto [_, is_new] = _map.insert(key, std::move(key), value);
+    ASSERTX(is_new);
+  }
+  void enter(const Key& key, Value&& value) {
+    auto [_, is_new] = _map.insert(key, key, std::move(value));
+    ASSERTX(is_new);
+  }
+  void enter(Key&& key, Value&& value) {
+    auto [_, is_new] = _map.insert(key, std::move(key), std::move(value));
+    ASSERTX(is_new);
+  }
+  Value& enter(const Key& key, const Value& value, bool& is_new) {  // Does not modify element if it already exists.
+    auto [slot, is_new_] = _map.insert(key, key, value);
+    is_new = is_new_;
+    return slot->second;
+  }
+  bool contains(const Key& key) const { return _map.find(key) >= 0; }
+  const Value& retrieve(const Key& key, bool& present) const {
+    const ptrdiff_t i = _map.find(key);
+    present = i >= 0;
+    return present ? _map.slot(i).second : def();
+  }
+  const Value& retrieve(const Key& key) const {
+    const ptrdiff_t i = _map.find(key);
+    return i >= 0 ? _map.slot(i).second : def();
+  }
+  Value& get(const Key& key) {
+    const ptrdiff_t i = _map.find(key);
+    ASSERTXX(i >= 0);
+    return _map.slot(i).second;
+  }
+  const Value& get(const Key& key) const {
+    const ptrdiff_t i = _map.find(key);
+    ASSERTXX(i >= 0);
+    return _map.slot(i).second;
+  }
+  Value remove(const Key& key) {
+    const ptrdiff_t i = _map.find(key);
+    if (i < 0) return Value();
+    Value value = std::move(_map.slot(i).second);
+    _map.erase_index(i);
+    return value;
+  }
+  Value replace(const Key& key, const Value& value) {
+    const ptrdiff_t i = _map.find(key);
+    if (i < 0) return Value();
+    return std::exchange(_map.slot(i).second, value);
+  }
+  int num() const { return narrow_cast<int>(_map.size()); }
+  size_t size() const { return _map.size(); }
+  bool empty() const { return _map.empty(); }
+  Value& operator[](const Key& key) { return _map.insert(key, key, Value()).first->second; }
+  const Value& operator[](const Key& key) const { return retrieve(key); }
+  const Key& get_one_key() const { return (ASSERTXX(!empty()), begin()->first); }
+  const Value& get_one_value() const { return (ASSERTXX(!empty()), begin()->second); }
+  const Key& get_random_key(Random& random) const { return _map.slot(_map.random_index(random)).first; }
+  const Value& get_random_value(Random& random) const { return _map.slot(_map.random_index(random)).second; }
+  keys_range keys() const { return keys_range(*this); }  // Keys are always constant.
+  values_range values() { return values_range(*this); }
+  cvalues_range cvalues() { return cvalues_range(*this); }
+  cvalues_range values() const { return cvalues_range(*this); }
+  // For "for (auto& [key, value] : map)" and HH_DECLARE_OSTREAM_RANGE(FlatMap<Key, Value>):
+  bciter begin() const { return _map.begin(); }
+  bciter end() const { return _map.end(); }
+
+ public:
+  class keys_iterator {
+    using type = keys_iterator;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Key;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+    keys_iterator() = default;
+    keys_iterator(bciter it) : _it(it) {}
+    bool operator==(const type& rhs) const { return _it == rhs._it; }
+    bool operator!=(const type& rhs) const { return !(*this == rhs); }
+    const Key& operator*() const { return _it->first; }
+    type& operator++() {
+      ++_it;
+      return *this;
+    }
+
+   private:
+    bciter _it;
+  };
+  class keys_range {
+   public:
+    keys_range(const type& map) : _map(map) {}
+    keys_iterator begin() const { return keys_iterator(_map.begin()); }
+    keys_iterator end() const { return keys_iterator(_map.end()); }
+    size_t size() const { return _map.size(); }
+
+   private:
+    const type& _map;
+  };
+  class cvalues_iterator {
+    using type = cvalues_iterator;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+    cvalues_iterator() = default;
+    cvalues_iterator(bciter it) : _it(it) {}
+    bool operator==(const type& rhs) const { return _it == rhs._it; }
+    bool operator!=(const type& rhs) const { return !(*this == rhs); }
+    const Value& operator*() const { return _it->second; }
+    type& operator++() {
+      ++_it;
+      return *this;
+    }
+
+   private:
+    bciter _it;
+  };
+  class cvalues_range {
+   public:
+    cvalues_range(const type& map) : _map(map) {}
+    cvalues_iterator begin() const { return cvalues_iterator(_map.begin()); }
+    cvalues_iterator end() const { return cvalues_iterator(_map.end()); }
+    size_t size() const { return _map.size(); }
+
+   private:
+    const type& _map;
+  };
+  class values_iterator {
+    using type = values_iterator;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+    values_iterator() = default;
+    values_iterator(biter it) : _it(it) {}
+    bool operator==(const type& rhs) const { return _it == rhs._it; }
+    bool operator!=(const type& rhs) const { return !(*this == rhs); }
+    Value& operator*() const { return _it->second; }
+    type& operator++() {
+      ++_it;
+      return *this;
+    }
+
+   private:
+    biter _it;
+  };
+  class values_range {
+   public:
+    values_range(type& map) : _map(map) {}
+    values_iterator begin() const { return values_iterator(_map._map.begin()); }
+    values_iterator end() const { return values_iterator(_map._map.end()); }
+    size_t size() const { return _map.size(); }
+
+   private:
+    type& _map;
+  };
+
+ private:
+  base _map;
+  static const Value& def() {
+    static const Value key_default = Value();
+    return key_default;
+  }
+  // Default operator=() and copy_constructor are safe.
+};
+
+// Open-addressing replacement for Set<T, Hash, Equal> (see above).
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>> class FlatSet {
+  using type = FlatSet<T, Hash, Equal>;
+  using base = details::FlatHashTable<T, T, details::FlatSetKeyOf<T>, Hash, Equal>;
+
+ public:
+  using Hashf = Hash;
+  using Equalf = Equal;
+  using value_type = T;
+  using iterator = typename base::const_iterator;  // Elements are constant.
+  using const_iterator = typename base::const_iterator;
+  FlatSet() = default;
+  explicit FlatSet(Hashf hashf) : _set(std::move(hashf)) {}
+  explicit FlatSet(Hashf hashf, Equalf equalf) : _set(std::move(hashf), std::move(equalf)) {}
+  FlatSet(std::initializer_list<T> list) {
+    for (const T& e : list) enter(e);
+  }
+  void clear() { _set.clear(); }
+  void reserve(int n) { _set.reserve(n); }
+  void shrink_to_fit() { _set.shrink_to_fit(); }  // Reduce memory after many removals; invalidates iterators.
+  void enter(const T& e) {  // Element e must be new.
+    auto [_, is_new] = _set.insert(e, e);
+    ASSERTX(is_new);
+  }
+  void enter(T&& e) {  // Element e must be new.
+    auto [_, is_new] = _set.insert(e, std::move(e));
+    ASSERTX(is_new);
+  }
+  const T& enter(const T& e, bool& is_new) {
+    auto [slot, is_new_] = _set.insert(e, e);
+    is_new = is_new_;
+    return *slot;
+  }
+  bool add(const T& e) { return _set.insert(e, e).second; }  // Return: is_new.
+  bool remove(const T& e) { return _set.erase(e); }           // Return: was_found.
+  bool contains(const T& e) const { return _set.find(e) >= 0; }
+  int num() const { return narrow_cast<int>(_set.size()); }
+  size_t size() const { return _set.size(); }
+  bool empty() const { return _set.empty(); }
+  const T& retrieve(const T& e, bool& present) const {
+    const ptrdiff_t i = _set.find(e);
+    present = i >= 0;
+    return present ? _set.slot(i) : def();
+  }
+  const T& retrieve(const T& e) const {
+    const ptrdiff_t i = _set.find(e);
+    return i >= 0 ? _set.slot(i) : def();
+  }
+  const T& get(const T& e) const {
+    const ptrdiff_t i = _set.find(e);
+    ASSERTXX(i >= 0);
+    return _set.slot(i);
+  }
+  const T& get_one() const { return (ASSERTXX(!empty()), *begin()); }
+  const T& get_random(Random& r) const { return _set.slot(_set.random_index(r)); }
+  T remove_one() {
+    ASSERTXX(!empty());
+    return remove_index(_set.first_index());
+  }
+  T remove_random(Random& r) { return remove_index(_set.random_index(r)); }
+  const_iterator begin() const { return _set.begin(); }
+  const_iterator end() const { return _set.end(); }
+  void merge(type& other) {  // Elements are moved from `other` if not already in *this.
+    for (size_t i = other._set.first_index(); i != other._set.end_index(); i = other._set.next_index(i + 1))
+      if (!contains(other._set.slot(i))) enter(other.remove_index(i));
+  }
+
+ private:
+  base _set;
+  static const T& def() {
+    static const T k_default = T{};
+    return k_default;
+  }
+  T remove_index(size_t i) {
+    T e = std::move(_set.slot(i));
+    _set.erase_index(i);
+    return e;
+  }
+  // Default operator=() and copy_constructor are safe.
+};
+
+template <typename Key, typename Value> HH_DECLARE_OSTREAM_RANGE(FlatMap<Key, Value>);
+template <typename Key, typename Value> HH_DECLARE_OSTREAM_EOL(FlatMap<Key, Value>);
+template <typename T> HH_DECLARE_OSTREAM_RANGE(FlatSet<T>);
+template <typename T> HH_DECLARE_OSTREAM_EOL(FlatSet<T>);
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_LIBHH_FLATHASH_H_
@@ -19,6 +19,11 @@ void swap(GMesh& l, GMesh& r) noexcept {
   using std::swap;
   swap(implicit_cast<Mesh&>(l), implicit_cast<Mesh&>(r));
   swap(l._os, r._os);
+  swap(l._channels, r._channels);
+  swap(l._num_corner_slots, r._num_corner_slots);
+  swap(l._free_corner_slots, r._free_corner_slots);
+  for (auto& channel : l._channels) channel->_mesh = &l;
+  for (auto& channel : r._channels) channel->_mesh = &r;
 }
 
 void GMesh::copy(const GMesh& m) {
@@ -46,6 +51,29 @@ void GMesh::copy(const GMesh& m) {
   }
 }
 
+void GMesh::copy_faces(const GMesh& m, CArrayView<Face> fa) {
+  Mesh::copy_faces(m, fa);
+  for (Vertex vn : vertices()) {
+    Vertex v = m.id_vertex(vertex_id(vn));
+    set_string(vn, m.get_string(v));
+    set_point(vn, m.point(v));
+  }
+  for (Face f : fa) {
+    Face fn = id_face(m.face_id(f));
+    set_string(fn, m.get_string(f));
+    for (Corner c : m.corners(f)) {
+      if (!m.get_string(c)) continue;
+      Corner cn = corner(id_vertex(m.vertex_id(m.corner_vertex(c))), fn);
+      set_string(cn, m.get_string(c));
+    }
+    for (Edge e : m.edges(f)) {
+      if (!m.get_string(e)) continue;
+      Edge en = edge(id_vertex(m.vertex_id(m.vertex1(e))), id_vertex(m.vertex_id(m.vertex2(e))));
+      set_string(en, m.get_string(e));
+    }
+  }
+}
+
 void GMesh::merge(const GMesh& mo, Map<Vertex, Vertex>* pmvvn) {
   unique_ptr<Map<Vertex, Vertex>> tmvvn = !pmvvn ? make_unique<Map<Vertex, Vertex>>() : nullptr;
   Map<Vertex, Vertex>& mvvn = pmvvn ? *pmvvn : *tmvvn;
@@ -336,18 +364,170 @@ void GMesh::update_string_ptr(unique_ptr<char[]>& ss, const char* key, const cha
   if (arnew) ss = std::move(arnew);
 }
 
-void GMesh::update_string(Vertex v, const char* key, const char* val) { update_string_ptr(v->_string, key, val); }
+void GMesh::update_string(Vertex v, const char* key, const char* val) {
+  update_string_ptr(v->_string, key, val);
+  string_modified(v, key);
+}
 
-void GMesh::update_string(Face f, const char* key, const char* val) { update_string_ptr(f->_string, key, val); }
+void GMesh::update_string(Face f, const char* key, const char* val) {
+  update_string_ptr(f->_string, key, val);
+  string_modified(f, key);
+}
 
 void GMesh::update_string(Edge e, const char* key, const char* val) { update_string_ptr(e->_string, key, val); }
 
-void GMesh::update_string(Corner c, const char* key, const char* val) { update_string_ptr(c->_string, key, val); }
+void GMesh::update_string(Corner c, const char* key, const char* val) {
+  update_string_ptr(c->_string, key, val);
+  string_modified(c, key);
+}
+
+// *** Typed attribute channels
+
+namespace {
+
+struct struct_c_channel_slot {
+  int i{0};  // GMesh corner channel slot (plus one), or 0.
+};
+HH_SACABLE(struct_c_channel_slot);
+HH_SAC_ALLOCATE_CD_FUNC(Mesh::MHEdge, struct_c_channel_slot, c_channel_slot);
+
+}  // namespace
+
+int GMesh::corner_slot(Corner c) const {
+  int& slot = c_channel_slot(c).i;
+  if (!slot) slot = (_free_corner_slots.num() ? _free_corner_slots.pop() : _num_corner_slots++) + 1;
+  return slot - 1;
+}
+
+int GMesh::existing_corner_slot(Corner c) const { return c_channel_slot(c).i - 1; }
+
+GMeshChannel::GMeshChannel(const GMesh& mesh, Kind kind, string key, int dim)
+    : _mesh(&mesh), _kind(kind), _key(std::move(key)), _dim(dim) {
+  assertx(_dim >= 1);
+  fill();
+}
+
+void GMeshChannel::fill() {
+  Array<float> ar(_dim);
+  switch (_kind) {
+    case Kind::vertex:
+      for (Vertex v : _mesh->vertices()) get(v, ar);
+      break;
+    case Kind::face:
+      for (Face f : _mesh->faces()) get(f, ar);
+      break;
+    case Kind::corner:
+      for (Vertex v : _mesh->vertices())
+        for (Corner c : _mesh->corners(v)) {
+          reserve(_mesh->corner_slot(c));
+          get(c, ar);
+        }
+      break;
+    default: assertnever("");
+  }
+}
+
+void GMeshChannel::reserve(int i) {
+  if (i < _entries.num()) return;
+  _entries.resize(i + 1);
+  _values.resize(_entries.num() * _dim);
+}
+
+bool GMeshChannel::get_entry(int i, ArrayView<float> ar) {
+  if (!_entries[i].present) return false;
+  ar.assign(values(i));
+  return true;
+}
+
+bool GMeshChannel::get(Vertex v, ArrayView<float> ar) {
+  ASSERTX(_kind == Kind::vertex && ar.num() == _dim);
+  const int i = _mesh->vertex_id(v);
+  reserve(i);
+  if (_entries[i].element != v)
+    _entries[i] = {v, nullptr, parse_key_vec(_mesh->get_string(v), _key.c_str(), values(i))};
+  return get_entry(i, ar);
+}
+
+bool GMeshChannel::get(Face f, ArrayView<float> ar) {
+  ASSERTX(_kind == Kind::face && ar.num() == _dim);
+  const int i = _mesh->face_id(f);
+  reserve(i);
+  if (_entries[i].element != f)
+    _entries[i] = {f, nullptr, parse_key_vec(_mesh->get_string(f), _key.c_str(), values(i))};
+  return get_entry(i, ar);
+}
+
+bool GMeshChannel::get(Corner c, ArrayView<float> ar) {
+  ASSERTX(_kind == Kind::corner && ar.num() == _dim);
+  // The slot is assigned in fill() or GMesh::create_face_private(), so that concurrent get() calls do not modify it.
+  const int i = _mesh->existing_corner_slot(c);
+  ASSERTX(i >= 0 && i < _entries.num());
+  Vertex v = _mesh->corner_vertex(c);
+  if (_entries[i].element != c || _entries[i].vertex != v)
+    _entries[i] = {c, v, _mesh->parse_corner_key_vec(c, _key.c_str(), values(i))};
+  return get_entry(i, ar);
+}
+
+void GMeshChannel::invalidate(Vertex v) {
+  if (_kind == Kind::vertex) {
+    const int i = _mesh->vertex_id(v);
+    if (i < _entries.num()) _entries[i].element = nullptr;
+  } else if (_kind == Kind::corner) {
+    for (Corner c : _mesh->corners(v)) invalidate(c);
+  }
+}
+
+void GMeshChannel::invalidate(Face f) {
+  if (_kind != Kind::face) return;
+  const int i = _mesh->face_id(f);
+  if (i < _entries.num()) _entries[i].element = nullptr;
+}
+
+void GMeshChannel::invalidate(Corner c) {
+  if (_kind != Kind::corner) return;
+  const int i = _mesh->existing_corner_slot(c);
+  if (i >= 0 && i < _entries.num()) _entries[i].element = nullptr;
+}
+
+void GMeshChannel::remove(Face f) {
+  invalidate(f);
+  if (_kind != Kind::corner) return;
+  for (Corner c : _mesh->corners(f)) invalidate(c);
+}
+
+void GMeshChannel::clear() {
+  _entries.init(0);
+  _values.init(0);
+}
+
+GMeshChannel& GMesh::channel(GMeshChannel::Kind kind, const char* key, int dim) const {
+  for (auto& channel : _channels) {
+    if (channel->_kind == kind && channel->_key == key) {
+      assertx(channel->_dim == dim);
+      return *channel;
+    }
+  }
+  _channels.push(unique_ptr<GMeshChannel>(new GMeshChannel(*this, kind, key, dim)));
+  return *_channels.last();
+}
+
+GMeshChannel& GMesh::vertex_channel(const char* key, int dim) const {
+  return channel(GMeshChannel::Kind::vertex, key, dim);
+}
+
+GMeshChannel& GMesh::face_channel(const char* key, int dim) const {
+  return channel(GMeshChannel::Kind::face, key, dim);
+}
+
+GMeshChannel& GMesh::corner_channel(const char* key, int dim) const {
+  return channel(GMeshChannel::Kind::corner, key, dim);
+}
 
 // I/O
 
 void GMesh::read(std::istream& is) {
   for (string line; my_getline(is, line);) read_line(const_cast<char*>(line.c_str()));
+  for (auto& channel : _channels) channel->fill();
   if (debug() >= 1) ok();
 }
 
@@ -683,6 +863,7 @@ Vertex GMesh::create_vertex_private(int id) {
 // Override Mesh members
 void GMesh::destroy_vertex(Vertex v) {
   if (_os) *_os << "DVertex " << vertex_id(v) << '\n';
+  string_modified(v);
   Mesh::destroy_vertex(v);
 }
 
@@ -693,14 +874,32 @@ Face GMesh::create_face_private(int id, CArrayView<Vertex> va) {
     for_int(i, va.num()) { *_os << ' ' << vertex_id(va[i]); }
     *_os << '\n';
   }
+  for (auto& channel : _channels)
+    if (channel->_kind == GMeshChannel::Kind::corner)
+      for (Corner c : corners(f)) channel->reserve(corner_slot(c));
   return f;
 }
 
 void GMesh::destroy_face(Face f) {
   if (_os) *_os << "DFace " << face_id(f) << '\n';
+  for (auto& channel : _channels) channel->remove(f);
+  for (Corner c : corners(f)) {
+    int& slot = c_channel_slot(c).i;
+    if (slot) _free_corner_slots.push(std::exchange(slot, 0) - 1);
+  }
   Mesh::destroy_face(f);
 }
 
+void GMesh::will_clear() {
+  if (_os) {  // Same records as the destroy_face() and destroy_vertex() calls of a clear() element by element.
+    for (Face f : faces()) *_os << "DFace " << face_id(f) << '\n';
+    for (Vertex v : vertices()) *_os << "DVertex " << vertex_id(v) << '\n';
+  }
+  for (auto& channel : _channels) channel->clear();
+  _num_corner_slots = 0;
+  _free_corner_slots.init(0);
+}
+
 void GMesh::collapse_edge_vertex(Edge e, Vertex vs) {
   if (debug() >= 1) valid(e);
   std::ostream* tos = _os;
@@ -31,6 +31,53 @@ class WA3dStream;
 class A3dElem;
 struct A3dVertexColor;
 
+class GMesh;
+
+// Dense float vectors of one attribute key (e.g., "normal", "uv", "rgb") in the strings of the vertices, faces, or
+// corners of a GMesh, obtained from GMesh::vertex_channel(), face_channel(), or corner_channel().
+// The element strings remain the storage of record (they are what read() parses, write() outputs, and many programs
+// edit directly), so a channel is a typed view that is kept coherent with them.  It is filled when created and again
+// at the end of GMesh::read(), so a channel requested before reading a mesh is populated at read time.  Afterwards, an
+// element is re-parsed only after its string is modified (or, for a corner, after its vertex or vertex string
+// changes), so that repeated accesses avoid string tokenization.  Corner entries are indexed by a slot stored in
+// each corner, which is assigned when the channel is filled or when the corner's face is created.
+// Concurrent get() calls are threadsafe as long as the mesh strings and topology are unchanged.
+class GMeshChannel : noncopyable {
+ public:
+  const string& key() const { return _key; }
+  int dim() const { return _dim; }
+  // Copy the attribute into ar (whose size must be dim()) and return true, or return false if it is absent.
+  bool get(Vertex v, ArrayView<float> ar);  // Same result as parse_key_vec(mesh.get_string(v), key(), ar).
+  bool get(Face f, ArrayView<float> ar);    // Same result as parse_key_vec(mesh.get_string(f), key(), ar).
+  bool get(Corner c, ArrayView<float> ar);  // Same result as mesh.parse_corner_key_vec(c, key(), ar).
+
+ private:
+  friend GMesh;
+  friend void swap(GMesh& l, GMesh& r) noexcept;
+  enum class Kind { vertex, face, corner };
+  struct Entry {
+    const void* element{nullptr};  // Vertex, Face, or Corner whose attribute is cached; nullptr if invalid.
+    Vertex vertex{nullptr};        // For a Corner, its vertex when the attribute was cached.
+    bool present{false};
+  };
+  GMeshChannel(const GMesh& mesh, Kind kind, string key, int dim);
+  ArrayView<float> values(int i) { return ArrayView<float>(_values.data() + size_t(i) * _dim, _dim); }
+  void fill();
+  void reserve(int i);  // Ensure that _entries[i] exists.
+  bool get_entry(int i, ArrayView<float> ar);
+  void invalidate(Vertex v);
+  void invalidate(Face f);
+  void invalidate(Corner c);
+  void remove(Face f);  // Called before the face (and its corners) are destroyed.
+  void clear();          // Called before all mesh elements are destroyed.
+  const GMesh* _mesh;
+  Kind _kind;
+  string _key;
+  int _dim;
+  Array<Entry> _entries;  // Indexed by vertex_id(), face_id(), or GMesh::corner_slot().
+  Array<float> _values;   // _dim values for each entry.
+};
+
 // Corner data is currently not handled
 
 // A Mesh with geometric structure (Point at each Vertex) and with strings at each mesh element.
@@ -47,6 +94,7 @@ class GMesh : public Mesh {
 
   // ** Extend functionality:
   void copy(const GMesh& m);  // carries flags (but not sac fields), hence not named operator=().
+  void copy_faces(const GMesh& m, CArrayView<Face> fa);  // only faces fa and their vertices
   void merge(const GMesh& mo, Map<Vertex, Vertex>* mvvn = nullptr);
   void destroy_vertex(Vertex v) override;
   void destroy_face(Face f) override;
@@ -81,23 +129,23 @@ class GMesh : public Mesh {
   const char* get_string(Face f) const { return f->_string.get(); }
   const char* get_string(Edge e) const { return e->_string.get(); }
   const char* get_string(Corner c) const { return c->_string.get(); }
-  unique_ptr<char[]> extract_string(Vertex v) { return std::move(v->_string); }
-  unique_ptr<char[]> extract_string(Face f) { return std::move(f->_string); }
+  unique_ptr<char[]> extract_string(Vertex v) { return string_modified(v), std::move(v->_string); }
+  unique_ptr<char[]> extract_string(Face f) { return string_modified(f), std::move(f->_string); }
   unique_ptr<char[]> extract_string(Edge e) { return std::move(e->_string); }
-  unique_ptr<char[]> extract_string(Corner c) { return std::move(c->_string); }
+  unique_ptr<char[]> extract_string(Corner c) { return string_modified(c), std::move(c->_string); }
   static bool string_has_key(const char* ss, const char* key);
   static const char* string_key(string& str, const char* ss, const char* key);
   const char* corner_key(string& str, Corner c, const char* key) const;             // Corner | Vertex
   bool parse_corner_key_vec(Corner c, const char* key, ArrayView<float> ar) const;  // Corner | Vertex
   // copies string
-  void set_string(Vertex v, const char* s) { v->_string = make_unique_c_string(s); }
-  void set_string(Face f, const char* s) { f->_string = make_unique_c_string(s); }
+  void set_string(Vertex v, const char* s) { v->_string = make_unique_c_string(s), string_modified(v); }
+  void set_string(Face f, const char* s) { f->_string = make_unique_c_string(s), string_modified(f); }
   void set_string(Edge e, const char* s) { e->_string = make_unique_c_string(s); }
-  void set_string(Corner c, const char* s) { c->_string = make_unique_c_string(s); }
-  void set_string(Vertex v, unique_ptr<char[]> s) { v->_string = std::move(s); }
-  void set_string(Face f, unique_ptr<char[]> s) { f->_string = std::move(s); }
+  void set_string(Corner c, const char* s) { c->_string = make_unique_c_string(s), string_modified(c); }
+  void set_string(Vertex v, unique_ptr<char[]> s) { v->_string = std::move(s), string_modified(v); }
+  void set_string(Face f, unique_ptr<char[]> s) { f->_string = std::move(s), string_modified(f); }
   void set_string(Edge e, unique_ptr<char[]> s) { e->_string = std::move(s); }
-  void set_string(Corner c, unique_ptr<char[]> s) { c->_string = std::move(s); }
+  void set_string(Corner c, unique_ptr<char[]> s) { c->_string = std::move(s), string_modified(c); }
   static string string_update(const string& s, const char* key, const char* val);
   void update_string(Vertex v, const char* key, const char* val);
   void update_string(Face f, const char* key, const char* val);
@@ -105,6 +153,12 @@ class GMesh : public Mesh {
   void update_string(Corner c, const char* key, const char* val);
   static void update_string_ptr(unique_ptr<char[]>& ss, const char* key, const char* val);
 
+  // ** Typed attribute channels (see GMeshChannel); each is created on first request and then kept up-to-date:
+  GMeshChannel& vertex_channel(const char* key, int dim) const;
+  GMeshChannel& face_channel(const char* key, int dim) const;
+  GMeshChannel& corner_channel(const char* key, int dim) const;  // Corner | Vertex
+  void clear_channels() const { _channels.clear(); }              // E.g., to avoid their upkeep in mesh edits.
+
   // ** Standard I/O for my meshes (see format below):
   void read(std::istream& is);  // read a whole mesh, discard comments
   void read_line(char* s);      // no '\n' required
@@ -128,8 +182,23 @@ class GMesh : public Mesh {
 
   void show_keys(Vertex v) const;
 
+ protected:
+  void will_clear() override;
+
  private:
   std::ostream* _os{nullptr};  // for record_changes
+  mutable Array<unique_ptr<GMeshChannel>> _channels;
+  // While corner channels exist, corners are numbered compactly; the slots of destroyed corners are reused.
+  mutable int _num_corner_slots{0};
+  mutable Array<int> _free_corner_slots;
+  friend GMeshChannel;
+  GMeshChannel& channel(GMeshChannel::Kind kind, const char* key, int dim) const;
+  int corner_slot(Corner c) const;           // Assign a slot to the corner if it has none.
+  int existing_corner_slot(Corner c) const;  // Or -1 if none.
+  template <typename T> void string_modified(T element, const char* key = nullptr) {
+    for (auto& channel : _channels)
+      if (!key || channel->_key == key) channel->invalidate(element);
+  }
 };
 
 // Format a vector string "(%g ... %g)".
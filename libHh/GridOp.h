@@ -106,6 +106,13 @@ template <int D, bool parallel = true>
 Grid<D, Pixel> convolve_d(CGridView<D, Pixel> grid, int d, CArrayView<float> kernel, Bndrule bndrule,
                           const Pixel* bordervalue = nullptr);
 
+// Blur a grid along its d'th dimension with an approximate Gaussian kernel of standard deviation sdv (in samples).
+// The kernel is a cascade of 4 "extended" box filters [Gwosdek et al. 2011] whose variance matches the Gaussian
+// exactly, so the cost per sample is independent of sdv.  For sdv >= 1.5, the kernel differs from the exact Gaussian
+// by at most 4% of its peak value, and by at most 4% in L1 norm.  The element type T is float, Vector4, or Pixel.
+template <int D, typename T>
+Grid<D, T> gaussian_blur_d(CGridView<D, T> grid, int d, float sdv, Bndrule bndrule, const T* bordervalue = nullptr);
+
 //----------------------------------------------------------------------------
 
 template <int COL_D, int D, typename T> CStridedArrayView<T> grid_column(CGridView<D, T> grid, const Vec<int, D>& u0) {
@@ -732,6 +739,129 @@ Grid<D, Pixel> convolve_d(CGridView<D, Pixel> grid, int d, CArrayView<float> ker
   return ngrid;
 }
 
+namespace details {
+
+// Access to the scalar channels of the grid elements blurred by gaussian_blur_d().
+template <typename T> struct BlurChannels;
+
+template <> struct BlurChannels<float> {
+  static constexpr int num = 1;
+  static void get(const float& v, float* a) { a[0] = v; }
+  static float set(const float* a) { return a[0]; }
+};
+
+template <> struct BlurChannels<Vector4> {
+  static constexpr int num = 4;
+  static void get(const Vector4& v, float* a) { for_int(c, 4) a[c] = v[c]; }
+  static Vector4 set(const float* a) { return Vector4(a[0], a[1], a[2], a[3]); }
+};
+
+template <> struct BlurChannels<Pixel> {
+  static constexpr int num = 4;
+  static void get(const Pixel& v, float* a) { for_int(c, 4) a[c] = float(v[c]); }
+  static Pixel set(const float* a) {
+    Pixel pix;
+    for_int(c, 4) pix[c] = clamp_to_uint8(int(a[c] + .5f));
+    return pix;
+  }
+};
+
+// An extended box filter has unit weights over [-r, r] and fractional weights alpha at -(r + 1) and r + 1.
+struct ExtendedBox {
+  int r;
+  float alpha;
+  float scale;  // Reciprocal of the sum of the weights.
+};
+
+// Return the extended box filter with the specified variance.
+inline ExtendedBox extended_box(double variance) {
+  // The box of unit weights over [-r, r] has variance r * (r + 1) / 3.
+  const int r = int(floor(.5 * sqrt(12. * variance + 1.) - .5));
+  const double sum_sq = r * (r + 1.) * (2. * r + 1.) / 3.;  // Sum of x^2 over [-r, r].
+  const double alpha = (variance * (2. * r + 1.) - sum_sq) / (2. * (square(r + 1.) - variance));
+  return {r, float(alpha), float(1. / (2. * r + 1. + 2. * alpha))};
+}
+
+// Set out[k] = box.scale * (in[k - r] + ... + in[k + r] + box.alpha * (in[k - r - 1] + in[k + r + 1])) for k in
+// [k0, k1), where each index k refers to nl contiguous lanes.
+inline void extended_box_pass(const float* __restrict in, float* __restrict out, int k0, int k1,
+                              const ExtendedBox& box, int nl, float* __restrict sum) {
+  const int r = box.r;
+  const float alpha = box.alpha, scale = box.scale;
+  for_int(l, nl) sum[l] = 0.f;
+  for_intL(k, k0 - r, k0 + r) {
+    const float* __restrict ink = in + size_t(k) * nl;
+    for_int(l, nl) sum[l] += ink[l];
+  }
+  for_intL(k, k0, k1) {
+    const float* __restrict in_add = in + size_t(k + r) * nl;
+    const float* __restrict in_sub = in + size_t(k - r) * nl;
+    const float* __restrict in_lo = in + size_t(k - r - 1) * nl;
+    const float* __restrict in_hi = in + size_t(k + r + 1) * nl;
+    float* __restrict outk = out + size_t(k) * nl;
+    for_int(l, nl) {
+      sum[l] += in_add[l];
+      outk[l] = (sum[l] + alpha * (in_lo[l] + in_hi[l])) * scale;
+      sum[l] -= in_sub[l];
+    }
+  }
+}
+
+}  // namespace details
+
+template <int D, typename T>
+Grid<D, T> gaussian_blur_d(CGridView<D, T> grid, int d, float sdv, Bndrule bndrule, const T* bordervalue) {
+  // HH_TIMER("__gaussian_blur_d");
+  using Channels = details::BlurChannels<T>;
+  constexpr int nc = Channels::num;
+  assertx(d >= 0 && d < D && sdv >= 0.f);
+  if (bndrule == Bndrule::border) assertx(bordervalue);
+  const Vec<int, D>& dims = grid.dims();
+  Grid<D, T> ngrid(dims);
+  if (!ngrid.size()) return ngrid;
+  constexpr int k_passes = 4;
+  const details::ExtendedBox box = details::extended_box(square(double(sdv)) / k_passes);
+  const int pad = k_passes * (box.r + 1);  // Each pass consumes r + 1 samples at each end.
+  const int n = dims[d];
+  const int npad = n + 2 * pad;
+  const size_t stride = grid_stride(dims, d);
+  const size_t nlines = grid.size() / n;
+  // Process batches of lines together, so that the inner loops run across lanes (line channels) and vectorize.
+  // Consecutive lines are adjacent in memory unless d is the last dimension.
+  constexpr int k_lines = 16;
+  const size_t nbatches = (nlines + k_lines - 1) / k_lines;
+  const auto line_base = [&](size_t line) { return (line / stride) * n * stride + line % stride; };
+  const uint64_t cycles_per_batch = uint64_t(npad) * k_lines * nc * (k_passes + 2) * 2;
+  parallel_for_chunk({cycles_per_batch}, range(nbatches), get_max_threads(), [&](int, auto subrange) {
+    Array<float> buf0(size_t(npad) * k_lines * nc), buf1(buf0.num()), sum(k_lines * nc);
+    Vec<size_t, k_lines> bases;
+    for (const size_t batch : subrange) {
+      const int nlines_batch = int(std::min<size_t>(k_lines, nlines - batch * k_lines));
+      const int nl = nlines_batch * nc;
+      for_int(j, nlines_batch) bases[j] = line_base(batch * k_lines + j);
+      for_int(k, npad) {
+        int i = k - pad;
+        const bool inside = map_boundaryrule_1D(i, n, bndrule);
+        float* a = buf0.data() + size_t(k) * nl;
+        // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
+        for_int(j, nlines_batch) Channels::get(inside ? grid.flat(bases[j] + i * stride) : *bordervalue, a + j * nc);
+      }
+      float* in = buf0.data();
+      float* out = buf1.data();
+      for_int(pass, k_passes) {
+        const int margin = (pass + 1) * (box.r + 1);
+        details::extended_box_pass(in, out, margin, npad - margin, box, nl, sum.data());
+        std::swap(in, out);
+      }
+      for_int(i, n) {
+        const float* a = in + size_t(i + pad) * nl;
+        for_int(j, nlines_batch) ngrid.flat(bases[j] + i * stride) = Channels::set(a + j * nc);
+      }
+    }
+  });
+  return ngrid;
+}
+
 }  // namespace hh
 
 #endif  // MESH_PROCESSING_LIBHH_GRIDOP_H_
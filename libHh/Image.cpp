@@ -9,6 +9,15 @@
 #include "libHh/Vector4.h"
 #include "libHh/Vector4i.h"
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(_M_X64) || defined(__SSE2__)
+#define HH_IMAGE_SSE2
+#include <emmintrin.h>  // __m128i, _mm_madd_epi16(), etc.
+#endif
+#if defined(__AVX2__)
+#define HH_IMAGE_AVX2
+#include <immintrin.h>  // __m256i, _mm256_madd_epi16(), etc.
+#endif
+
 namespace hh {
 
 Image::Image(const Vec2<int>& pdims) {
@@ -155,6 +164,233 @@ Image scale(const Image& image, const Vec2<float>& syx, const Vec2<FilterBnd>& f
 
 // *** Conversions between YUV and RGB
 
+namespace {
+
+// The vectorized kernels below evaluate exactly the same integer expressions as RGB_Vector4i_from_YUV() and the
+// scalar loops of convert_Image_to_Nv12(), so their results are identical.  Each 128-bit lane processes 16 pixels
+// (NV12 to RGB) or 4 pixels (RGB to NV12) using 16-bit multiply-add instructions into 32-bit sums.
+
+#if defined(HH_IMAGE_SSE2)
+
+// Broadcast the pair of 16-bit values (a, b) to all 32-bit lanes, so that _mm_madd_epi16(v, pair) = a * v0 + b * v1.
+inline __m128i sse2_pair16(int a, int b) { return _mm_set1_epi32(int((uint32_t(uint16_t(b)) << 16) | uint16_t(a))); }
+
+// Convert 16 pixels of a row from 16 Y values and 8 interleaved UV pairs to RGBA (or BGRA) pixels.
+template <bool bgra> inline void sse2_Nv12_to_Pixels_16(const uint8_t* buf_Y, const uint8_t* buf_UV, uint8_t* buf_P) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf_Y));
+  const __m128i uv8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf_UV));
+  const __m128i uv16[2] = {_mm_unpacklo_epi8(uv8, zero), _mm_unpackhi_epi8(uv8, zero)};  // 4 (u, v) pairs each.
+  const __m128i y16[2] = {_mm_unpacklo_epi8(y8, zero), _mm_unpackhi_epi8(y8, zero)};
+  const __m128i coef_y = sse2_pair16(298, 0);
+  const __m128i coef_r = sse2_pair16(0, 409), coef_g = sse2_pair16(-100, -208), coef_b = sse2_pair16(516, 0);
+  const __m128i off_r = _mm_set1_epi32(128 - 298 * 16 - 409 * 128);
+  const __m128i off_g = _mm_set1_epi32(128 - 298 * 16 + 100 * 128 + 208 * 128);
+  const __m128i off_b = _mm_set1_epi32(128 - 298 * 16 - 516 * 128);
+  __m128i r[4], g[4], b[4];  // Each has 4 pixels.
+  for_int(i, 2) {
+    const __m128i cr = _mm_add_epi32(_mm_madd_epi16(uv16[i], coef_r), off_r);  // 4 chroma pairs.
+    const __m128i cg = _mm_add_epi32(_mm_madd_epi16(uv16[i], coef_g), off_g);
+    const __m128i cb = _mm_add_epi32(_mm_madd_epi16(uv16[i], coef_b), off_b);
+    for_int(j, 2) {
+      const __m128i yy = _mm_madd_epi16(j ? _mm_unpackhi_epi16(y16[i], zero) : _mm_unpacklo_epi16(y16[i], zero),
+                                        coef_y);
+      // Each chroma pair is shared by 2 horizontally adjacent pixels.
+      const __m128i dr = j ? _mm_unpackhi_epi32(cr, cr) : _mm_unpacklo_epi32(cr, cr);
+      const __m128i dg = j ? _mm_unpackhi_epi32(cg, cg) : _mm_unpacklo_epi32(cg, cg);
+      const __m128i db = j ? _mm_unpackhi_epi32(cb, cb) : _mm_unpacklo_epi32(cb, cb);
+      r[i * 2 + j] = _mm_srai_epi32(_mm_add_epi32(yy, dr), 8);
+      g[i * 2 + j] = _mm_srai_epi32(_mm_add_epi32(yy, dg), 8);
+      b[i * 2 + j] = _mm_srai_epi32(_mm_add_epi32(yy, db), 8);
+    }
+  }
+  // Saturate to [0, 255] as in Vector4i::pixel().
+  const __m128i r8 = _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]), _mm_packs_epi32(r[2], r[3]));
+  const __m128i g8 = _mm_packus_epi16(_mm_packs_epi32(g[0], g[1]), _mm_packs_epi32(g[2], g[3]));
+  const __m128i b8 = _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]), _mm_packs_epi32(b[2], b[3]));
+  const __m128i a8 = _mm_set1_epi8(char(255));
+  const __m128i c0 = bgra ? b8 : r8, c2 = bgra ? r8 : b8;
+  const __m128i c01[2] = {_mm_unpacklo_epi8(c0, g8), _mm_unpackhi_epi8(c0, g8)};
+  const __m128i c23[2] = {_mm_unpacklo_epi8(c2, a8), _mm_unpackhi_epi8(c2, a8)};
+  __m128i* p = reinterpret_cast<__m128i*>(buf_P);
+  for_int(i, 2) {
+    _mm_storeu_si128(p + i * 2 + 0, _mm_unpacklo_epi16(c01[i], c23[i]));
+    _mm_storeu_si128(p + i * 2 + 1, _mm_unpackhi_epi16(c01[i], c23[i]));
+  }
+}
+
+// Given the 32-bit sums (a0, b0, a1, b1) and (a2, b2, a3, b3), return (a0 + b0, a1 + b1, a2 + b2, a3 + b3).
+inline __m128i sse2_hadd_pairs(__m128i m0, __m128i m1) {
+  const __m128 f0 = _mm_castsi128_ps(m0), f1 = _mm_castsi128_ps(m1);
+  return _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(2, 0, 2, 0))),
+                       _mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+// Convert 2 rows of 16 RGBA pixels to 2 rows of 16 Y values and 8 interleaved UV pairs.
+inline void sse2_Pixels_to_Nv12_16(const uint8_t* buf_p0, const uint8_t* buf_p1, uint8_t* buf_y0, uint8_t* buf_y1,
+                                   uint8_t* buf_UV) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i coef_y = _mm_set_epi16(0, 25, 129, 66, 0, 25, 129, 66);
+  const __m128i coef_u = _mm_set_epi16(0, 112, -74, -38, 0, 112, -74, -38);
+  const __m128i coef_v = _mm_set_epi16(0, -18, -94, 112, 0, -18, -94, 112);
+  const __m128i off_y = _mm_set1_epi32(128 + 16 * 256);
+  const __m128i off_uv = _mm_set1_epi32(128 * 4 + 2 * (-38 - 74 + 112) + 128 * 1024);  // Same for U and V.
+  __m128i y[2][4], uv[4];
+  for_int(i, 4) {  // Each group of 4 pixels in both rows.
+    __m128i sum[2];  // Sums of 2x2 blocks over both rows, as 16-bit RGBA for 2 adjacent pixels.
+    for_int(row, 2) {
+      const __m128i p8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>((row ? buf_p1 : buf_p0) + i * 16));
+      const __m128i p16[2] = {_mm_unpacklo_epi8(p8, zero), _mm_unpackhi_epi8(p8, zero)};  // 2 pixels each.
+      y[row][i] = _mm_srai_epi32(
+          _mm_add_epi32(sse2_hadd_pairs(_mm_madd_epi16(p16[0], coef_y), _mm_madd_epi16(p16[1], coef_y)), off_y), 8);
+      for_int(j, 2) sum[j] = row ? _mm_add_epi16(sum[j], p16[j]) : p16[j];
+    }
+    // Add the two horizontally adjacent pixels and gather the two 2x2 blocks into one vector.
+    const __m128i block = _mm_unpacklo_epi64(_mm_add_epi16(sum[0], _mm_srli_si128(sum[0], 8)),
+                                             _mm_add_epi16(sum[1], _mm_srli_si128(sum[1], 8)));
+    const __m128i u_v = sse2_hadd_pairs(_mm_madd_epi16(block, coef_u), _mm_madd_epi16(block, coef_v));
+    uv[i] = _mm_shuffle_epi32(_mm_srai_epi32(_mm_add_epi32(u_v, off_uv), 10), _MM_SHUFFLE(3, 1, 2, 0));
+  }
+  for_int(row, 2) {
+    const __m128i y8 = _mm_packus_epi16(_mm_packs_epi32(y[row][0], y[row][1]), _mm_packs_epi32(y[row][2], y[row][3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(row ? buf_y1 : buf_y0), y8);
+  }
+  const __m128i uv8 = _mm_packus_epi16(_mm_packs_epi32(uv[0], uv[1]), _mm_packs_epi32(uv[2], uv[3]));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(buf_UV), uv8);
+}
+
+#endif  // defined(HH_IMAGE_SSE2)
+
+#if defined(HH_IMAGE_AVX2)
+
+// The AVX2 kernels apply the same computations as the SSE2 kernels independently within each 128-bit lane.
+
+inline __m256i avx2_pair16(int a, int b) {
+  return _mm256_set1_epi32(int((uint32_t(uint16_t(b)) << 16) | uint16_t(a)));
+}
+
+inline __m256i avx2_load_2x128(const uint8_t* p0, const uint8_t* p1) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0))),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1)), 1);
+}
+
+// Convert 32 pixels of a row from 32 Y values and 16 interleaved UV pairs to RGBA (or BGRA) pixels.
+template <bool bgra> inline void avx2_Nv12_to_Pixels_32(const uint8_t* buf_Y, const uint8_t* buf_UV, uint8_t* buf_P) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i y8 = avx2_load_2x128(buf_Y, buf_Y + 16);     // Lane 1 has pixels 16..31.
+  const __m256i uv8 = avx2_load_2x128(buf_UV, buf_UV + 16);
+  const __m256i uv16[2] = {_mm256_unpacklo_epi8(uv8, zero), _mm256_unpackhi_epi8(uv8, zero)};
+  const __m256i y16[2] = {_mm256_unpacklo_epi8(y8, zero), _mm256_unpackhi_epi8(y8, zero)};
+  const __m256i coef_y = avx2_pair16(298, 0);
+  const __m256i coef_r = avx2_pair16(0, 409), coef_g = avx2_pair16(-100, -208), coef_b = avx2_pair16(516, 0);
+  const __m256i off_r = _mm256_set1_epi32(128 - 298 * 16 - 409 * 128);
+  const __m256i off_g = _mm256_set1_epi32(128 - 298 * 16 + 100 * 128 + 208 * 128);
+  const __m256i off_b = _mm256_set1_epi32(128 - 298 * 16 - 516 * 128);
+  __m256i r[4], g[4], b[4];
+  for_int(i, 2) {
+    const __m256i cr = _mm256_add_epi32(_mm256_madd_epi16(uv16[i], coef_r), off_r);
+    const __m256i cg = _mm256_add_epi32(_mm256_madd_epi16(uv16[i], coef_g), off_g);
+    const __m256i cb = _mm256_add_epi32(_mm256_madd_epi16(uv16[i], coef_b), off_b);
+    for_int(j, 2) {
+      const __m256i yy = _mm256_madd_epi16(
+          j ? _mm256_unpackhi_epi16(y16[i], zero) : _mm256_unpacklo_epi16(y16[i], zero), coef_y);
+      const __m256i dr = j ? _mm256_unpackhi_epi32(cr, cr) : _mm256_unpacklo_epi32(cr, cr);
+      const __m256i dg = j ? _mm256_unpackhi_epi32(cg, cg) : _mm256_unpacklo_epi32(cg, cg);
+      const __m256i db = j ? _mm256_unpackhi_epi32(cb, cb) : _mm256_unpacklo_epi32(cb, cb);
+      r[i * 2 + j] = _mm256_srai_epi32(_mm256_add_epi32(yy, dr), 8);
+      g[i * 2 + j] = _mm256_srai_epi32(_mm256_add_epi32(yy, dg), 8);
+      b[i * 2 + j] = _mm256_srai_epi32(_mm256_add_epi32(yy, db), 8);
+    }
+  }
+  const __m256i r8 = _mm256_packus_epi16(_mm256_packs_epi32(r[0], r[1]), _mm256_packs_epi32(r[2], r[3]));
+  const __m256i g8 = _mm256_packus_epi16(_mm256_packs_epi32(g[0], g[1]), _mm256_packs_epi32(g[2], g[3]));
+  const __m256i b8 = _mm256_packus_epi16(_mm256_packs_epi32(b[0], b[1]), _mm256_packs_epi32(b[2], b[3]));
+  const __m256i a8 = _mm256_set1_epi8(char(255));
+  const __m256i c0 = bgra ? b8 : r8, c2 = bgra ? r8 : b8;
+  const __m256i c01[2] = {_mm256_unpacklo_epi8(c0, g8), _mm256_unpackhi_epi8(c0, g8)};
+  const __m256i c23[2] = {_mm256_unpacklo_epi8(c2, a8), _mm256_unpackhi_epi8(c2, a8)};
+  __m256i out[4];  // Lane 0 of out[k] has pixels 4 * k..4 * k + 3; lane 1 has pixels 16 + 4 * k..16 + 4 * k + 3.
+  for_int(i, 2) {
+    out[i * 2 + 0] = _mm256_unpacklo_epi16(c01[i], c23[i]);
+    out[i * 2 + 1] = _mm256_unpackhi_epi16(c01[i], c23[i]);
+  }
+  __m256i* p = reinterpret_cast<__m256i*>(buf_P);
+  _mm256_storeu_si256(p + 0, _mm256_permute2x128_si256(out[0], out[1], 0x20));
+  _mm256_storeu_si256(p + 1, _mm256_permute2x128_si256(out[2], out[3], 0x20));
+  _mm256_storeu_si256(p + 2, _mm256_permute2x128_si256(out[0], out[1], 0x31));
+  _mm256_storeu_si256(p + 3, _mm256_permute2x128_si256(out[2], out[3], 0x31));
+}
+
+inline __m256i avx2_hadd_pairs(__m256i m0, __m256i m1) {
+  const __m256 f0 = _mm256_castsi256_ps(m0), f1 = _mm256_castsi256_ps(m1);
+  return _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(2, 0, 2, 0))),
+                          _mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+// Convert 2 rows of 32 RGBA pixels to 2 rows of 32 Y values and 16 interleaved UV pairs.
+inline void avx2_Pixels_to_Nv12_32(const uint8_t* buf_p0, const uint8_t* buf_p1, uint8_t* buf_y0, uint8_t* buf_y1,
+                                   uint8_t* buf_UV) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i coef_y = _mm256_set_epi16(0, 25, 129, 66, 0, 25, 129, 66, 0, 25, 129, 66, 0, 25, 129, 66);
+  const __m256i coef_u = _mm256_set_epi16(0, 112, -74, -38, 0, 112, -74, -38, 0, 112, -74, -38, 0, 112, -74, -38);
+  const __m256i coef_v = _mm256_set_epi16(0, -18, -94, 112, 0, -18, -94, 112, 0, -18, -94, 112, 0, -18, -94, 112);
+  const __m256i off_y = _mm256_set1_epi32(128 + 16 * 256);
+  const __m256i off_uv = _mm256_set1_epi32(128 * 4 + 2 * (-38 - 74 + 112) + 128 * 1024);
+  __m256i y[2][4], uv[4];
+  for_int(i, 4) {  // Each group of 8 pixels in both rows.
+    __m256i sum[2];
+    for_int(row, 2) {
+      const __m256i p8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((row ? buf_p1 : buf_p0) + i * 32));
+      const __m256i p16[2] = {_mm256_unpacklo_epi8(p8, zero), _mm256_unpackhi_epi8(p8, zero)};
+      y[row][i] = _mm256_srai_epi32(
+          _mm256_add_epi32(avx2_hadd_pairs(_mm256_madd_epi16(p16[0], coef_y), _mm256_madd_epi16(p16[1], coef_y)),
+                           off_y),
+          8);
+      for_int(j, 2) sum[j] = row ? _mm256_add_epi16(sum[j], p16[j]) : p16[j];
+    }
+    const __m256i block = _mm256_unpacklo_epi64(_mm256_add_epi16(sum[0], _mm256_srli_si256(sum[0], 8)),
+                                                _mm256_add_epi16(sum[1], _mm256_srli_si256(sum[1], 8)));
+    const __m256i u_v = avx2_hadd_pairs(_mm256_madd_epi16(block, coef_u), _mm256_madd_epi16(block, coef_v));
+    uv[i] = _mm256_shuffle_epi32(_mm256_srai_epi32(_mm256_add_epi32(u_v, off_uv), 10), _MM_SHUFFLE(3, 1, 2, 0));
+  }
+  // The in-lane packing interleaves groups of 4 bytes across lanes; restore their order.
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  for_int(row, 2) {
+    const __m256i y8 = _mm256_packus_epi16(_mm256_packs_epi32(y[row][0], y[row][1]),
+                                           _mm256_packs_epi32(y[row][2], y[row][3]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(row ? buf_y1 : buf_y0), _mm256_permutevar8x32_epi32(y8, order));
+  }
+  const __m256i uv8 = _mm256_packus_epi16(_mm256_packs_epi32(uv[0], uv[1]), _mm256_packs_epi32(uv[2], uv[3]));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(buf_UV), _mm256_permutevar8x32_epi32(uv8, order));
+}
+
+#endif  // defined(HH_IMAGE_AVX2)
+
+// Convert one row of NV12 to RGBA (or BGRA) pixels, using vector instructions where available.
+template <bool bgra> void convert_Nv12_row(const uint8_t* buf_Y, const uint8_t* buf_UV, Pixel* buf_P, int nx) {
+  int x = 0;
+#if defined(HH_IMAGE_AVX2)
+  for (; x + 32 <= nx; x += 32) avx2_Nv12_to_Pixels_32<bgra>(buf_Y + x, buf_UV + x, buf_P[x].data());
+#endif
+#if defined(HH_IMAGE_SSE2)
+  for (; x + 16 <= nx; x += 16) sse2_Nv12_to_Pixels_16<bgra>(buf_Y + x, buf_UV + x, buf_P[x].data());
+#endif
+  const Vector4i yscale(298, 298, 298, 0);
+  for (; x < nx; x += 2) {
+    const int u = buf_UV[x + 0], v = buf_UV[x + 1];
+    const Vector4i vi0 = bgra ? (Vector4i(-16 * 298 + 128 - 516 * 128, -16 * 298 + 128 + 100 * 128 + 208 * 128,
+                                          -16 * 298 + 128 - 409 * 128, 255 * 256) +
+                                 Vector4i(516, -100, 0, 0) * u + Vector4i(0, -208, 409, 0) * v)
+                              : (Vector4i(-16 * 298 + 128 - 409 * 128, -16 * 298 + 128 + 100 * 128 + 208 * 128,
+                                          -16 * 298 + 128 - 516 * 128, 255 * 256) +
+                                 Vector4i(0, -100, 516, 0) * u + Vector4i(409, -208, 0, 0) * v);
+    buf_P[x + 0] = ((vi0 + yscale * buf_Y[x + 0]) >> 8).pixel();
+    buf_P[x + 1] = ((vi0 + yscale * buf_Y[x + 1]) >> 8).pixel();
+  }
+}
+
+}  // namespace
+
 void convert_Nv12_to_Image(CNv12View nv12v, MatrixView<Pixel> frame) {
   assertx(same_size(nv12v.get_Y(), frame));
   const uint8_t* buf_Y = nv12v.get_Y().data();
@@ -229,52 +465,18 @@ void convert_Nv12_to_Image(CNv12View nv12v, MatrixView<Pixel> frame) {
       pP += rowlen;
     }
   } else if (1) {
-    const int rowlen = frame.xsize();
-    for_int(y, frame.ysize() / 2) {
-      for_int(x, frame.xsize() / 2) {
-        int u = buf_UV[0], v = buf_UV[1];
-        Vector4i vi0 = (Vector4i(-16 * 298 + 128 - 409 * 128, -16 * 298 + 128 + 100 * 128 + 208 * 128,
-                                 -16 * 298 + 128 - 516 * 128, 255 * 256) +
-                        Vector4i(0, -100, 516, 0) * u + Vector4i(409, -208, 0, 0) * v);
-        const Vector4i yscale(298, 298, 298, 0);
-        buf_P[0 * rowlen + 0] = ((vi0 + yscale * buf_Y[0 * rowlen + 0]) >> 8).pixel();  // OPT:YUV4
-        buf_P[0 * rowlen + 1] = ((vi0 + yscale * buf_Y[0 * rowlen + 1]) >> 8).pixel();
-        buf_P[1 * rowlen + 0] = ((vi0 + yscale * buf_Y[1 * rowlen + 0]) >> 8).pixel();
-        buf_P[1 * rowlen + 1] = ((vi0 + yscale * buf_Y[1 * rowlen + 1]) >> 8).pixel();
-        buf_Y += 2;
-        buf_UV += 2;
-        buf_P += 2;
-      }
-      buf_Y += rowlen;
-      buf_P += rowlen;
+    for_int(y, frame.ysize()) {
+      convert_Nv12_row<false>(nv12v.get_Y()[y].data(), nv12v.get_UV()[y / 2].data()->data(), frame[y].data(),
+                              frame.xsize());  // OPT:YUV5
     }
   }
 }
 
 void convert_Nv12_to_Image_BGRA(CNv12View nv12v, MatrixView<Pixel> frame) {
   assertx(same_size(nv12v.get_Y(), frame));
-  const uint8_t* buf_Y = nv12v.get_Y().data();
-  const uint8_t* buf_UV = nv12v.get_UV().data()->data();
-  Pixel* buf_P = frame.data();
-  assertx(reinterpret_cast<uintptr_t>(buf_P) % 4 == 0);
-  const int rowlen = frame.xsize();
-  for_int(y, frame.ysize() / 2) {
-    for_int(x, frame.xsize() / 2) {
-      int u = buf_UV[0], v = buf_UV[1];
-      Vector4i vi0 = (Vector4i(-16 * 298 + 128 - 516 * 128, -16 * 298 + 128 + 100 * 128 + 208 * 128,
-                               -16 * 298 + 128 - 409 * 128, 255 * 256) +
-                      Vector4i(516, -100, 0, 0) * u + Vector4i(0, -208, 409, 0) * v);
-      const Vector4i yscale(298, 298, 298, 0);
-      buf_P[0 * rowlen + 0] = ((vi0 + yscale * buf_Y[0 * rowlen + 0]) >> 8).pixel();  // OPT:YUV4
-      buf_P[0 * rowlen + 1] = ((vi0 + yscale * buf_Y[0 * rowlen + 1]) >> 8).pixel();
-      buf_P[1 * rowlen + 0] = ((vi0 + yscale * buf_Y[1 * rowlen + 0]) >> 8).pixel();
-      buf_P[1 * rowlen + 1] = ((vi0 + yscale * buf_Y[1 * rowlen + 1]) >> 8).pixel();
-      buf_Y += 2;
-      buf_UV += 2;
-      buf_P += 2;
-    }
-    buf_Y += rowlen;
-    buf_P += rowlen;
+  for_int(y, frame.ysize()) {
+    convert_Nv12_row<true>(nv12v.get_Y()[y].data(), nv12v.get_UV()[y / 2].data()->data(), frame[y].data(),
+                           frame.xsize());
   }
 }
 
@@ -336,7 +538,24 @@ void convert_Image_to_Nv12(CMatrixView<Pixel> frame, Nv12View nv12v) {
       const uint8_t* __restrict buf_p0 = frame[y * 2 + 0].data()->data();
       uint8_t* __restrict buf_y0 = nv12v.get_Y()[y * 2 + 0].data();
       const int hnx = frame.xsize() / 2;
-      for_int(x, hnx) {
+      int x = 0;
+#if defined(HH_IMAGE_AVX2)
+      for (; x + 16 <= hnx; x += 16) {
+        avx2_Pixels_to_Nv12_32(buf_p0, buf_p0 + hnx * 8, buf_y0, buf_y0 + 2 * hnx, buf_UV);
+        buf_p0 += 128;
+        buf_y0 += 32;
+        buf_UV += 32;
+      }
+#endif
+#if defined(HH_IMAGE_SSE2)
+      for (; x + 8 <= hnx; x += 8) {
+        sse2_Pixels_to_Nv12_16(buf_p0, buf_p0 + hnx * 8, buf_y0, buf_y0 + 2 * hnx, buf_UV);
+        buf_p0 += 64;
+        buf_y0 += 16;
+        buf_UV += 16;
+      }
+#endif
+      for (; x < hnx; x++) {
         int r00 = buf_p0[0], g00 = buf_p0[1], b00 = buf_p0[2];
         uint8_t y00 = uint8_t((66 * r00 + 129 * g00 + 25 * b00 + 128 + 16 * 256) >> 8);
         int r01 = buf_p0[4], g01 = buf_p0[5], b01 = buf_p0[6];
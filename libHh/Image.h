@@ -176,6 +176,11 @@ class Nv12 {
   CMatrixView<uint8_t> get_Y() const { return _mat_Y; }
   MatrixView<Vec2<uint8_t>> get_UV() { return _mat_UV; }
   CMatrixView<Vec2<uint8_t>> get_UV() const { return _mat_UV; }
+  friend void swap(Nv12& l, Nv12& r) noexcept {
+    using std::swap;
+    swap(l._mat_Y, r._mat_Y);
+    swap(l._mat_UV, r._mat_UV);
+  }
 
  private:
   Matrix<uint8_t> _mat_Y;         // Luminance.
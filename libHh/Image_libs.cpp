@@ -1179,6 +1179,11 @@ using namespace details;
 void Image::read_file_libs(const string& filename, bool bgra) {
   RFile fi(filename);
   FILE* file = fi.cfile();
+  if (!file) {  // The file is decompressed in-process, so provide a FILE* on a decompressed copy.
+    TmpFile tmp_file("", fi());
+    read_file_libs(tmp_file.filename(), bgra);
+    return;
+  }
   int c = getc(file);
   if (c < 0) throw std::runtime_error("empty image file '" + filename + "'");
   assertt(c >= 0 && c <= 255);
@@ -1207,6 +1212,12 @@ void Image::write_file_libs(const string& filename, bool bgra) const {
   if (suffix() == "") throw std::runtime_error("Image '" + filename + "': no filename suffix specified for writing");
   WFile fi(filename);
   FILE* file = fi.cfile();
+  if (!file) {  // The file is compressed in-process, so write a FILE* on an uncompressed copy.
+    TmpFile tmp_file;
+    write_file_libs(tmp_file.filename(), bgra);
+    tmp_file.write_to(fi());
+    return;
+  }
   const ImageFiletype* filetype = nullptr;
   for (auto& imagefiletype : k_image_filetypes) {
     if (suffix() == imagefiletype.suffix) {
@@ -1,6 +1,8 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
 #include "libHh/Mesh.h"
 
+#include <functional>  // less<>
+
 #include "libHh/Array.h"
 #include "libHh/Parallel.h"
 #include "libHh/Random.h"
@@ -64,12 +66,25 @@ Mesh& Mesh::operator=(Mesh&& m) noexcept {
 
 void Mesh::clear() {
   if (debug() >= 1) ok();
-  while (num_faces()) {
-    destroy_face(_id2face.get_one_value());
-  }
-  while (!empty()) {
-    destroy_vertex(_id2vertex.get_one_value());
+  will_clear();
+  // Rather than maintaining the adjacencies while removing each element, run the element destructors (which destroy
+  // the strings and Sac fields) and then release all the arena memory at once.
+  for (Face f : faces()) {
+    HEdge he = herep(f), hef = he;
+    for (;;) {
+      HEdge hen = he->_next;
+      // Destroy each Edge once, from its half-edge with the smaller address; this only reads fields of he.
+      if (!he->_sym || std::less<HEdge>()(he, he->_sym)) he->_edge->~MEdge();
+      he->~MHEdge();
+      he = hen;
+      if (he == hef) break;
+    }
+    f->~MFace();
   }
+  for (Vertex v : vertices()) v->~MVertex();
+  _id2vertex.clear();
+  _id2face.clear();
+  _arena.release();
   _vertexnum = 1;
   _facenum = 1;
   _nedges = 0;
@@ -96,11 +111,42 @@ void Mesh::copy(const Mesh& m) {
   }
 }
 
+void Mesh::copy_faces(const Mesh& m, CArrayView<Face> fa) {
+  clear();
+  _flags = m._flags;
+  Array<Vertex> va;
+  for (Face f : fa) {
+    m.get_vertices(f, va);
+    for_int(i, va.num()) {
+      Vertex v = va[i];
+      bool present;
+      Vertex vn = _id2vertex.retrieve(m.vertex_id(v), present);
+      if (!present) {
+        vn = create_vertex_private(m.vertex_id(v));
+        vn->_flags = v->_flags;
+      }
+      va[i] = vn;
+    }
+    Face fn = create_face_private(m.face_id(f), va);
+    fn->_flags = f->_flags;
+  }
+  for (Face f : fa) {
+    for (Edge e : m.edges(f)) {
+      if (!e->_flags) continue;
+      Edge en = ordered_edge(id_vertex(m.vertex_id(m.vertex1(e))), id_vertex(m.vertex_id(m.vertex2(e))));
+      en->_flags = e->_flags;
+    }
+  }
+  // Keep assigning the same ids to subsequently created elements.
+  _vertexnum = m._vertexnum;
+  _facenum = m._facenum;
+}
+
 // *** Raw manipulation
 
 Vertex Mesh::create_vertex_private(int id) {
   assertx(id >= 1);
-  Vertex v = new MVertex(id);
+  Vertex v = arena_new<MVertex>(k_arena_vertex, id);
   // v->point undefined
   _id2vertex.enter(id, v);
   _vertexnum = max(_vertexnum, id + 1);
@@ -111,7 +157,7 @@ void Mesh::destroy_vertex(Vertex v) {
   assertx(!herep(v));
   assertx(_id2vertex.remove(v->_id));
   if (0 && _vertexnum - 1 == v->_id) --_vertexnum;  // intermittent reuse of vertex id might be unsafe
-  delete v;
+  arena_delete(k_arena_vertex, v);
 }
 
 bool Mesh::legal_create_face(CArrayView<Vertex> va) const {
@@ -140,14 +186,14 @@ Face Mesh::create_face_private(int id, CArrayView<Vertex> va) {
   assertx(id >= 1);
   assertx(va.num() >= 3);
   if (debug() >= 1) assertx(legal_create_face(va));
-  Face f = new MFace(id);
+  Face f = arena_new<MFace>(k_arena_face, id);
   // f->herep defined below
   _id2face.enter(id, f);
   HEdge hep = nullptr;
   int nv = va.num();
   for_int(i, nv) {
     Vertex v2 = va[i + 1 == nv ? 0 : i + 1];
-    HEdge he = new MHEdge;
+    HEdge he = arena_new<MHEdge>(k_arena_hedge);
     he->_prev = hep;
     // he->_next is set below
     he->_vert = v2;
@@ -180,7 +226,7 @@ void Mesh::destroy_face(Face f) {
       HEdge hen = he->_next;
       Vertex v1n = he->_vert;
       remove_hedge(he, v1);
-      delete he;
+      arena_delete(k_arena_hedge, he);
       he = hen;
       v1 = v1n;
       if (he == hef) break;
@@ -188,7 +234,7 @@ void Mesh::destroy_face(Face f) {
   }
   assertx(_id2face.remove(f->_id));
   if (0 && _facenum - 1 == f->_id) --_facenum;  // intermittent reuse of face id might be unsafe
-  delete f;
+  arena_delete(k_arena_face, f);
   if (debug() >= 3) ok();
 }
 
@@ -1049,14 +1095,24 @@ bool Mesh::valid(Corner c) const {
 
 // *** Iterators
 
-Mesh::OrderedVertices_range::OrderedVertices_range(const Mesh& mesh) : _vertices(mesh.vertices()) {
-  const auto by_increasing_vertex_id = [&](Vertex v1, Vertex v2) { return mesh.vertex_id(v1) < mesh.vertex_id(v2); };
-  sort(_vertices, by_increasing_vertex_id);
+// The (id, element) pairs are sorted by id, so that the comparisons need not access the scattered elements.
+
+Mesh::OrderedVertices_range::OrderedVertices_range(const Mesh& mesh) {
+  Array<std::pair<int, Vertex>> pairs;
+  pairs.reserve(mesh.num_vertices());
+  for (auto& [id, v] : mesh._id2vertex) pairs.push({id, v});
+  sort(pairs);
+  _vertices.init(pairs.num());
+  for_int(i, pairs.num()) _vertices[i] = pairs[i].second;
 }
 
-Mesh::OrderedFaces_range::OrderedFaces_range(const Mesh& mesh) : _faces(mesh.faces()) {
-  const auto by_increasing_face_id = [&](Face f1, Face f2) { return mesh.face_id(f1) < mesh.face_id(f2); };
-  sort(_faces, by_increasing_face_id);
+Mesh::OrderedFaces_range::OrderedFaces_range(const Mesh& mesh) {
+  Array<std::pair<int, Face>> pairs;
+  pairs.reserve(mesh.num_faces());
+  for (auto& [id, f] : mesh._id2face) pairs.push({id, f});
+  sort(pairs);
+  _faces.init(pairs.num());
+  for_int(i, pairs.num()) _faces[i] = pairs[i].second;
 }
 
 // *** Mesh protected
@@ -1117,7 +1173,7 @@ void Mesh::enter_hedge(HEdge he, Vertex v1) {
     if (he->_vert->_id > hes->_vert->_id) e->_herep = he;
   } else {
     _nedges++;
-    Edge e = new MEdge(he);
+    Edge e = arena_new<MEdge>(k_arena_edge, he);
     he->_edge = e;
   }
 }
@@ -1143,7 +1199,7 @@ void Mesh::remove_hedge(HEdge he, Vertex v1) {
   } else {
     --_nedges;
     // e->herep = nullptr;     // optional
-    delete e;
+    arena_delete(k_arena_edge, e);
   }
   // he->_edge = nullptr;         // optional
   assertx(v1->_arhe.remove_unordered(he));  // slow, shucks
@@ -1155,7 +1211,7 @@ void Mesh::create_bogus_hedges(ArrayView<HEdge> ar_he) {
     if (is_boundary(he)) {
       HEdge heo = he;
       Vertex v1 = heo->_vert;
-      he = new MHEdge;
+      he = arena_new<MHEdge>(k_arena_hedge);
       HH_ASSUME(heo->_prev);
       he->_vert = heo->_prev->_vert;
       he->_prev = nullptr;  // note: temporarily causes mesh.ok() to fail
@@ -1173,7 +1229,7 @@ void Mesh::remove_bogus_hedges(CArrayView<HEdge> ar_he) {
     if (!he) continue;
     Vertex v1 = reinterpret_cast<Vertex>(he->_face);  // temporary overload
     remove_hedge(he, v1);
-    delete he;
+    arena_delete(k_arena_hedge, he);
   }
 }
 
@@ -4,6 +4,7 @@
 
 #include "libHh/Array.h"
 #include "libHh/Flags.h"
+#include "libHh/FlatHash.h"
 #include "libHh/Geometry.h"  // because of Point, too bad.
 #include "libHh/Map.h"
 #include "libHh/PArray.h"
@@ -39,6 +40,8 @@ class Random;
 //
 // MVertex allocates space for Point, which is used later in GMesh.
 // MVertex, MFace, MEdge, MHEdge allocate space for string, also used in GMesh.
+// A Mesh may be queried concurrently, but its modifications (including element creation) must be serialized: the
+// per-mesh element arena and id maps are not threadsafe.
 
 class Mesh : noncopyable {
  public:  // for use by Sac
@@ -57,8 +60,8 @@ class Mesh : noncopyable {
   friend void swap(Mesh& l, Mesh& r) noexcept;
 
  private:
-  using Vertices_range = Map<int, Vertex>::cvalues_range;
-  using Faces_range = Map<int, Face>::cvalues_range;
+  using Vertices_range = FlatMap<int, Vertex, FlatDenseHash>::cvalues_range;
+  using Faces_range = FlatMap<int, Face, FlatDenseHash>::cvalues_range;
   struct Edges_range;
   struct OrderedVertices_range;
   struct OrderedFaces_range;
@@ -84,6 +87,8 @@ class Mesh : noncopyable {
   Mesh& operator=(Mesh&& m) noexcept;
   void clear();
   void copy(const Mesh& m);  // not a GMesh!  carries flags (but not sac fields), hence not named operator=().
+  // Like copy() but only the faces in fa and their vertices; much faster than many destroy_face() calls.
+  void copy_faces(const Mesh& m, CArrayView<Face> fa);
 
   // ** Raw manipulation functions, may lead to non-nice Meshes:
   // always legal
@@ -347,8 +352,8 @@ class Mesh : noncopyable {
     }
 
    private:
-    CArrayView<HEdge>::iterator _hcur{nullptr}, _hend{nullptr};  // _hcur points at current element
-    Map<int, Vertex>::cvalues_iterator _vcur, _vend;             // _vcur points one vertex ahead
+    CArrayView<HEdge>::iterator _hcur{nullptr}, _hend{nullptr};          // _hcur points at current element
+    FlatMap<int, Vertex, FlatDenseHash>::cvalues_iterator _vcur, _vend;  // _vcur points one vertex ahead
     void next() {
       for (;;) {
         if (_hcur != _hend) {
@@ -810,10 +815,16 @@ class Mesh : noncopyable {
 
  protected:
   static int debug();  // 0=no, 1=min, 2=max
+  // Called by clear() before it destroys all elements at once, without calling destroy_face() or destroy_vertex().
+  virtual void will_clear() {}
+
  private:
+  // Elements are allocated from a per-mesh arena, so that clear() releases all their memory at once.
+  enum { k_arena_vertex, k_arena_face, k_arena_edge, k_arena_hedge, k_arena_num };
+  PoolArena<k_arena_num> _arena;
   Flags _flags;
-  Map<int, Vertex> _id2vertex;  // also acts as set of vertices
-  Map<int, Face> _id2face;      // also acts as set of faces
+  FlatMap<int, Vertex, FlatDenseHash> _id2vertex;  // also acts as set of vertices
+  FlatMap<int, Face, FlatDenseHash> _id2face;      // also acts as set of faces
   int _vertexnum{1};            // id to assign to next new vertex
   int _facenum{1};              // id to assign to next new face
   int _nedges{0};
@@ -848,6 +859,13 @@ class Mesh : noncopyable {
   void create_bogus_hedges(ArrayView<HEdge> ar_he);
   void remove_bogus_hedges(CArrayView<HEdge> ar_he);
   Array<Vertex> gather_edge_coalesce_vertices(Edge e) const;
+  template <typename T, typename... Args> T* arena_new(int k, Args&&... args) {
+    return new (_arena.alloc(k, T::sac_alloc_align(), T::sac_alloc_size())) T(std::forward<Args>(args)...);
+  }
+  template <typename T> void arena_delete(int k, T* p) {
+    p->~T();
+    _arena.free(k, p);
+  }
 };
 
 using Vertex = Mesh::Vertex;
@@ -886,6 +904,7 @@ HH_INITIALIZE_POOL_NESTED(Mesh::MHEdge, MeshMHEdge);
 
 inline void swap(Mesh& l, Mesh& r) noexcept {
   using std::swap;
+  swap(l._arena, r._arena);
   swap(l._flags, r._flags);
   swap(l._id2vertex, r._id2vertex);
   swap(l._id2face, r._id2face);
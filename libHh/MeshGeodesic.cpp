@@ -0,0 +1,208 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/MeshGeodesic.h"
+
+#include "libHh/Parallel.h"
+#include "libHh/Pqueue.h"
+#include "libHh/RangeOp.h"  // fill()
+
+namespace hh {
+
+namespace {
+
+// Frontier size above which the edge relaxations within a delta-stepping phase are evaluated in parallel.
+constexpr int k_parallel_frontier = 512;
+
+// Distance at point p given distances d1 and d2 at the other two vertices p1 and p2 of a triangle, assuming a locally
+// planar front.  Falls back to propagation along either edge if the front does not arrive from within the triangle.
+float fast_marching_update(const Point& p, const Point& p1, const Point& p2, float d1, float d2) {
+  const Vector a = p1 - p, b = p2 - p;
+  const double aa = dot(a, a), ab = dot(a, b), bb = dot(b, b);
+  const float d_edges = min(d1 + float(sqrt(aa)), d2 + float(sqrt(bb)));
+  const double det = aa * bb - ab * ab;
+  if (det <= 0.) return d_edges;
+  // Q is the inverse of the Gram matrix of (a, b); solve for d such that the gradient of the linear interpolation of
+  // (d1, d2, d) over the triangle has unit length.
+  const double q11 = bb / det, q12 = -ab / det, q22 = aa / det;
+  const double sq = q11 + 2. * q12 + q22;
+  const double st = (q11 + q12) * d1 + (q12 + q22) * d2;
+  const double tt = q11 * d1 * d1 + 2. * q12 * d1 * d2 + q22 * d2 * d2;
+  const double disc = st * st - sq * (tt - 1.);
+  if (disc < 0.) return d_edges;
+  const double d = (st + sqrt(disc)) / sq;
+  // Upwind condition: the gradient must be a nonpositive combination of a and b.
+  const double e1 = d1 - d, e2 = d2 - d;
+  if (q11 * e1 + q12 * e2 > 0. || q12 * e1 + q22 * e2 > 0.) return d_edges;
+  return min(d_edges, float(d));
+}
+
+}  // namespace
+
+MeshGeodesic::MeshGeodesic(const GMesh& mesh) {
+  _vertices.reserve(mesh.num_vertices());
+  for (Vertex v : mesh.vertices()) {
+    _mvi.enter(v, _vertices.num());
+    _vertices.push(v);
+  }
+  _points.reserve(num());
+  for (Vertex v : _vertices) _points.push(mesh.point(v));
+  _offsets.reserve(num() + 1);
+  _offsets.push(0);
+  _neighbors.reserve(mesh.num_edges() * 2);
+  _lengths.reserve(mesh.num_edges() * 2);
+  _tri_offsets.reserve(num() + 1);
+  _tri_offsets.push(0);
+  _tri_opposite.reserve(mesh.num_faces() * 3);
+  double sum_length = 0.;
+  for_int(i, num()) {
+    const Vertex v = _vertices[i];
+    for (Vertex vv : mesh.vertices(v)) {
+      const int j = _mvi.get(vv);
+      const float length = dist(_points[i], _points[j]);
+      _neighbors.push(j);
+      _lengths.push(length);
+      _max_length = max(_max_length, length);
+      sum_length += length;
+    }
+    _offsets.push(_neighbors.num());
+    for (Corner c : mesh.corners(v)) {
+      const Face f = mesh.corner_face(c);
+      if (!mesh.is_triangle(f)) continue;
+      const Vertex v1 = mesh.corner_vertex(mesh.ccw_face_corner(c));
+      const Vertex v2 = mesh.corner_vertex(mesh.clw_face_corner(c));
+      _tri_opposite.push(V(_mvi.get(v1), _mvi.get(v2)));
+    }
+    _tri_offsets.push(_tri_opposite.num());
+  }
+  _delta = _neighbors.num() ? float(sum_length / _neighbors.num()) : 1.f;
+  if (!_delta) _delta = 1.f;
+}
+
+void MeshGeodesic::distances(CArrayView<int> sources, ArrayView<float> dist, EMetric metric, float max_dist) const {
+  assertx(dist.num() == num());
+  for (const int i : sources) assertx(i >= 0 && i < num());
+  switch (metric) {
+    case EMetric::graph: delta_stepping(sources, dist, max_dist); break;
+    case EMetric::fast_marching: fast_marching(sources, dist, max_dist); break;
+    default: assertnever("");
+  }
+}
+
+Matrix<float> MeshGeodesic::distances_from_each(CArrayView<int> sources, EMetric metric, float max_dist) const {
+  Matrix<float> dists(sources.num(), num());
+  const uint64_t cycles_per_source = 40 * uint64_t(_neighbors.num() + num());
+  parallel_for_each({cycles_per_source}, range(sources.num()),
+                    [&](const int s) { distances(sources.slice(s, s + 1), dists[s], metric, max_dist); });
+  return dists;
+}
+
+// Delta-stepping [Meyer and Sanders 2003]: vertices are kept in buckets of tentative distance of width _delta.
+// The smallest nonempty bucket is settled by repeatedly relaxing the light edges (length <= _delta) of its vertices,
+// which can only reinsert vertices into the same bucket, and then relaxing the heavy edges of all its vertices once.
+void MeshGeodesic::delta_stepping(CArrayView<int> sources, ArrayView<float> dist, float max_dist) const {
+  fill(dist, BIGFLOAT);
+  const float recip_delta = 1.f / _delta;
+  const auto bucket_of = [&](float d) { return int(d * recip_delta); };
+  // Cyclic array of buckets; a vertex may be entered in several buckets, and stale entries are skipped.
+  const int num_buckets = bucket_of(_max_length) + 2;
+  Array<Array<int>> buckets(num_buckets);
+  int num_entries = 0;
+  const auto relax = [&](int j, float d) {
+    if (d < dist[j] && d <= max_dist) {
+      dist[j] = d;
+      buckets[bucket_of(d) % num_buckets].push(j);
+      num_entries++;
+    }
+  };
+  for (const int i : sources) relax(i, 0.f);
+  Array<int> frontier_stamp(num(), -1), settled_stamp(num(), -1);
+  int stamp = 0;
+  Array<int> frontier, settled;
+  Array<int> request_offsets;
+  Array<float> requests;  // Candidate distances, in CSR order of the frontier rows.
+  const auto relax_edges = [&](CArrayView<int> vertices, bool light) {
+    const auto is_selected = [&](float length) { return light ? length <= _delta : length > _delta; };
+    if (vertices.num() < k_parallel_frontier) {
+      for (const int i : vertices)
+        for_intL(k, _offsets[i], _offsets[i + 1])
+          if (is_selected(_lengths[k])) relax(_neighbors[k], dist[i] + _lengths[k]);
+      return;
+    }
+    // Evaluate the requests in parallel (reading dist[] only), then apply them sequentially.
+    request_offsets.init(vertices.num() + 1);
+    request_offsets[0] = 0;
+    for_int(f, vertices.num()) {
+      const int i = vertices[f];
+      request_offsets[f + 1] = request_offsets[f] + _offsets[i + 1] - _offsets[i];
+    }
+    requests.init(request_offsets.last());
+    parallel_for_each({100}, range(vertices.num()), [&](const int f) {
+      const int i = vertices[f], beg = _offsets[i];
+      for_intL(k, beg, _offsets[i + 1]) {
+        const float d = dist[i] + _lengths[k];
+        requests[request_offsets[f] + k - beg] = is_selected(_lengths[k]) && d < dist[_neighbors[k]] ? d : BIGFLOAT;
+      }
+    });
+    for_int(f, vertices.num()) {
+      const int i = vertices[f], beg = _offsets[i];
+      for_intL(k, beg, _offsets[i + 1]) {
+        const float d = requests[request_offsets[f] + k - beg];
+        if (d != BIGFLOAT) relax(_neighbors[k], d);
+      }
+    }
+  };
+  for (int b = 0; num_entries; b++) {
+    Array<int>& bucket = buckets[b % num_buckets];
+    settled.init(0);
+    while (bucket.num()) {
+      frontier.init(0);
+      stamp++;
+      for (const int i : bucket) {
+        if (bucket_of(dist[i]) != b || frontier_stamp[i] == stamp) continue;  // Stale or repeated entry.
+        frontier_stamp[i] = stamp;
+        frontier.push(i);
+        if (settled_stamp[i] != b) {
+          settled_stamp[i] = b;
+          settled.push(i);
+        }
+      }
+      num_entries -= bucket.num();
+      bucket.init(0);
+      relax_edges(frontier, true);
+    }
+    relax_edges(settled, false);
+  }
+}
+
+// Fast marching on triangle meshes [Kimmel and Sethian 1998], without the unfolding of obtuse triangles.
+void MeshGeodesic::fast_marching(CArrayView<int> sources, ArrayView<float> dist, float max_dist) const {
+  fill(dist, BIGFLOAT);
+  Array<bool> accepted(num(), false);
+  HPqueue<int> pq;
+  for (const int i : sources) {
+    dist[i] = 0.f;
+    pq.enter_update_if_smaller(i, 0.f);
+  }
+  while (!pq.empty()) {
+    if (pq.min_priority() > max_dist) break;
+    const int i = pq.remove_min();
+    accepted[i] = true;
+    for_intL(k, _offsets[i], _offsets[i + 1]) {
+      const int j = _neighbors[k];
+      if (accepted[j]) continue;
+      float d = min(dist[j], dist[i] + _lengths[k]);
+      for_intL(t, _tri_offsets[j], _tri_offsets[j + 1]) {
+        const Vec2<int>& tri = _tri_opposite[t];
+        if ((tri[0] == i && accepted[tri[1]]) || (tri[1] == i && accepted[tri[0]]))
+          d = min(d, fast_marching_update(_points[j], _points[tri[0]], _points[tri[1]], dist[tri[0]], dist[tri[1]]));
+      }
+      if (d < dist[j]) {
+        dist[j] = d;
+        pq.enter_update(j, d);
+      }
+    }
+  }
+  for_int(i, num())
+    if (!accepted[i]) dist[i] = BIGFLOAT;
+}
+
+}  // namespace hh
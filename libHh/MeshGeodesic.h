@@ -0,0 +1,63 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_LIBHH_MESHGEODESIC_H_
+#define MESH_PROCESSING_LIBHH_MESHGEODESIC_H_
+
+#include "libHh/Array.h"
+#include "libHh/GMesh.h"
+#include "libHh/Map.h"
+#include "libHh/Matrix.h"
+
+#if 0
+{
+  const MeshGeodesic geodesic(mesh);
+  Array<float> dist(geodesic.num());
+  geodesic.distances(V(geodesic.index(vseed)), dist, MeshGeodesic::EMetric::fast_marching);
+  const Matrix<float> dists = geodesic.distances_from_each(sources);  // Searches run concurrently.
+}
+#endif
+
+namespace hh {
+
+// Geodesic distances over the vertices of a triangle mesh, whose adjacency is extracted once into compressed sparse
+// rows (CSR) so that many searches run over flat arrays rather than traversing the mesh.
+// The graph metric gives shortest paths along mesh edges, computed using delta-stepping (buckets of width delta,
+// with the relaxation of large frontiers done in parallel).  The fast_marching metric approximates shortest paths
+// across the face interiors (first-order accurate on meshes of nonobtuse triangles); non-triangle faces are ignored.
+class MeshGeodesic : noncopyable {
+ public:
+  enum class EMetric { graph, fast_marching };
+  explicit MeshGeodesic(const GMesh& mesh);
+  int num() const { return _vertices.num(); }
+  CArrayView<Vertex> vertices() const { return _vertices; }
+  int index(Vertex v) const { return _mvi.get(v); }
+  CArrayView<int> neighbors(int i) const { return _neighbors.slice(_offsets[i], _offsets[i + 1]); }
+  CArrayView<float> lengths(int i) const { return _lengths.slice(_offsets[i], _offsets[i + 1]); }
+  float delta() const { return _delta; }
+  void set_delta(float delta) { assertx(delta > 0.f), _delta = delta; }
+  // Set dist[i] to the distance from vertices()[i] to the nearest of the sources, or BIGFLOAT if that distance
+  // exceeds max_dist or the vertex is unreachable.
+  void distances(CArrayView<int> sources, ArrayView<float> dist, EMetric metric = EMetric::graph,
+                 float max_dist = BIGFLOAT) const;
+  // Compute the distance field from each source independently, as rows of the returned matrix.  The searches from
+  // the different sources run concurrently.
+  Matrix<float> distances_from_each(CArrayView<int> sources, EMetric metric = EMetric::graph,
+                                    float max_dist = BIGFLOAT) const;
+
+ private:
+  Array<Vertex> _vertices;
+  Map<Vertex, int> _mvi;
+  Array<Point> _points;
+  Array<int> _offsets;  // Row i occupies [_offsets[i], _offsets[i + 1]) in _neighbors and _lengths.
+  Array<int> _neighbors;
+  Array<float> _lengths;
+  Array<int> _tri_offsets;         // Row i occupies [_tri_offsets[i], _tri_offsets[i + 1]) in _tri_opposite.
+  Array<Vec2<int>> _tri_opposite;  // For each triangle adjacent to vertex i, its two other vertices in ccw order.
+  float _max_length{0.f};
+  float _delta{0.f};  // Bucket width for delta-stepping; defaults to the mean edge length.
+  void delta_stepping(CArrayView<int> sources, ArrayView<float> dist, float max_dist) const;
+  void fast_marching(CArrayView<int> sources, ArrayView<float> dist, float max_dist) const;
+};
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_LIBHH_MESHGEODESIC_H_
@@ -0,0 +1,104 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/MeshLaplacian.h"
+
+#include "libHh/Parallel.h"
+
+namespace hh {
+
+namespace {
+
+// Return cotangent of angle about point p1 in triangle, or BIGFLOAT if triangle is degenerate about p1.
+float cotan(const Point& p1, const Point& p2, const Point& p3) {
+  Vector v = p2 - p1, w = p3 - p1;
+  // cos(ang) = dot(v, w) / (mag(v) * mag(w))
+  // sin(ang) = mag(cross(v, w)) / (mag(v) * mag(w))
+  // -> cot(ang) = dot(v, w) / mag(cross(v, w))
+  float vcos = dot(v, w);
+  float vsin = mag(cross(v, w));
+  if (!vsin) Warning("cotan: found degenerate triangle");
+  return !vsin ? BIGFLOAT : vcos / vsin;
+}
+
+}  // namespace
+
+MeshLaplacian::MeshLaplacian(const GMesh& mesh, EWeights weights) {
+  _vertices.reserve(mesh.num_vertices());
+  for (Vertex v : mesh.vertices()) {
+    _mvi.enter(v, _vertices.num());
+    _vertices.push(v);
+  }
+  _offsets.reserve(num() + 1);
+  _offsets.push(0);
+  _neighbors.reserve(mesh.num_edges() * 2);
+  _weights.reserve(mesh.num_edges() * 2);
+  for (Vertex v : _vertices) {
+    const int beg = _neighbors.num();
+    if (weights == EWeights::cotangent && mesh.is_boundary(v)) {
+      _offsets.push(beg);
+      continue;
+    }
+    float sum_w = 0.f;
+    for (Vertex vv : mesh.vertices(v)) {  // unsorted!
+      float w = 1.f;
+      if (weights == EWeights::cotangent) {
+        Vertex vp = mesh.clw_vertex(v, vv);
+        Vertex vn = mesh.ccw_vertex(v, vv);
+        float cotp = cotan(mesh.point(vp), mesh.point(vv), mesh.point(v));
+        float cotn = cotan(mesh.point(vn), mesh.point(v), mesh.point(vv));
+        w = cotn + cotp;
+        if (w < 0.f) Warning("MeshLaplacian: negative edge weight, hope OK");
+        // OK to have two edges each have BIGFLOAT / (2 * BIGFLOAT) == .5f weight.
+        if (cotp == BIGFLOAT || cotn == BIGFLOAT) Warning("MeshLaplacian: degenerate triangle");
+      }
+      _neighbors.push(_mvi.get(vv));
+      _weights.push(w);
+      sum_w += w;
+    }
+    const int end = _neighbors.num();
+    if (end > beg) {
+      assertx(sum_w);
+      for_intL(k, beg, end) _weights[k] /= sum_w;
+    }
+    _offsets.push(end);
+  }
+}
+
+Array<Point> MeshLaplacian::get_points(const GMesh& mesh) const {
+  Array<Point> points(num());
+  for_int(i, num()) points[i] = mesh.point(_vertices[i]);
+  return points;
+}
+
+void MeshLaplacian::set_points(GMesh& mesh, CArrayView<Point> points) const {
+  assertx(points.num() == num());
+  for_int(i, num()) mesh.set_point(_vertices[i], points[i]);
+}
+
+void MeshLaplacian::smooth_step(CArrayView<Point> points, ArrayView<Point> newpoints, float disp,
+                                CArrayView<bool> movable) const {
+  assertx(points.num() == num() && newpoints.num() == num());
+  assertx(!movable.num() || movable.num() == num());
+  const int* const offsets = _offsets.data();
+  const int* const neighbors = _neighbors.data();
+  const float* const weights = _weights.data();
+  const uint64_t cycles_per_vertex = 10 + 6 * uint64_t(_neighbors.num()) / max(num(), 1);
+  parallel_for_each({cycles_per_vertex}, range(num()), [&](const int i) {
+    const Point& p = points[i];
+    const int beg = offsets[i], end = offsets[i + 1];
+    if (beg == end || (movable.num() && !movable[i])) {
+      newpoints[i] = p;
+      return;
+    }
+    float vx = 0.f, vy = 0.f, vz = 0.f;
+    for_intL(k, beg, end) {
+      const Point& pp = points[neighbors[k]];
+      const float w = weights[k];
+      vx += w * (pp[0] - p[0]);
+      vy += w * (pp[1] - p[1]);
+      vz += w * (pp[2] - p[2]);
+    }
+    newpoints[i] = p + Vector(vx, vy, vz) * disp;
+  });
+}
+
+}  // namespace hh
@@ -0,0 +1,40 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_LIBHH_MESHLAPLACIAN_H_
+#define MESH_PROCESSING_LIBHH_MESHLAPLACIAN_H_
+
+#include "libHh/Array.h"
+#include "libHh/GMesh.h"
+#include "libHh/Map.h"
+
+namespace hh {
+
+// Vertex Laplacian of a mesh, extracted once into compressed sparse rows (CSR) so that repeated smoothing iterations
+// run over flat arrays rather than traversing the mesh.  Row i lists the neighbors of vertices()[i] with weights
+// normalized to sum to 1.  With cotangent weights, boundary vertices have empty rows (i.e., they remain fixed).
+class MeshLaplacian : noncopyable {
+ public:
+  enum class EWeights { uniform, cotangent };
+  explicit MeshLaplacian(const GMesh& mesh, EWeights weights = EWeights::uniform);
+  int num() const { return _vertices.num(); }
+  CArrayView<Vertex> vertices() const { return _vertices; }
+  int index(Vertex v) const { return _mvi.get(v); }
+  CArrayView<int> neighbors(int i) const { return _neighbors.slice(_offsets[i], _offsets[i + 1]); }
+  CArrayView<float> weights(int i) const { return _weights.slice(_offsets[i], _offsets[i + 1]); }
+  Array<Point> get_points(const GMesh& mesh) const;
+  void set_points(GMesh& mesh, CArrayView<Point> points) const;
+  // Jacobi step: newpoints[i] = points[i] + disp * (sum_j w_ij * points[j] - points[i]).
+  // Vertices with empty rows or with movable[i] == false (if movable is nonempty) are unchanged.
+  void smooth_step(CArrayView<Point> points, ArrayView<Point> newpoints, float disp,
+                   CArrayView<bool> movable = CArrayView<bool>(nullptr, 0)) const;
+
+ private:
+  Array<Vertex> _vertices;
+  Map<Vertex, int> _mvi;
+  Array<int> _offsets;  // Row i occupies [_offsets[i], _offsets[i + 1]) in _neighbors and _weights.
+  Array<int> _neighbors;
+  Array<float> _weights;
+};
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_LIBHH_MESHLAPLACIAN_H_
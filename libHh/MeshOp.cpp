@@ -4,13 +4,16 @@
 #include <mutex>  // once_flag, call_once()
 
 #include "libHh/Array.h"
+#include "libHh/Bbox.h"
 #include "libHh/Facedistance.h"
 #include "libHh/GeomOp.h"
 #include "libHh/MathOp.h"  // Trig
+#include "libHh/Parallel.h"
 #include "libHh/Polygon.h"
 #include "libHh/RangeOp.h"  // sort()
 #include "libHh/Set.h"
 #include "libHh/Stack.h"
+#include "libHh/UnionFind.h"
 
 namespace hh {
 
@@ -63,6 +66,27 @@ int retriangulate(GMesh& mesh, SetEdge& sete, bool recurse, Set<Vertex>* setvr,
 
 const FlagMask fflag_visited = Mesh::allocate_Face_flag();
 
+// Spread the low 21 bits of i so that they occupy every third bit.
+uint64_t morton_spread_bits(uint64_t i) {
+  i &= 0x1FFFFF;
+  i = (i | i << 32) & 0x1F00000000FFFF;
+  i = (i | i << 16) & 0x1F0000FF0000FF;
+  i = (i | i << 8) & 0x100F00F00F00F00F;
+  i = (i | i << 4) & 0x10C30C30C30C30C3;
+  i = (i | i << 2) & 0x1249249249249249;
+  return i;
+}
+
+// Morton code of point p quantized to a 2^21 grid over the bounding box.
+uint64_t morton_code(const Point& p, const Bbox<float, 3>& bbox, float scale) {
+  uint64_t code = 0;
+  for_int(c, 3) {
+    const int i = clamp(int((p[c] - bbox[0][c]) * scale), 0, (1 << 21) - 1);
+    code |= morton_spread_bits(i) << c;
+  }
+  return code;
+}
+
 }  // namespace
 
 // *** Misc
@@ -120,6 +144,35 @@ Array<Set<Face>> gather_components(const Mesh& mesh) {
   return components;
 }
 
+int label_components(const Mesh& mesh, CArrayView<Face> faces, Array<int>& face_labels,
+                     const std::function<bool(Edge)>& connects) {
+  int max_id = 0;
+  for (Face f : faces) max_id = max(max_id, mesh.face_id(f));
+  Array<int> id_index(max_id + 1, -1);
+  for_int(i, faces.num()) id_index[mesh.face_id(faces[i])] = i;
+  const auto index = [&](Face f) {
+    const int id = mesh.face_id(f);
+    return id <= max_id ? id_index[id] : -1;
+  };
+  ParallelUnionFind union_find(faces.num());
+  parallel_for_each({100}, range(faces.num()), [&](const int i) {
+    for (Edge e : mesh.edges(faces[i])) {
+      const Face f2 = mesh.opp_face(faces[i], e);
+      if (!f2 || (connects && !connects(e))) continue;
+      const int i2 = index(f2);
+      if (i2 > i) union_find.unify(i, i2);  // (Each interior edge is seen from both faces.)
+    }
+  });
+  // Each class root is its smallest element, so numbering the roots in order numbers the components in order.
+  face_labels.init(faces.num());
+  int num_components = 0;
+  for_int(i, faces.num()) face_labels[i] = union_find.get_label(i) == i ? num_components++ : -1;
+  parallel_for_each({20}, range(faces.num()), [&](const int i) {
+    if (face_labels[i] < 0) face_labels[i] = face_labels[union_find.get_label(i)];
+  });
+  return num_components;
+}
+
 Stat mesh_stat_boundaries(const Mesh& mesh) {
   Stat Sbound;
   Set<Edge> setevis;  // boundary edges already considered
@@ -768,4 +821,69 @@ float project_point_neighborhood(const GMesh& mesh, const Point& p, Face& pf, Ba
   return mind2;
 }
 
+// *** Memory locality
+
+Array<Face> locality_face_order(const GMesh& mesh) {
+  Bbox<float, 3> bbox;
+  for (Vertex v : mesh.vertices()) bbox.union_with(mesh.point(v));
+  const float scale = float((1 << 21) - 1) / max(bbox.max_side(), 1e-20f);
+  struct S {
+    uint64_t code;
+    int fid;  // Tie-breaker for a deterministic order.
+    Face f;
+  };
+  Array<S> ar;
+  ar.reserve(mesh.num_faces());
+  for (Face f : mesh.faces()) {
+    Point centroid{};
+    int nv = 0;
+    for (Vertex v : mesh.vertices(f)) centroid += mesh.point(v), nv++;
+    centroid /= float(nv);
+    ar.push(S{morton_code(centroid, bbox, scale), mesh.face_id(f), f});
+  }
+  const auto by_increasing_code = [](const S& s1, const S& s2) {
+    return s1.code < s2.code || (s1.code == s2.code && s1.fid < s2.fid);
+  };
+  sort(ar, by_increasing_code);
+  return map(ar, [](const S& s) { return s.f; });
+}
+
+void reorder_for_locality(GMesh& mesh) {
+  const Array<Face> faces = locality_face_order(mesh);
+  GMesh nmesh;
+  nmesh.gflags() = mesh.gflags();
+  Map<Vertex, Vertex> mvvn;
+  const auto create_vertex = [&](Vertex v) {
+    Vertex vn = nmesh.create_vertex();
+    mvvn.enter(v, vn);
+    nmesh.flags(vn) = mesh.flags(v);
+    nmesh.set_point(vn, mesh.point(v));
+    nmesh.set_string(vn, mesh.extract_string(v));
+  };
+  for (Face f : faces)
+    for (Vertex v : mesh.vertices(f))
+      if (!mvvn.contains(v)) create_vertex(v);
+  for (Vertex v : mesh.ordered_vertices())
+    if (!mvvn.contains(v)) create_vertex(v);
+  Array<Vertex> va;
+  for (Face f : faces) {
+    va.init(0);
+    for (Vertex v : mesh.vertices(f)) va.push(mvvn.get(v));
+    Face fn = nmesh.create_face(va);
+    nmesh.flags(fn) = mesh.flags(f);
+    nmesh.set_string(fn, mesh.extract_string(f));
+    for (Corner c : mesh.corners(f)) {
+      if (!mesh.get_string(c)) continue;
+      nmesh.set_string(nmesh.corner(mvvn.get(mesh.corner_vertex(c)), fn), mesh.extract_string(c));
+    }
+  }
+  for (Edge e : mesh.edges()) {
+    if (!mesh.flags(e) && !mesh.get_string(e)) continue;
+    Edge en = nmesh.edge(mvvn.get(mesh.vertex1(e)), mvvn.get(mesh.vertex2(e)));
+    nmesh.flags(en) = mesh.flags(e);
+    nmesh.set_string(en, mesh.extract_string(e));
+  }
+  mesh = std::move(nmesh);
+}
+
 }  // namespace hh
@@ -1533,6 +1533,12 @@ void PMesh::read(std::istream& is) {
 }
 
 void PMesh::write(std::ostream& os) const {
+  write_header_and_base_mesh(os);
+  for_int(i, _vsplits.num()) _vsplits[i].write(os, _info);
+  write_trailer(os);
+}
+
+void PMesh::write_header_and_base_mesh(std::ostream& os) const {
   os << "PM\n";
   os << "version=2\n";
   os << sform("nvsplits=%d nvertices=%d nwedges=%d nfaces=%d\n",  //
@@ -1545,7 +1551,9 @@ void PMesh::write(std::ostream& os) const {
   if (_info._has_wad2) os << sform("has_wad2=%d\n", _info._has_wad2);
   os << "PM base mesh:\n";
   _base_mesh.write(os, _info);
-  for_int(i, _vsplits.num()) _vsplits[i].write(os, _info);
+}
+
+void PMesh::write_trailer(std::ostream& os) {
   os << uchar(k_magic_first_byte);
   os << "End of PM\n";
   assertx(os);
@@ -352,6 +352,9 @@ class PMesh : noncopyable {
   // non-progressive read
   void read(std::istream& is);  // die unless empty
   void write(std::ostream& os) const;
+  // Streaming write: the header and base mesh, then any number of Vsplit::write(os, _info), then the trailer.
+  void write_header_and_base_mesh(std::ostream& os) const;
+  static void write_trailer(std::ostream& os);
   void truncate_beyond(PMeshIter& pmi);  // remove all vsplits beyond iterator
   void truncate_prior(PMeshIter& pmi);   // advance base mesh
  public:
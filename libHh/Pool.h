@@ -16,6 +16,12 @@
   // *.cpp
   HH_ALLOCATE_POOL(Polygon);
 }
+{
+  PoolArena<2> arena;  // e.g., a member of a container class, with 2 pooled element classes.
+  Node* node = new (arena.alloc(0, alignof(Node), sizeof(Node))) Node;
+  node->~Node(), arena.free(0, node);  // optional
+  arena.release();  // after the destructors of all outstanding elements have been run.
+}
 #endif
 
 namespace hh {
@@ -213,6 +219,87 @@ class Pool : noncopyable {
   }
 };
 
+// Memory arena for the elements of several pooled classes owned by one container (e.g., those of a Mesh), such that
+// all of its memory is released at once by release() rather than element by element.  Each class k < N has its own
+// free list and its own chunks (which grow geometrically in size), so that elements of a class stay contiguous.
+// Not threadsafe (like Pool), so the owning container must serialize its allocations.
+template <int N> class PoolArena : noncopyable {
+ public:
+  PoolArena() = default;
+  ~PoolArena() { release(); }
+  // Each class k must always request the same size and alignment.
+  void* alloc(int k, int align, size_t size) {
+    ASSERTX(k >= 0 && k < N);
+    Class& c = _classes[k];
+    if (!c.h) return carve(c, align, size);
+    Link* p = c.h;
+    c.h = p->next;
+    return p;
+  }
+  void free(int k, void* pp) {
+    ASSERTX(k >= 0 && k < N);
+    Class& c = _classes[k];
+    Link* p = static_cast<Link*>(pp);
+    p->next = c.h;
+    c.h = p;
+  }
+  // Free all chunks; the caller must have already run the destructors of all outstanding elements.
+  void release() {
+    for (Chunk* chunk = _chunkh; chunk;) {
+      Chunk* next = chunk->next;
+      aligned_free(chunk);
+      chunk = next;
+    }
+    _chunkh = nullptr;
+    for_int(k, N) _classes[k] = {};
+  }
+  friend void swap(PoolArena& l, PoolArena& r) noexcept {
+    using std::swap;
+    swap(l._classes, r._classes);
+    swap(l._chunkh, r._chunkh);
+  }
+
+ private:
+  static constexpr int k_chunk_align = 16;
+  static constexpr int k_min_chunksize = 1024;
+  static constexpr int k_max_chunksize = 256 * 1024;
+  struct Link {
+    Link* next;
+  };
+  struct alignas(k_chunk_align) Chunk {
+    Chunk* next;
+  };
+  struct Class {
+    Link* h{nullptr};     // free list
+    char* cur{nullptr};  // unused part [cur, end) of the most recent chunk of the class
+    char* end{nullptr};
+    int nchunks{0};
+  };
+  Class _classes[N];
+  Chunk* _chunkh{nullptr};
+  //
+  void* carve(Class& c, int align, size_t size) {
+    ASSERTX(align >= 1 && align <= k_chunk_align && size >= sizeof(Link));
+    for (;;) {
+      uintptr_t p = (reinterpret_cast<uintptr_t>(c.cur) + align - 1) & ~uintptr_t(align - 1);
+      if (c.cur && p + size <= reinterpret_cast<uintptr_t>(c.end)) {
+        c.cur = reinterpret_cast<char*>(p + size);
+        return reinterpret_cast<void*>(p);
+      }
+      const int shift = std::min(c.nchunks, 8);
+      const size_t chunksize =
+          std::max(size_t(std::min(k_min_chunksize << shift, k_max_chunksize)), sizeof(Chunk) + size);
+      char* chunkp = static_cast<char*>(assertx(aligned_malloc(k_chunk_align, chunksize)));
+      Chunk* chunk = reinterpret_cast<Chunk*>(chunkp);
+      chunk->next = _chunkh;
+      _chunkh = chunk;
+      c.nchunks++;
+      c.cur = chunkp + sizeof(Chunk);
+      c.end = chunkp + chunksize;
+    }
+  }
+};
+
 }  // namespace hh
 
 #endif  // MESH_PROCESSING_LIBHH_POOL_H_
@@ -363,6 +363,148 @@ template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_
   }
 };
 
+// Indexed priority queue allowing insertion/deletion/update, with the same interface as HPqueue.
+// Instead of a hash map, each element stores its own heap position in an intrusive slot. Index()(e) must return an
+// int& that is zero whenever e is not in the queue, e.g. the zero-initialized member of a Sac field allocated using
+// HH_SAC_ALLOCATE_CD_FUNC (a plain HH_SAC_ALLOCATE_FUNC int is left uninitialized in each new element).  While e is
+// in the queue, the slot holds its position plus one.
+// The heap is 4-ary, which halves its depth, and sort() builds it from enter_unsorted() elements in O(n) time.
+// The destructor does not reset the slots (whose elements may no longer exist), so call clear() before destroying
+// a nonempty queue whose elements may later be entered into another queue.
+template <typename T, typename Index> class IPqueue : noncopyable {
+ public:
+  explicit IPqueue(Index index = Index()) : _index(std::move(index)) {}
+  void clear() {
+    for (Node& node : _ar) _index(node._e) = 0;
+    _ar.clear();
+  }
+  void enter(const T& e, float pri) { ASSERTX(pri >= 0.f && !contains(e)), enter_i(e, pri); }
+  void reserve(int size) { _ar.reserve(size); }
+  int num() const { return _ar.num(); }
+  size_t size() const { return _ar.size(); }
+  bool empty() const { return !num(); }
+  const T& min() const { return (ASSERTXX(!empty()), _ar[0]._e); }
+  float min_priority() const { return (ASSERTXX(!empty()), _ar[0]._pri); }
+  T remove_min() { return (ASSERTXX(!empty()), remove_min_i()); }
+  void enter_unsorted(const T& e, float pri) {
+    ASSERTX(pri >= 0.f && !contains(e));
+    _ar.push(Node(e, pri));
+    _index(e) = num();
+  }
+  void sort() { sort_i(); }
+  bool contains(const T& e) const { return _index(e) != 0; }
+  float retrieve(const T& e) const {
+    const int i = _index(e) - 1;
+    return i >= 0 ? (ASSERTXX(_ar[i]._e == e), _ar[i]._pri) : -1.f;
+  }
+  float remove(const T& e) { return remove_i(e); }                                         // ret pri or < 0.f
+  float update(const T& e, float pri) { return (ASSERTX(pri >= 0.f), update_i(e, pri)); }  // ret prevpri or < 0.f
+  float enter_update(const T& e, float pri) {                                              // ret prevpri or < 0.f
+    ASSERTX(pri >= 0.f);
+    if (contains(e)) return update_i(e, pri);
+    enter_i(e, pri);
+    return -1.f;
+  }
+  bool enter_update_if_smaller(const T& e, float pri) {
+    const float oldpri = retrieve(e);
+    if (oldpri >= 0.f && pri >= oldpri) return false;
+    enter_update(e, pri);
+    return true;
+  }
+  bool enter_update_if_greater(const T& e, float pri) {
+    const float oldpri = retrieve(e);
+    if (oldpri >= 0.f && pri <= oldpri) return false;
+    enter_update(e, pri);
+    return true;
+  }
+
+ private:
+  using Node = details::PQ::Node<T>;
+  static constexpr int k_arity = 4;
+  Array<Node> _ar;
+  mutable Index _index;
+  void place(int n, T&& e, float pri) {  // Also record the position of e.
+    _index(e) = n + 1;
+    _ar[n]._e = std::move(e);
+    _ar[n]._pri = pri;
+  }
+  void nmove(int n1, int n2) {
+    _ar[n1] = std::move(_ar[n2]);
+    _index(_ar[n1]._e) = n1 + 1;
+  }
+  // (cp is the priority of the element destined for node n, whose contents are not used.)  Returns its new node j,
+  // after shifting the elements along the path from n to j.
+  int adjust_up(int n, const float cp) {
+    while (n) {
+      const int pn = (n - 1) / k_arity;  // parent node
+      if (!(cp < _ar[pn]._pri)) break;
+      nmove(n, pn);
+      n = pn;
+    }
+    return n;
+  }
+  int adjust_down(int n, const float cp) {
+    for (;;) {
+      const int fn = n * k_arity + 1;  // first child node
+      if (fn >= num()) break;          // no children
+      const int ln = std::min(fn + k_arity, num());
+      int mn = fn;  // child with smallest priority
+      for_intL(cn, fn + 1, ln) {
+        if (_ar[cn]._pri < _ar[mn]._pri) mn = cn;
+      }
+      if (!(cp > _ar[mn]._pri)) break;
+      nmove(n, mn);
+      n = mn;
+    }
+    return n;
+  }
+  int adjust(int n, const float cp) {
+    const int j = adjust_up(n, cp);
+    return j != n ? j : adjust_down(n, cp);
+  }
+  void enter_i(T e, float pri) {
+    _ar.add(1);  // leave this new node uninitialized
+    place(adjust_up(num() - 1, pri), std::move(e), pri);
+  }
+  void sort_i() {
+    // Start at the parent of the last node; (num() - 2) / k_arity would truncate to 0 for an empty queue.
+    for (int i = num() < 2 ? -1 : (num() - 2) / k_arity; i >= 0; --i) {
+      T e = std::move(_ar[i]._e);
+      const float pri = _ar[i]._pri;
+      place(adjust_down(i, pri), std::move(e), pri);
+    }
+  }
+  T remove_min_i() {
+    T e = std::move(_ar[0]._e);
+    _index(e) = 0;
+    T e0 = std::move(_ar.last()._e);
+    const float pri = _ar.last()._pri;
+    _ar.sub(1);
+    if (num()) place(adjust_down(0, pri), std::move(e0), pri);
+    return e;
+  }
+  float remove_i(const T& e) {
+    const int i = _index(e) - 1;
+    if (i < 0) return -1.f;
+    ASSERTXX(_ar[i]._e == e);
+    const float ppri = _ar[i]._pri;
+    _index(e) = 0;
+    T e0 = std::move(_ar.last()._e);
+    const float pri = _ar.last()._pri;
+    _ar.sub(1);
+    if (i < num()) place(adjust(i, pri), std::move(e0), pri);  // if num() was 1, we have i == 0, num() == 0
+    return ppri;
+  }
+  float update_i(const T& e, float pri) {
+    const int i = _index(e) - 1;
+    if (i < 0) return -1.f;
+    const float oldpri = _ar[i]._pri;
+    T e1 = std::move(_ar[i]._e);
+    place(adjust(i, pri), std::move(e1), pri);
+    return oldpri;
+  }
+};
+
 }  // namespace hh
 
 #endif  // MESH_PROCESSING_LIBHH_PQUEUE_H_
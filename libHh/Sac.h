@@ -123,18 +123,21 @@ template <typename T> BSac::Func Sac<T>::dfuncs[k_max] = {};
   static void operator delete(void* p, size_t) { hh::aligned_free(p); }                                    \
   hh::Sac<T> sac
 
-#define HH_MAKE_POOLED_SAC(T)                                                                  \
-  hh::Sac<T> sac;                                                                              \
-  static void* operator new(size_t s) {                                                        \
-    ASSERTX(s == sizeof(T));                                                                   \
-    const int alignment = hh::Sac<T>::get_max_align();                                         \
-    return pool.alloc_size(alignment, sizeof(T) - hh::BSac::k_dummy + hh::Sac<T>::get_size()); \
-  }                                                                                            \
-  static void operator delete(void* p, size_t) {                                               \
-    pool.free_size(p, sizeof(T) - hh::BSac::k_dummy + hh::Sac<T>::get_size());                 \
-  }                                                                                            \
-  static void* operator new[](size_t) = delete;                                                \
-  static void operator delete[](void*, size_t) = delete;                                       \
+// The static functions sac_alloc_size() and sac_alloc_align() let a container allocate elements from its own
+// PoolArena (see Pool.h) using placement new.
+#define HH_MAKE_POOLED_SAC(T)                                                                       \
+  hh::Sac<T> sac;                                                                                   \
+  static size_t sac_alloc_size() { return sizeof(T) - hh::BSac::k_dummy + hh::Sac<T>::get_size(); } \
+  static int sac_alloc_align() { return hh::Sac<T>::get_max_align(); }                              \
+  static void* operator new(size_t s) {                                                             \
+    ASSERTX(s == sizeof(T));                                                                        \
+    return pool.alloc_size(sac_alloc_align(), sac_alloc_size());                                    \
+  }                                                                                                 \
+  static void* operator new(size_t, void* p) { return p; }                                          \
+  static void operator delete(void* p, size_t) { pool.free_size(p, sac_alloc_size()); }             \
+  static void operator delete(void*, void*) {}                                                      \
+  static void* operator new[](size_t) = delete;                                                     \
+  static void operator delete[](void*, size_t) = delete;                                            \
   HH_POOL_ALLOCATION_3(T)
 
 #define HH_SACABLE(T)                                   \
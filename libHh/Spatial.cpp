@@ -64,7 +64,7 @@ void BPointSpatial::shrink_to_fit() {
   for (auto& cell : _map.values()) cell.shrink_to_fit();
 }
 
-void BPointSpatial::add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& /*set*/) const {
+void BPointSpatial::add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& /*set*/) const {
   // SHOW("add_cell", ci);
   int en = encode(ci);
   bool present;
@@ -188,7 +188,7 @@ void IPointSpatial::clear() {
   _map.clear();
 }
 
-void IPointSpatial::add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& /*set*/) const {
+void IPointSpatial::add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& /*set*/) const {
   int en = encode(ci);
   bool present;
   const auto& cell = _map.retrieve(en, present);
@@ -4,11 +4,10 @@
 
 #include "libHh/Array.h"
 #include "libHh/Bbox.h"
+#include "libHh/FlatHash.h"
 #include "libHh/Geometry.h"
-#include "libHh/Map.h"
 #include "libHh/Pqueue.h"
 #include "libHh/Queue.h"
-#include "libHh/Set.h"
 #include "libHh/Stat.h"
 #include "libHh/Univ.h"
 #include "libHh/Vec.h"
@@ -57,7 +56,7 @@ class Spatial : noncopyable {            // abstract class
   // for BSpatialSearch:
   // Add elements from cell ci to priority queue with priority equal to distance from pcenter squared.
   // May use set to avoid duplication.
-  virtual void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& set) const = 0;
+  virtual void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& set) const = 0;
 
   // Refine distance estimate of first entry in pq (optional)
   virtual void pq_refine(Pqueue<Univ>& pq, const Point& pcenter) const { dummy_use(pq, pcenter); }
@@ -78,13 +77,13 @@ class BPointSpatial : public Spatial {
   void shrink_to_fit();                   // often just fragments memory
 
  private:
-  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& set) const override;
+  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& set) const override;
   Univ pq_id(Univ pqe) const override;
   struct Node {
     Univ id;
     const Point* p;
   };
-  Map<int, Array<Node>> _map;  // encoded cube index -> Array
+  FlatMap<int, Array<Node>> _map;  // encoded cube index -> Array
 };
 
 }  // namespace details
@@ -105,11 +104,11 @@ class IPointSpatial : public Spatial {
   void clear() override;
 
  private:
-  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& set) const override;
+  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& set) const override;
   Univ pq_id(Univ pqe) const override;
 
   const Point* _pp;
-  Map<int, Array<int>> _map;  // encoded cube index -> Array of point indices
+  FlatMap<int, Array<int>> _map;  // encoded cube index -> Array of point indices
 };
 
 // Spatial data structure for more general objects.
@@ -133,9 +132,9 @@ class ObjectSpatial : public Spatial {
   template <typename Func = bool(Univ)> void search_segment(const Point& p1, const Point& p2, Func ftest) const;
 
  private:
-  Map<int, Array<Univ>> _map;  // encoded cube index -> vector
+  FlatMap<int, Array<Univ>> _map;  // encoded cube index -> vector
 
-  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, Set<Univ>& set) const override;
+  void add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter, FlatSet<Univ>& set) const override;
   void pq_refine(Pqueue<Univ>& pq, const Point& pcenter) const override;
   Univ pq_id(Univ pqe) const override { return pqe; }
 };
@@ -165,7 +164,7 @@ class BSpatialSearch : noncopyable {
   float _disbv2{0.f};  // distance to search space boundary
   int _axis;           // axis to expand next
   int _dir;            // direction in which to expand next (0, 1)
-  Set<Univ> _setevis;  // may be used by add_cell()
+  FlatSet<Univ> _setevis;  // may be used by add_cell()
   int _ncellsv{0};
   int _nelemsv{0};
 
@@ -225,7 +224,7 @@ inline Spatial::Ind Spatial::decode(int en) const {
 
 template <typename Approx2, typename Exact2>
 void ObjectSpatial<Approx2, Exact2>::add_cell(const Ind& ci, Pqueue<Univ>& pq, const Point& pcenter,
-                                              Set<Univ>& set) const {
+                                              FlatSet<Univ>& set) const {
   int en = encode(ci);
   bool present;
   auto& cell = _map.retrieve(en, present);
@@ -252,7 +251,7 @@ void ObjectSpatial<Approx2, Exact2>::pq_refine(Pqueue<Univ>& pq, const Point& pc
 template <typename Approx2, typename Exact2>
 template <typename Func>
 void ObjectSpatial<Approx2, Exact2>::enter(Univ id, const Point& startp, Func fcontains) {
-  Set<int> set;
+  FlatSet<int> set;
   Queue<int> queue;
   int ncubes = 0;
   Ind ci = indices_from_point(startp);
@@ -285,7 +284,7 @@ void ObjectSpatial<Approx2, Exact2>::enter(Univ id, const Point& startp, Func fc
 template <typename Approx2, typename Exact2>
 template <typename Func>
 void ObjectSpatial<Approx2, Exact2>::search_segment(const Point& p1, const Point& p2, Func ftest) const {
-  Set<Univ> set;
+  FlatSet<Univ> set;
   bool should_stop = false;
   for_int(c, 3) {
     assertx(p1[c] >= 0.f && p1[c] <= 1.f);
@@ -756,14 +756,9 @@ void SrMesh::compute_nspheres(CArrayView<SrVertexGeometry> vgeoms) {
     SrVertex* vs = &_vertices[vi];
     if (!is_splitable(vs)) continue;
     SrVsplit* vspl = &_vsplits[vs->vspli];
-    Vector dir_b = ar_nsphere[vi].point;
-    Vector nor_b = dir_b;
+    Vector nor_b = ar_nsphere[vi].point;
     assertw(nor_b.normalize());
-    float r_b = ar_nsphere[vi].radius;
-    // cos(theta) == (b ^ 2 + c ^ 2 - a ^ 2) / (2 * b * c)
-    float v = (mag2(dir_b) + 1.f - square(r_b)) / (2.f * mag(dir_b));
-    if (v < -1.f) v = -1.f;  // (triangle inequality failed, ok)
-    float alpha_b = my_acos(v);
+    float alpha_b = normal_cone_half_angle(ar_nsphere[vi]);
     // float alpha_p = my_acos(dot(nor_b, vgeoms[vi]. vnormal));
     float alpha_p = angle_between_unit_vectors(nor_b, vgeoms[vi].vnormal);
     float alpha = alpha_b + alpha_p;
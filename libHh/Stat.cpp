@@ -1,8 +1,11 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
 #include "libHh/Stat.h"
 
+#include <mutex>  // mutex, lock_guard
 #include <vector>
 
+#include "libHh/Trace.h"
+
 namespace hh {
 
 int Stat::_s_show = -10;
@@ -21,6 +24,7 @@ class Stats {
   ~Stats() = delete;
   void flush_internal() {
     if (_vec.empty()) return;
+    for (Stat* stat : _vec) stat->merge_threads();
     int num_to_print = 0;
     for (Stat* stat : _vec)
       if (stat->_print && stat->num()) num_to_print++;
@@ -34,6 +38,12 @@ class Stats {
   std::vector<Stat*> _vec;
 };
 
+// Entries into a static Stat from threads other than its owner; they are merged into it at termination.
+struct Stat::Shared {
+  std::mutex mutex;
+  Stat stat;
+};
+
 Stat::Stat(string name_, bool print, bool is_static) : _name(std::move(name_)), _print(print) {
   zero();
   static const bool stat_files = getenv_bool("STAT_FILES");
@@ -48,6 +58,17 @@ Stat::Stat(string name_, bool print, bool is_static) : _name(std::move(name_)),
   } else if (is_static) {
     Stats::add(this);
   }
+  if (is_static) {
+    _shared = make_unique<Shared>();
+    // The thread creating the Stat (within the HH_SSTAT macro) enters its values without locking.
+    // With Stat.* files, all threads instead serialize their output.
+    _owner = _ofs ? nullptr : thread_tag();
+  }
+  if (is_static && _name != "" && Trace::enabled()) {
+    _histogram = make_unique<int64_t[]>(Trace::k_num_histogram_bins);  // Zero-initialized.
+    _shared->stat._histogram = make_unique<int64_t[]>(Trace::k_num_histogram_bins);
+    Trace::record_stat(*this);
+  }
 }
 
 Stat::Stat(const char* name_, bool print, bool is_static) : Stat(string(name_ ? name_ : ""), print, is_static) {}
@@ -60,6 +81,18 @@ Stat::~Stat() {
   _print = false;
 }
 
+Stat::Stat(Stat&& s) noexcept : _print(false) { swap(*this, s); }
+
+Stat& Stat::operator=(Stat&& s) noexcept {
+  _ofs = nullptr;
+  _histogram = nullptr;
+  _shared = nullptr;
+  _owner = nullptr;
+  _print = false;
+  swap(*this, s);
+  return *this;
+}
+
 void swap(Stat& l, Stat& r) noexcept {
   using std::swap;
   swap(l._name, r._name);
@@ -71,6 +104,9 @@ void swap(Stat& l, Stat& r) noexcept {
   swap(l._min, r._min);
   swap(l._max, r._max);
   swap(l._ofs, r._ofs);
+  swap(l._histogram, r._histogram);
+  swap(l._shared, r._shared);
+  swap(l._owner, r._owner);
 }
 
 void Stat::summary_terminate() {
@@ -114,6 +150,37 @@ string Stat::name_string() const {
   return (_name == "" ? "" : sform("%-20.28s", (_name.substr(0, 27) + ":").c_str())) + short_string() + "\n";
 }
 
-void Stat::output(float value) const { (*_ofs) << value << '\n'; }
+void Stat::enter_shared(double d, int factor) {
+  std::lock_guard<std::mutex> lock(_shared->mutex);
+  Stat& stat = _shared->stat;
+  stat._n += factor;
+  stat._sum += d * factor;
+  stat._sum2 += square(d) * factor;
+  const float value = float(d);
+  if (value < stat._min) stat._min = value;
+  if (value > stat._max) stat._max = value;
+  if (stat._histogram) for_int(i, factor) stat.output(value);
+  if (_ofs) for_int(i, factor) (*_ofs) << value << '\n';
+}
+
+// Called at termination, once the threads entering the Stat are done.
+void Stat::merge_threads() {
+  if (!_shared) return;
+  std::lock_guard<std::mutex> lock(_shared->mutex);
+  Stat& stat = _shared->stat;
+  _n += stat._n;
+  _sum += stat._sum;
+  _sum2 += stat._sum2;
+  if (stat._min < _min) _min = stat._min;
+  if (stat._max > _max) _max = stat._max;
+  if (_histogram)
+    for_int(bin, Trace::k_num_histogram_bins) _histogram[bin] += std::exchange(stat._histogram[bin], 0);
+  stat.zero();
+}
+
+void Stat::output(float value) {
+  if (_ofs) (*_ofs) << value << '\n';
+  if (_histogram) _histogram[Trace::histogram_bin(value)]++;
+}
 
 }  // namespace hh
@@ -18,6 +18,9 @@
   Stat::set_show_stats(-1);  // Or "export SHOW_STATS=-1": only print in showff().
   Stat::set_show_stats(-2);  // Or "export SHOW_STATS=-2": disable printing of all statistics.
   // getenv_bool("HH_HIDE_SUMMARIES") : If true, omit summary of statistics.
+  // getenv("HH_TRACE") : If set, static Stat objects also record a histogram for the trace summary (see Trace.h).
+  // Static Stat objects (HH_SSTAT) may be entered concurrently, e.g. from within parallel_for_each();
+  // only the entries from threads other than the one that created the object take a lock.
 }
 #endif
 
@@ -28,7 +31,7 @@ class Stat {
  public:
   explicit Stat(string name_ = "", bool print = false, bool is_static = false);
   explicit Stat(const char* name_, bool print = false, bool is_static = false);
-  Stat(Stat&& s) noexcept : _print(false) { swap(*this, s); }  // Not "= default".
+  Stat(Stat&& s) noexcept;  // Not "= default".
   template <typename Range, typename = enable_if_range_t<Range>> explicit Stat(Range&& range);
   ~Stat();
   Stat& operator=(Stat&& s) noexcept;
@@ -55,6 +58,7 @@ class Stat {
   float sum() const { return float(_sum); }
   float rms() const;
   float max_abs() const { return std::max(abs(min()), abs(max())); }
+  const int64_t* histogram() const { return _histogram.get(); }  // Trace::k_num_histogram_bins, or nullptr.
   string short_string() const;  // No leading name, no trailing '\n'.
   string name_string() const;   // Used by operator<<().
   friend void swap(Stat& l, Stat& r) noexcept;
@@ -73,10 +77,19 @@ class Stat {
   float _min;
   float _max;
   unique_ptr<std::ofstream> _ofs;  // Defined if getenv_bool("STAT_FILES").
+  unique_ptr<int64_t[]> _histogram;  // Defined for static Stat if Trace::enabled().
+  struct Shared;
+  unique_ptr<Shared> _shared;  // Defined for static Stat; accumulates entries from other threads under a lock.
+  const char* _owner{nullptr};  // For static Stat, the thread_tag() of the thread entering it without a lock.
+  static inline thread_local char _s_thread_tag;
   static int _s_show;
   // If add any member variables, be sure to update member function swap().
   friend class Stats;
-  void output(float value) const;
+  friend class Traces;
+  void output(float value);
+  static const char* thread_tag() { return &_s_thread_tag; }  // Unique among running threads.
+  void enter_shared(double d, int factor);
+  void merge_threads();
   void summary_terminate();
 };
 
@@ -135,41 +148,37 @@ template <typename Range, typename> Stat::Stat(Range&& range) : Stat{} {
   for (const auto& e : range) enter(e);
 }
 
-inline Stat& Stat::operator=(Stat&& s) noexcept {
-  _ofs = nullptr;
-  _print = false;
-  swap(*this, s);
-  return *this;
-}
-
 inline void Stat::enter(float value) {
+  if (_shared && thread_tag() != _owner) return enter_shared(value, 1);
   _n++;
   const double d = value;
   _sum += d;
   _sum2 += square(d);
   if (value < _min) _min = value;
   if (value > _max) _max = value;
-  if (_ofs) output(value);
+  if (_ofs || _histogram) output(value);
 }
 
 inline void Stat::enter(double d) {
+  if (_shared && thread_tag() != _owner) return enter_shared(d, 1);
   _n++;
   _sum += d;
   _sum2 += square(d);
   const float value = float(d);
   if (value < _min) _min = value;
   if (value > _max) _max = value;
-  if (_ofs) output(value);
+  if (_ofs || _histogram) output(value);
 }
 
 inline void Stat::enter_multiple(float value, int factor) {
+  if (_shared && thread_tag() != _owner) return enter_shared(value, factor);
   _n += factor;
   const double d = value;
   _sum += d * factor;
   _sum2 += square(d) * factor;
   if (value < _min) _min = value;
   if (value > _max) _max = value;
-  if (_ofs) for_int(i, factor) output(value);
+  if (_ofs || _histogram) for_int(i, factor) output(value);
 }
 
 inline float Stat::avg() const {
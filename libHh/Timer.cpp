@@ -11,7 +11,7 @@ HH_REFERENCE_LIB("advapi32.lib");  // RegOpenKeyExA()
 
 #include <array>
 #include <cctype>  // isdigit()
-#include <mutex>   // once_flag, call_once()
+#include <mutex>   // once_flag, call_once(), mutex, lock_guard
 #include <thread>  // thread::hardware_concurrency()
 #include <unordered_map>
 #include <vector>
@@ -19,6 +19,7 @@ HH_REFERENCE_LIB("advapi32.lib");  // RegOpenKeyExA()
 #if !defined(HH_NO_TIMERS_CLASS)
 #include "libHh/Stat.h"
 #endif
+#include "libHh/Trace.h"
 
 // Overhead for use of Timer:
 // TTIMER_COUNT=1000000 Timer_test  # Look at oneabbrev and abbrev.
@@ -139,7 +140,7 @@ string create_parallelism_string(double process_time, double real_time, int64_t
 class Timers {
  public:
   static bool record(const Timer& timer, Timer::EMode cmode) {
-    // Note: not threadsafe.  (Any timers must be created outside multithreading sections.)
+    std::lock_guard<std::mutex> lock(instance()._mutex);
     const auto& [it, is_new] =
         instance()._map.emplace(timer._name, narrow_cast<int>(instance()._vec_timer_info.size()));
     const auto& [_, i] = *it;
@@ -167,6 +168,7 @@ class Timers {
   Timers() { hh_at_clean_up(Timers::flush); }
   ~Timers() = delete;
   void flush_internal() {
+    std::lock_guard<std::mutex> lock(_mutex);
     if (_vec_timer_info.empty()) return;
     for (const auto& timer_info : _vec_timer_info)
       if (timer_info.stat_cpu_times.num() > 1) _have_some_mult = true;
@@ -195,6 +197,7 @@ class Timers {
     _map.clear();
     _vec_timer_info.clear();
   }
+  std::mutex _mutex;
   std::unordered_map<string, int> _map;
   struct TimerInfo {
     explicit TimerInfo(string name) : stat_cpu_times(std::move(name), false) {}
@@ -233,7 +236,10 @@ void Timer::terminate() {
     _mode = EMode::noprint;
   const EMode cmode = _mode;
   _mode = EMode::noprint;
-  if (cmode == EMode::possibly || cmode == EMode::noprint || _name == "" || !_ever_started) return;
+  if (cmode == EMode::possibly || cmode == EMode::noprint || _name == "" || !_ever_started) {
+    if (_started && _name != "" && Trace::enabled()) stop();  // Record the scope in the trace.
+    return;
+  }
   if (!_started) {
     Warning("Timer not restarted");
   } else {
@@ -296,6 +302,7 @@ void Timer::start() {
   assertx(!_started);
   _started = true;
   _ever_started = true;
+  if (Trace::enabled() && _name != "") _trace_begin_counter = Trace::begin_scope();
   update_counters(-1);
 }
 
@@ -303,6 +310,7 @@ void Timer::stop() {
   assertx(_started);
   _started = false;
   update_counters(+1);
+  if (Trace::enabled() && _name != "") Trace::end_scope(_name, _trace_begin_counter);
   _process_cpu_time = max(_process_cpu_time, 0.);
   _real_time_counter = max(_real_time_counter, int64_t{0});
 }
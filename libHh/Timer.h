@@ -35,7 +35,8 @@ namespace hh {
 // Object that tracks elapsed time and process computation (user+system) time over its lifetime.
 // It reports effective multithreading factor as a percentage, if detected.
 // Timing data associated with multiple Timers with the same name are accumulated and reported at program end.
-// (This accumulation is not threadsafe; we assume that any timers are created outside multithreading sections.)
+// (This accumulation is threadsafe, so timers may also be created within multithreading sections.)
+// If getenv("HH_TRACE") is set, each start/stop interval is also recorded per thread (see Trace.h).
 // We find that the computation time of the main thread is not all that useful.  Although in OpenMP, the main
 // thread participates in task work, this is not the case with hh::ThreadPoolIndexedTask, so the ratio
 // process_cpu_time / main_thread_cpu_time is not meaningful.
@@ -73,6 +74,7 @@ class Timer : noncopyable {
   // double _thread_cpu_time{0.}; // Main thread "user + system" time, in seconds.
   double _process_cpu_time{0.};   // Process "user + system" time, in seconds.
   int64_t _real_time_counter{0};  // Elapsed time, often in units of 100 ns.
+  int64_t _trace_begin_counter{0};  // Used if Trace::enabled().
   static int _s_show;
   friend class Timers;
   void update_counters(int delta_sign);
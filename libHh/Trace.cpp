@@ -0,0 +1,220 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/Trace.h"
+
+#include <cmath>  // frexp()
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "libHh/Stat.h"
+#include "libHh/StringOp.h"  // get_path_root()
+
+namespace hh {
+
+namespace {
+
+struct ScopeEvent {
+  string name;
+  int64_t begin_counter;
+  int64_t end_counter;
+  int depth;
+};
+
+struct CounterEvent {
+  string name;
+  int64_t counter;
+  double value;
+};
+
+// Events recorded by a single thread.  Its mutex is only contended while the trace files are written.
+struct ThreadEvents {
+  int tid;
+  int depth{0};  // Only accessed by the owning thread.
+  std::mutex mutex;
+  std::vector<ScopeEvent> scopes;
+  std::vector<CounterEvent> counters;
+};
+
+// JSON string literal.
+string json_quote(const string& s) {
+  string result = "\"";
+  for (char ch : s) {
+    if (ch == '"' || ch == '\\') {
+      result += '\\';
+      result += ch;
+    } else if (uchar(ch) < 0x20) {
+      result += sform("\\u%04x", int(ch));
+    } else {
+      result += ch;
+    }
+  }
+  return result + "\"";
+}
+
+// CSV field, quoted only if necessary.
+string csv_quote(const string& s) {
+  if (s.find_first_of(",\"\n") == string::npos) return s;
+  string result = "\"";
+  for (char ch : s) {
+    if (ch == '"') result += '"';
+    result += ch;
+  }
+  return result + "\"";
+}
+
+}  // namespace
+
+class Traces {
+ public:
+  static Traces& instance() {
+    static Traces& traces = *new Traces;
+    return traces;
+  }
+  ThreadEvents& thread_events() {
+    thread_local ThreadEvents* p_thread_events = nullptr;
+    if (!p_thread_events) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _threads.push_back(make_unique<ThreadEvents>());
+      p_thread_events = _threads.back().get();
+      p_thread_events->tid = int(_threads.size()) - 1;
+    }
+    return *p_thread_events;
+  }
+  void add_stat(Stat& stat) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.push_back(&stat);
+  }
+  double microseconds(int64_t counter) const {
+    return double(counter - _start_counter) * get_seconds_per_counter() * 1e6;
+  }
+  void flush_internal();
+  const string _filename{getenv_string("HH_TRACE")};
+
+ private:
+  Traces() { hh_at_clean_up(Traces::flush); }
+  ~Traces() = delete;
+  static void flush() { instance().flush_internal(); }
+  const int64_t _start_counter{get_precise_counter()};
+  std::mutex _mutex;
+  std::vector<unique_ptr<ThreadEvents>> _threads;
+  std::vector<Stat*> _stats;
+  bool _written{false};
+};
+
+void Traces::flush_internal() {
+  // The files are written just once, so a flush at program termination after an explicit hh_clean_up() does nothing.
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (std::exchange(_written, true)) return;
+  struct Summary {
+    int64_t num{0};
+    double sum{0.}, min{BIGFLOAT}, max{-BIGFLOAT};
+    void enter(double value) { num++, sum += value, min = std::min(min, value), max = std::max(max, value); }
+  };
+  std::map<string, Summary> timer_summaries, counter_summaries;
+  {
+    std::ofstream os(_filename);
+    if (!os) {
+      Warning("Cannot write HH_TRACE file");
+      return;
+    }
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (auto& thread : _threads) {
+      std::lock_guard<std::mutex> thread_lock(thread->mutex);
+      const auto separator = [&] { return std::exchange(first, false) ? "" : ",\n"; };
+      for (const ScopeEvent& event : thread->scopes) {
+        const double ts = microseconds(event.begin_counter), dur = microseconds(event.end_counter) - ts;
+        os << separator()
+           << sform("{\"name\": %s, \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d, "
+                    "\"args\": {\"depth\": %d}}",
+                    json_quote(event.name).c_str(), ts, dur, thread->tid, event.depth);
+        timer_summaries[event.name].enter(dur * 1e-6);
+      }
+      for (const CounterEvent& event : thread->counters) {
+        os << separator()
+           << sform("{\"name\": %s, \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"tid\": %d, "
+                    "\"args\": {\"value\": %.9g}}",
+                    json_quote(event.name).c_str(), microseconds(event.counter), thread->tid, event.value);
+        counter_summaries[event.name].enter(event.value);
+      }
+    }
+    os << "\n]}\n";
+    if (!os) Warning("Error writing HH_TRACE file");
+  }
+  std::ofstream os(get_path_root(_filename) + ".csv");
+  os << "kind,name,count,sum,min,max,avg,bin_low,bin_high\n";
+  const auto output_summary = [&](const char* kind, const string& name, const Summary& summary) {
+    os << sform("%s,%s,%lld,%.9g,%.9g,%.9g,%.9g,,\n", kind, csv_quote(name).c_str(), (long long)summary.num,
+                summary.sum, summary.min, summary.max, summary.sum / summary.num);
+  };
+  for (const auto& [name, summary] : timer_summaries) output_summary("timer", name, summary);
+  for (const auto& [name, summary] : counter_summaries) output_summary("counter", name, summary);
+  for (Stat* stat : _stats) {
+    stat->merge_threads();
+    if (!stat->num()) continue;
+    const string name = csv_quote(stat->name());
+    os << sform("stat,%s,%lld,%.9g,%.9g,%.9g,%.9g,,\n", name.c_str(), (long long)stat->num(), double(stat->sum()),
+                stat->min(), stat->max(), double(stat->sum()) / stat->num());
+    const int64_t* histogram = stat->histogram();
+    if (!histogram) continue;
+    const int center = Trace::k_num_histogram_bins / 2;
+    for_int(bin, Trace::k_num_histogram_bins) {
+      if (!histogram[bin]) continue;
+      double low = 0., high = 0.;
+      if (bin != center) {
+        const int exponent = std::abs(bin - center) - 33;
+        low = exponent == -32 ? 0. : std::ldexp(1., exponent);
+        high = exponent == 31 ? double(BIGFLOAT) : std::ldexp(1., exponent + 1);
+        if (bin < center) std::tie(low, high) = std::pair{-high, -low};
+      }
+      os << sform("histogram,%s,%lld,,,,,%.9g,%.9g\n", name.c_str(), (long long)histogram[bin], low, high);
+    }
+  }
+  if (!os) Warning("Error writing HH_TRACE summary file");
+}
+
+bool Trace::enabled() {
+  static const bool value = getenv_string("HH_TRACE") != "";
+  return value;
+}
+
+int64_t Trace::begin_scope() {
+  Traces::instance().thread_events().depth++;
+  return get_precise_counter();
+}
+
+void Trace::end_scope(const string& name, int64_t begin_counter) {
+  const int64_t end_counter = get_precise_counter();
+  ThreadEvents& thread_events = Traces::instance().thread_events();
+  const int depth = --thread_events.depth;
+  std::lock_guard<std::mutex> lock(thread_events.mutex);
+  thread_events.scopes.push_back(ScopeEvent{name, begin_counter, end_counter, depth});
+}
+
+void Trace::record_counter(const string& name, double value) {
+  const int64_t counter = get_precise_counter();
+  ThreadEvents& thread_events = Traces::instance().thread_events();
+  std::lock_guard<std::mutex> lock(thread_events.mutex);
+  thread_events.counters.push_back(CounterEvent{name, counter, value});
+}
+
+void Trace::record_stat(Stat& stat) { Traces::instance().add_stat(stat); }
+
+int Trace::histogram_bin(float value) {
+  const int center = k_num_histogram_bins / 2;
+  if (!(value != 0.f)) return center;  // Zero or NaN.
+  int exponent = 31;
+  if (std::isfinite(value)) {
+    std::frexp(value, &exponent);  // |value| == mantissa * 2^exponent, with mantissa in [0.5, 1).
+    exponent = clamp(exponent - 1, -32, 31);
+  }
+  const int offset = 33 + exponent;
+  return value > 0.f ? center + offset : center - offset;
+}
+
+void Trace::flush() {
+  if (enabled()) Traces::instance().flush_internal();
+}
+
+}  // namespace hh
@@ -0,0 +1,52 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_LIBHH_TRACE_H_
+#define MESH_PROCESSING_LIBHH_TRACE_H_
+
+#include "libHh/Hh.h"
+
+#if 0
+{
+  // export HH_TRACE=trace.json  # Then run any program.
+  // At program end (or in an earlier hh_clean_up()), this writes trace.json (Chrome trace-event format,
+  // which can be viewed in chrome://tracing or https://ui.perfetto.dev) and trace.csv (summary of timers,
+  // counters, and statistics).
+  {
+    HH_TIMER("_step");  // All named Timer scopes are recorded per thread, with their nesting depth.
+    HH_TRACE_COUNTER("nfaces", mesh.num_faces());
+    HH_SSTAT(Svdeg, mesh.degree(v));  // Static Stat objects are summarized with a log2 histogram.
+  }
+}
+#endif
+
+namespace hh {
+
+class Stat;
+
+// Thread-safe recording of timed scopes, counters, and statistics, enabled if getenv("HH_TRACE") is a filename.
+class Trace {
+ public:
+  static bool enabled();
+  // Return a time counter (as in get_precise_counter()) and increment the nesting depth for the current thread.
+  static int64_t begin_scope();
+  // Decrement the nesting depth and record a scope (which was started with begin_scope()).
+  static void end_scope(const string& name, int64_t begin_counter);
+  static void record_counter(const string& name, double value);
+  // Include a static Stat in the summary; its data is accessed upon program termination.
+  static void record_stat(Stat& stat);
+  // Stat histograms have bins on a log2 scale: bin k_num_histogram_bins / 2 counts zeros, and the bins at offsets
+  // +-(33 + floor(log2(|value|))) count positive and negative values, with the exponent clamped to [-32, 31].
+  static constexpr int k_num_histogram_bins = 129;
+  static int histogram_bin(float value);
+  // Write the trace files if not yet written (also done in hh_clean_up() and upon program termination).  Any events
+  // recorded after this are not written.
+  static void flush();
+};
+
+#define HH_TRACE_COUNTER(name, value)                                 \
+  do {                                                                \
+    if (hh::Trace::enabled()) hh::Trace::record_counter(name, value); \
+  } while (false)
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_LIBHH_TRACE_H_
@@ -2,6 +2,8 @@
 #ifndef MESH_PROCESSING_LIBHH_UNIONFIND_H_
 #define MESH_PROCESSING_LIBHH_UNIONFIND_H_
 
+#include <atomic>
+
 #include "libHh/Map.h"
 #include "libHh/PArray.h"
 
@@ -23,6 +25,26 @@ template <typename T> class UnionFind {
   T irep(T e, bool& present) const;
 };
 
+// Lock-free union-find over the elements [0, num), whose unify() may be called concurrently from many threads.
+// Uses path halving, and always links the larger root below the smaller one, so that once all unify() calls have
+//   completed, the label of each equivalence class is deterministically its smallest element.
+class ParallelUnionFind : noncopyable {
+ public:
+  explicit ParallelUnionFind(int num) : _num(num), _parent(make_unique<std::atomic<int>[]>(num)) {
+    assertx(num >= 0);
+    for_int(i, num) _parent[i].store(i, std::memory_order_relaxed);
+  }
+  int num() const { return _num; }
+  bool unify(int e1, int e2);        // thread-safe; returns: were_different
+  bool equal(int e1, int e2) const;  // meaningful only when no concurrent unify()
+  int get_label(int e) const { return irep(e); }
+
+ private:
+  int _num;
+  unique_ptr<std::atomic<int>[]> _parent;  // Path halving modifies it even in const functions.
+  int irep(int e) const;
+};
+
 //----------------------------------------------------------------------------
 
 template <typename T> T UnionFind<T>::irep(T e, bool& present) const {
@@ -76,6 +98,31 @@ template <typename T> void UnionFind<T>::promote(T e) {
   _m.replace(r, e);
 }
 
+inline int ParallelUnionFind::irep(int e) const {
+  ASSERTX(e >= 0 && e < _num);
+  for (;;) {
+    int parent = _parent[e].load(std::memory_order_relaxed);
+    if (parent == e) return e;
+    const int grandparent = _parent[parent].load(std::memory_order_relaxed);
+    // Path halving; if another thread has meanwhile changed _parent[e], it has also moved it closer to the root.
+    if (grandparent != parent) _parent[e].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+    e = grandparent;
+  }
+}
+
+inline bool ParallelUnionFind::unify(int e1, int e2) {
+  for (;;) {
+    int r1 = irep(e1), r2 = irep(e2);
+    if (r1 == r2) return false;
+    if (r1 < r2) std::swap(r1, r2);
+    // Link r1 below r2, provided that r1 is still a root.
+    int expected = r1;
+    if (_parent[r1].compare_exchange_strong(expected, r2, std::memory_order_relaxed)) return true;
+  }
+}
+
+inline bool ParallelUnionFind::equal(int e1, int e2) const { return e1 == e2 || irep(e1) == irep(e2); }
+
 }  // namespace hh
 
 #endif  // MESH_PROCESSING_LIBHH_UNIONFIND_H_
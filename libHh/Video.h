@@ -170,9 +170,12 @@ VideoNv12 scale(const VideoNv12& video_nv12, const Vec2<float>& syx, const Vec2<
                 const Pixel* bordervalue = nullptr, VideoNv12&& pnewvideo_nv12 = VideoNv12());
 
 // Read a video stream one image frame at a time.  getenv_string("VIDEO_IMPLEMENTATION") may equal "ffmpeg" or "mf".
+// If num_prefetch > 0, a background thread decodes up to that many frames ahead into a ring of preallocated buffers
+// (except with the "mf" implementation, whose COM objects must be used in the thread that created them).
 class RVideo {
  public:
-  explicit RVideo(string filename, bool use_nv12 = false);  // May throw std::runtime_error.
+  static constexpr int k_default_prefetch = 4;
+  explicit RVideo(string filename, bool use_nv12 = false, int num_prefetch = 0);  // May throw std::runtime_error.
   ~RVideo();
   const Vec3<int>& dims() const { return _dims; }  // (nframes, ysize, xsize).
   const Video::Attrib& attrib() const { return _attrib; }
@@ -183,6 +186,9 @@ class RVideo {
   [[nodiscard]] bool read(MatrixView<Pixel> frame);  // frame(ysize(), xsize()).  Return false if EOF.
   [[nodiscard]] bool read(Nv12View frame);           // Return false if EOF.
   [[nodiscard]] bool discard_frame();                // Skip the next frame; Return success (false if EOF).
+  // Same as read() but may exchange the buffer of frame (of dims spatial_dims()) with a prefetched one (no copy).
+  [[nodiscard]] bool read_swap(Matrix<Pixel>& frame);
+  [[nodiscard]] bool read_swap(Nv12& frame);
   class Implementation;
 
  private:
@@ -197,16 +203,23 @@ class RVideo {
 };
 
 // Write a video stream one image frame at a time.  getenv_string("VIDEO_IMPLEMENTATION") may equal "ffmpeg" or "mf".
+// If num_queued > 0, a background thread encodes frames from a ring of that many buffers; write() returns once the
+// frame is queued.  (The "mf" implementation is not pipelined, as its COM objects must stay in their thread.)
 class WVideo {
  public:
-  explicit WVideo(string filename, const Vec2<int>& spatial_dims, Video::Attrib attrib,
-                  bool use_nv12 = false);  // Dims are (y, x); may throw std::runtime_error.
+  static constexpr int k_default_queued = 4;
+  explicit WVideo(string filename, const Vec2<int>& spatial_dims, Video::Attrib attrib, bool use_nv12 = false,
+                  int num_queued = 0);  // Dims are (y, x); may throw std::runtime_error.
   ~WVideo();
   const Vec2<int>& spatial_dims() const { return _sdims; }
   int ysize() const { return _sdims[0]; }
   int xsize() const { return _sdims[1]; }
   void write(CMatrixView<Pixel> frame);
   void write(CNv12View frame);
+  // Same as write() but may exchange the buffer of frame with a free queued one (no copy); its content is then
+  // undefined.
+  void write_swap(Matrix<Pixel>& frame);
+  void write_swap(Nv12& frame);
   class Implementation;
 
  private:
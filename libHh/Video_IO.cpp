@@ -49,7 +49,11 @@ HH_REFERENCE_LIB("ole32.lib");        // PropVariantClear()
 //----------------------------------------------------------------------------
 
 #include <atomic>
-#include <cstring>  // memcpy()
+#include <condition_variable>
+#include <cstring>    // memcpy()
+#include <exception>  // std::exception_ptr
+#include <mutex>
+#include <thread>
 
 #include "libHh/ConsoleProgress.h"
 #include "libHh/FileIO.h"
@@ -96,7 +100,8 @@ void Video::read_file(const string& filename) {
   // Similar code in: Video::read_file(), VideoNv12::read_file(), and FilterVideo.cpp::read_video().
   HH_TIMER("_read_video");
   clear();
-  RVideo rvideo(filename);
+  const bool use_nv12 = false;
+  RVideo rvideo(filename, use_nv12, RVideo::k_default_prefetch);
   attrib() = rvideo.attrib();
   const int nfexpect = rvideo.nframes();
   assertw(nfexpect > 0);
@@ -127,7 +132,7 @@ void Video::write_file(const string& filename) const {
   string suffix = to_lower(get_path_extension(filename));
   if (suffix != "") const_cast<Video&>(*this).attrib().suffix = suffix;  // mutable
   const bool use_nv12 = false;
-  WVideo wvideo(filename, spatial_dims(), attrib(), use_nv12);
+  WVideo wvideo(filename, spatial_dims(), attrib(), use_nv12, WVideo::k_default_queued);
   ConsoleProgress cprogress("Vwrite");
   for_int(f, nframes()) {
     cprogress.update(float(f) / nframes());
@@ -142,7 +147,7 @@ void VideoNv12::read_file(const string& filename, Video::Attrib* pattrib) {
   HH_TIMER("_read_video");
   clear();
   const bool use_nv12 = true;
-  RVideo rvideo(filename, use_nv12);
+  RVideo rvideo(filename, use_nv12, RVideo::k_default_prefetch);
   if (pattrib) *pattrib = rvideo.attrib();
   const int nfexpect = rvideo.nframes();
   assertw(nfexpect > 0);
@@ -174,7 +179,7 @@ void VideoNv12::write_file(const string& filename, const Video::Attrib& pattrib)
   string suffix = to_lower(get_path_extension(filename));
   if (suffix != "") attrib.suffix = suffix;
   const bool use_nv12 = true;
-  WVideo wvideo(filename, _grid_Y.dims().tail<2>(), attrib, use_nv12);
+  WVideo wvideo(filename, _grid_Y.dims().tail<2>(), attrib, use_nv12, WVideo::k_default_queued);
   ConsoleProgress cprogress("Vwrite");
   const int nf = _grid_Y.dim(0);
   for_int(f, nf) {
@@ -190,6 +195,7 @@ class RVideo::Implementation {
   explicit Implementation(RVideo& rvideo) : _rvideo(rvideo) {}
   virtual ~Implementation() = default;
   virtual string name() const = 0;
+  virtual bool runs_in_any_thread() const { return true; }  // Else, it cannot be pipelined in a background thread.
   virtual bool read(MatrixView<Pixel> frame) = 0;
   virtual bool read_nv12(Nv12View frame) {  // default slow path
     const Vec2<int> sdims = _rvideo.spatial_dims();
@@ -209,6 +215,8 @@ class RVideo::Implementation {
       return read(tframe);
     }
   }
+  virtual bool read_swap(Matrix<Pixel>& frame) { return read(frame); }
+  virtual bool read_swap_nv12(Nv12& frame) { return read_nv12(frame); }
   static unique_ptr<Implementation> make(RVideo& rvideo);
 
  protected:
@@ -220,6 +228,7 @@ class WVideo::Implementation {
   explicit Implementation(WVideo& wvideo) : _wvideo(wvideo) {}
   virtual ~Implementation() = default;
   virtual string name() const = 0;
+  virtual bool runs_in_any_thread() const { return true; }  // Else, it cannot be pipelined in a background thread.
   virtual void write(CMatrixView<Pixel> frame) = 0;
   virtual void write_nv12(CNv12View frame) {  // default slow path
     assertx(product(_wvideo.spatial_dims()));
@@ -228,6 +237,8 @@ class WVideo::Implementation {
     convert_Nv12_to_Image(frame, tframe);
     write(tframe);
   }
+  virtual void write_swap(Matrix<Pixel>& frame) { write(frame); }
+  virtual void write_swap_nv12(Nv12& frame) { write_nv12(frame); }
   static unique_ptr<Implementation> make(WVideo& wvideo);
 
  protected:
@@ -256,9 +267,229 @@ class Unsupported_WVideo_Implementation : public WVideo::Implementation {
   }
 };
 
+//----------------------------------------------------------------------------
+// *** Pipelined decoding and encoding in a background thread
+
+namespace {
+
+const Vec2<int>& frame_dims(const Matrix<Pixel>& frame) { return frame.dims(); }
+Vec2<int> frame_dims(const Nv12& frame) { return frame.get_Y().dims(); }
+
+void assign_frame(CMatrixView<Pixel> src, MatrixView<Pixel> dst) { dst.assign(src); }
+void assign_frame(CMatrixView<Pixel> src, Nv12View dst) { convert_Image_to_Nv12(src, dst); }
+void assign_frame(CNv12View src, MatrixView<Pixel> dst) { convert_Nv12_to_Image(src, dst); }
+void assign_frame(CNv12View src, Nv12View dst) {
+  dst.get_Y().assign(src.get_Y());
+  dst.get_UV().assign(src.get_UV());
+}
+
+// Fixed ring of preallocated frames handed from a producer thread to a consumer thread.
+// Each side fills or drains the frame in place, so no frame is allocated or copied by the ring itself.
+template <typename Frame> class FrameRing : noncopyable {
+ public:
+  explicit FrameRing(int num, const Vec2<int>& sdims) : _frames(num) {
+    assertx(num > 0);
+    for (Frame& frame : _frames) frame.init(sdims);
+  }
+  // Producer: wait for a free frame; return nullptr if the consumer has closed the ring.
+  Frame* acquire_free() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&] { return _num < _frames.num() || _closed; });
+    return _closed ? nullptr : &_frames[(_head + _num) % _frames.num()];
+  }
+  void publish() {  // Producer: the frame from acquire_free() is ready.
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _num++;
+    }
+    _cv.notify_all();
+  }
+  void finish() {  // Producer: no more frames will be published.
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _finished = true;
+    }
+    _cv.notify_all();
+  }
+  // Consumer: wait for the oldest published frame; return nullptr once the producer has finished and all frames
+  // are consumed.
+  Frame* acquire_full() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&] { return _num > 0 || _finished; });
+    return _num ? &_frames[_head] : nullptr;
+  }
+  void release() {  // Consumer: the frame from acquire_full() may be reused.
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _head = (_head + 1) % _frames.num();
+      _num--;
+    }
+    _cv.notify_all();
+  }
+  void close() {  // Consumer: no more frames will be consumed.
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _closed = true;
+    }
+    _cv.notify_all();
+  }
+
+ private:
+  Array<Frame> _frames;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  int _head{0};  // Index of the oldest published frame.
+  int _num{0};   // Number of published frames not yet released.
+  bool _finished{false};
+  bool _closed{false};
+};
+
+}  // namespace
+
+// Decode frames ahead of the caller, using the wrapped implementation in a background thread.
+template <typename Frame> class Pipelined_RVideo_Implementation : public RVideo::Implementation {
+ public:
+  explicit Pipelined_RVideo_Implementation(RVideo& rvideo, unique_ptr<RVideo::Implementation> impl, int num)
+      : RVideo::Implementation(rvideo), _impl(std::move(impl)), _ring(num, rvideo.spatial_dims()) {
+    _thread = std::thread([this] { decode_frames(); });
+  }
+  ~Pipelined_RVideo_Implementation() override {
+    _ring.close();
+    _thread.join();
+  }
+  string name() const override { return "pipelined " + _impl->name(); }
+  bool read(MatrixView<Pixel> frame) override {
+    return consume([&](Frame& ring_frame) { assign_frame(ring_frame, frame); });
+  }
+  bool read_nv12(Nv12View frame) override {
+    return consume([&](Frame& ring_frame) { assign_frame(ring_frame, frame); });
+  }
+  bool discard_frame() override {
+    return consume([](Frame&) {});
+  }
+  bool read_swap(Matrix<Pixel>& frame) override { return consume_swap(frame); }
+  bool read_swap_nv12(Nv12& frame) override { return consume_swap(frame); }
+
+ private:
+  unique_ptr<RVideo::Implementation> _impl;
+  FrameRing<Frame> _ring;
+  std::thread _thread;
+  std::exception_ptr _exception;  // Set by the decoding thread before it finishes the ring.
+
+  bool decode(Matrix<Pixel>& frame) { return _impl->read(frame); }
+  bool decode(Nv12& frame) { return _impl->read_nv12(frame); }
+  void decode_frames() {
+    try {
+      while (Frame* frame = _ring.acquire_free()) {
+        if (!decode(*frame)) break;
+        _ring.publish();
+      }
+    } catch (...) {
+      _exception = std::current_exception();
+    }
+    _ring.finish();
+  }
+  template <typename Func> bool consume(Func func) {
+    Frame* ring_frame = _ring.acquire_full();
+    if (!ring_frame) {
+      if (_exception) std::rethrow_exception(_exception);
+      return false;
+    }
+    func(*ring_frame);
+    _ring.release();
+    return true;
+  }
+  template <typename T> bool consume_swap(T& frame) {
+    return consume([&](Frame& ring_frame) {
+      if constexpr (std::is_same_v<T, Frame>) {
+        assertx(frame_dims(frame) == _rvideo.spatial_dims());
+        using std::swap;
+        swap(frame, ring_frame);
+      } else {
+        frame.init(_rvideo.spatial_dims());
+        assign_frame(ring_frame, frame);
+      }
+    });
+  }
+};
+
+// Encode frames behind the caller, using the wrapped implementation in a background thread.
+template <typename Frame> class Pipelined_WVideo_Implementation : public WVideo::Implementation {
+ public:
+  explicit Pipelined_WVideo_Implementation(WVideo& wvideo, unique_ptr<WVideo::Implementation> impl, int num)
+      : WVideo::Implementation(wvideo), _impl(std::move(impl)), _ring(num, wvideo.spatial_dims()) {
+    _thread = std::thread([this] { encode_frames(); });
+  }
+  ~Pipelined_WVideo_Implementation() override {
+    _ring.finish();
+    _thread.join();
+    if (_exception) {
+      try {
+        std::rethrow_exception(_exception);
+      } catch (std::exception& ex) {
+        showf("Error encoding video: %s\n", ex.what());
+        Warning("Failed to encode all video frames");
+      }
+    }
+  }
+  string name() const override { return "pipelined " + _impl->name(); }
+  void write(CMatrixView<Pixel> frame) override {
+    assertx(frame.dims() == _wvideo.spatial_dims());
+    produce([&](Frame& ring_frame) { assign_frame(frame, ring_frame); });
+  }
+  void write_nv12(CNv12View frame) override {
+    assertx(frame.get_Y().dims() == _wvideo.spatial_dims());
+    produce([&](Frame& ring_frame) { assign_frame(frame, ring_frame); });
+  }
+  void write_swap(Matrix<Pixel>& frame) override { produce_swap(frame); }
+  void write_swap_nv12(Nv12& frame) override { produce_swap(frame); }
+
+ private:
+  unique_ptr<WVideo::Implementation> _impl;
+  FrameRing<Frame> _ring;
+  std::thread _thread;
+  std::exception_ptr _exception;  // Set by the encoding thread before it closes the ring.
+
+  void encode(const Matrix<Pixel>& frame) { _impl->write(frame); }
+  void encode(const Nv12& frame) { _impl->write_nv12(frame); }
+  void encode_frames() {
+    try {
+      while (Frame* frame = _ring.acquire_full()) {
+        encode(*frame);
+        _ring.release();
+      }
+    } catch (...) {
+      _exception = std::current_exception();
+      _ring.close();
+    }
+  }
+  template <typename Func> void produce(Func func) {
+    Frame* ring_frame = _ring.acquire_free();
+    if (!ring_frame) {
+      std::exception_ptr exception = std::exchange(_exception, nullptr);
+      assertx(exception);
+      std::rethrow_exception(exception);
+    }
+    func(*ring_frame);
+    _ring.publish();
+  }
+  template <typename T> void produce_swap(T& frame) {
+    assertx(frame_dims(frame) == _wvideo.spatial_dims());
+    produce([&](Frame& ring_frame) {
+      if constexpr (std::is_same_v<T, Frame>) {
+        using std::swap;
+        swap(frame, ring_frame);
+      } else {
+        assign_frame(frame, ring_frame);
+      }
+    });
+  }
+};
+
 //----------------------------------------------------------------------------
 
-RVideo::RVideo(string filename, bool use_nv12) : _filename(std::move(filename)), _use_nv12(use_nv12) {
+RVideo::RVideo(string filename, bool use_nv12, int num_prefetch)
+    : _filename(std::move(filename)), _use_nv12(use_nv12) {
   if (file_requires_pipe(_filename)) {
     RFile fi(_filename);
     int c = fi().peek();
@@ -274,6 +505,13 @@ RVideo::RVideo(string filename, bool use_nv12) : _filename(std::move(filename)),
   if (!file_exists(_filename)) throw std::runtime_error("Video file '" + _filename + "' does not exist");
   _attrib.suffix = to_lower(get_path_extension(_filename));
   _impl = Implementation::make(*this);
+  if (getenv_bool("VIDEO_NO_PIPELINE")) num_prefetch = 0;
+  if (num_prefetch > 0 && _impl->runs_in_any_thread()) {
+    if (_use_nv12)
+      _impl = make_unique<Pipelined_RVideo_Implementation<Nv12>>(*this, std::move(_impl), num_prefetch);
+    else
+      _impl = make_unique<Pipelined_RVideo_Implementation<Matrix<Pixel>>>(*this, std::move(_impl), num_prefetch);
+  }
   if (getenv_bool("VIDEO_DEBUG")) SHOW(_impl->name());
 }
 
@@ -291,7 +529,17 @@ bool RVideo::read(Nv12View frame) {
 
 bool RVideo::discard_frame() { return _impl->discard_frame(); }
 
-WVideo::WVideo(string filename, const Vec2<int>& spatial_dims, Video::Attrib attrib, bool use_nv12)
+bool RVideo::read_swap(Matrix<Pixel>& frame) {
+  assertw(!_use_nv12);
+  return _impl->read_swap(frame);
+}
+
+bool RVideo::read_swap(Nv12& frame) {
+  assertw(_use_nv12);
+  return _impl->read_swap_nv12(frame);
+}
+
+WVideo::WVideo(string filename, const Vec2<int>& spatial_dims, Video::Attrib attrib, bool use_nv12, int num_queued)
     : _filename(std::move(filename)),
       _sdims(spatial_dims),
       _attrib(std::move(attrib)),
@@ -310,6 +558,13 @@ WVideo::WVideo(string filename, const Vec2<int>& spatial_dims, Video::Attrib att
     _attrib.bitrate = 40'000'000;
   }
   _impl = Implementation::make(*this);
+  if (getenv_bool("VIDEO_NO_PIPELINE")) num_queued = 0;
+  if (num_queued > 0 && _impl->runs_in_any_thread()) {
+    if (_use_nv12)
+      _impl = make_unique<Pipelined_WVideo_Implementation<Nv12>>(*this, std::move(_impl), num_queued);
+    else
+      _impl = make_unique<Pipelined_WVideo_Implementation<Matrix<Pixel>>>(*this, std::move(_impl), num_queued);
+  }
   if (getenv_bool("VIDEO_DEBUG")) SHOW(_impl->name());
 }
 
@@ -328,6 +583,16 @@ void WVideo::write(CNv12View frame) {
   _impl->write_nv12(frame);
 }
 
+void WVideo::write_swap(Matrix<Pixel>& frame) {
+  assertw(!_use_nv12);
+  _impl->write_swap(frame);
+}
+
+void WVideo::write_swap(Nv12& frame) {
+  assertw(_use_nv12);
+  _impl->write_swap_nv12(frame);
+}
+
 //----------------------------------------------------------------------------
 // *** Video I/O
 
@@ -519,6 +784,8 @@ class Mf_RVideo_Implementation : public RVideo::Implementation {
     // Note that _init_com_mf.~Initialize_COM_MF() is called after this destructor
   }
   string name() const override { return "mf"; }
+  // The source reader belongs to the single-threaded COM apartment of the thread that created it.
+  bool runs_in_any_thread() const override { return false; }
   bool read(MatrixView<Pixel> frame) override {
     const Vec2<int> sdims = _rvideo.spatial_dims();
     assertx(frame.dims() == sdims);
@@ -720,6 +987,8 @@ class Mf_WVideo_Implementation : public WVideo::Implementation {
     // Note that _init_com_mf.~Initialize_COM_MF() is called after this destructor
   }
   string name() const override { return "mf"; }
+  // The sink writer belongs to the single-threaded COM apartment of the thread that created it.
+  bool runs_in_any_thread() const override { return false; }
   void write(CMatrixView<Pixel> frame) override {
     const Vec2<int> sdims = _wvideo.spatial_dims();
     assertx(product(_wvideo.spatial_dims()));
@@ -0,0 +1,111 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/WeldPoints.h"
+
+#include <algorithm>  // lower_bound()
+
+#include "libHh/Bbox.h"
+#include "libHh/Parallel.h"
+#include "libHh/RangeOp.h"  // fill()
+#include "libHh/UnionFind.h"
+
+namespace hh {
+
+namespace {
+
+constexpr int k_key_bits = 21;  // Number of bits per coordinate in a cell key.
+constexpr int k_max_cell = (1 << k_key_bits) - 1;
+
+uint64_t encode_cell(const Vec3<int>& ci) {
+  return (((uint64_t(ci[0]) << k_key_bits) | uint64_t(ci[1])) << k_key_bits) | uint64_t(ci[2]);
+}
+
+Vec3<int> decode_cell(uint64_t key) {
+  return Vec3<int>(int(key >> (2 * k_key_bits)), int((key >> k_key_bits) & k_max_cell), int(key & k_max_cell));
+}
+
+// Stable least-significant-digit radix sort of the indices [0, keys.num()) by their keys.
+Array<int> radix_sort_indices(CArrayView<uint64_t> keys) {
+  constexpr int k_digit_bits = 16, k_num_digits = 1 << k_digit_bits;
+  const int num = keys.num();
+  Array<int> order(num), order2(num);
+  for_int(i, num) order[i] = i;
+  uint64_t all_bits = 0;
+  for (const uint64_t key : keys) all_bits |= key;
+  Array<int> counts(k_num_digits);
+  for (int shift = 0; shift < 64 && (all_bits >> shift); shift += k_digit_bits) {
+    fill(counts, 0);
+    for (const uint64_t key : keys) counts[(key >> shift) & (k_num_digits - 1)]++;
+    int sum = 0;
+    for (int& count : counts) {
+      const int t = count;
+      count = sum;
+      sum += t;
+    }
+    for (const int i : order) order2[counts[(keys[i] >> shift) & (k_num_digits - 1)]++] = i;
+    std::swap(order, order2);
+  }
+  return order;
+}
+
+}  // namespace
+
+int weld_points(CArrayView<Point> points, Array<int>& point_class, float tolerance) {
+  tolerance = getenv_float("WELD_TOLERANCE", tolerance, true);
+  assertx(tolerance > 0.f && tolerance * k_max_cell > 1.f);
+  const int num = points.num();
+  point_class.init(num);
+  if (!num) return 0;
+  const Bbox bbox{points};
+  const float spacing = bbox.max_side() ? bbox.max_side() * tolerance : 1.f;
+  const float recip_spacing = 1.f / spacing;
+  Array<uint64_t> keys(num);
+  parallel_for_each({20}, range(num), [&](const int i) {
+    Vec3<int> ci;
+    for_int(c, 3) ci[c] = min(int((points[i][c] - bbox[0][c]) * recip_spacing), k_max_cell);
+    keys[i] = encode_cell(ci);
+  });
+  const Array<int> order = radix_sort_indices(keys);
+  // Runs of equal keys in the sorted order are the occupied cells.
+  Array<int> cell_start;
+  Array<uint64_t> cell_key;
+  for_int(k, num) {
+    const uint64_t key = keys[order[k]];
+    if (!k || key != cell_key.last()) {
+      cell_start.push(k);
+      cell_key.push(key);
+    }
+  }
+  cell_start.push(num);
+  const int num_cells = cell_key.num();
+  ParallelUnionFind union_find(num);
+  parallel_for_each({100}, range(num_cells), [&](const int cell) {
+    const int beg = cell_start[cell], end = cell_start[cell + 1];
+    for_intL(k, beg + 1, end) union_find.unify(order[beg], order[k]);
+    // Consider the 13 neighboring cells that follow this one in key order.
+    const Vec3<int> ci = decode_cell(cell_key[cell]);
+    for (const Vec3<int>& d : range(Vec3<int>(-1, -1, -1), Vec3<int>(2, 2, 2))) {
+      if (d[0] < 0 || (d[0] == 0 && (d[1] < 0 || (d[1] == 0 && d[2] <= 0)))) continue;
+      const Vec3<int> ni = ci + d;
+      if (!ni.in_range(thrice(k_max_cell + 1))) continue;
+      const uint64_t nkey = encode_cell(ni);
+      const auto it = std::lower_bound(cell_key.begin(), cell_key.end(), nkey);
+      if (it == cell_key.end() || *it != nkey) continue;
+      const int ncell = int(it - cell_key.begin());
+      const int nbeg = cell_start[ncell], nend = cell_start[ncell + 1];
+      bool is_near = false;
+      for (int k = beg; k < end && !is_near; k++)
+        for (int nk = nbeg; nk < nend && !is_near; nk++)
+          is_near = dist2(points[order[k]], points[order[nk]]) <= square(spacing);
+      if (is_near) union_find.unify(order[beg], order[nbeg]);
+    }
+  });
+  // Each class root is its smallest element, so numbering the roots in order numbers the classes in order.
+  int num_classes = 0;
+  for_int(i, num) point_class[i] = union_find.get_label(i) == i ? num_classes++ : -1;
+  parallel_for_each({20}, range(num), [&](const int i) {
+    if (point_class[i] < 0) point_class[i] = point_class[union_find.get_label(i)];
+  });
+  return num_classes;
+}
+
+}  // namespace hh
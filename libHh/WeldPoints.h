@@ -0,0 +1,29 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#ifndef MESH_PROCESSING_LIBHH_WELDPOINTS_H_
+#define MESH_PROCESSING_LIBHH_WELDPOINTS_H_
+
+#include "libHh/Array.h"
+#include "libHh/Geometry.h"
+
+#if 0
+{
+  Array<int> point_class;
+  const int num_classes = weld_points(points, point_class);
+  Array<Vertex> class_vertex(num_classes, nullptr);
+}
+#endif
+
+namespace hh {
+
+// Identify nearly coincident points, e.g. to weld the vertices of a triangle soup.
+// The points are quantized onto a grid whose spacing is tolerance times the largest side of their bounding box;
+// the environment variable WELD_TOLERANCE overrides the tolerance.
+// Two points are equivalent if they lie in the same grid cell, or in adjacent cells and within the grid spacing of
+// each other (and transitively).  Unlike HashPoint, the equivalence does not depend on the order of the points.
+// Sets point_class[i] for each points[i], with classes numbered in order of their first point; returns the number of
+// classes.  The quantized keys are radix-sorted, and the classes are resolved using a parallel union-find.
+int weld_points(CArrayView<Point> points, Array<int>& point_class, float tolerance = 1e-5f);
+
+}  // namespace hh
+
+#endif  // MESH_PROCESSING_LIBHH_WELDPOINTS_H_
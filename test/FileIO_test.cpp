@@ -5,6 +5,28 @@
 using namespace hh;
 
 int main() {
+  {
+    // Round trip through a gzip file, with enough data to span several compressed blocks.
+    TmpFile tmp_file("gz");
+    string s;
+    for_int(i, 200'000) s += sform("v %d %g\n", i, i * .5);
+    { WFile(tmp_file.filename())() << s; }
+    {
+      RFile fi(tmp_file.filename());
+      string line;
+      for_int(i, 200'000) {
+        assertx(my_getline(fi(), line, true));
+        assertx(line == sform("v %d %g", i, i * .5));
+      }
+      assert_reached_eof(fi());
+    }
+    {
+      RFile fi("gzip -d -c " + tmp_file.filename() + " |");  // The multi-member file is valid for gzip.
+      std::ostringstream oss;
+      oss << fi().rdbuf();
+      assertx(oss.str() == s);
+    }
+  }
   {
     const string url = "https://github.com/hhoppe/data/raw/main/LICENSE";
     RFile fi(url);
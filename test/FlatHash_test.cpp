@@ -0,0 +1,159 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/FlatHash.h"
+
+#include "libHh/Array.h"
+#include "libHh/Map.h"
+#include "libHh/Random.h"
+#include "libHh/RangeOp.h"  // sort()
+#include "libHh/Set.h"
+using namespace hh;
+
+namespace {
+
+struct BadHash {  // All keys collide in the low bits, to exercise long probe sequences.
+  size_t operator()(int i) const { return size_t(i) << 40; }
+};
+
+}  // namespace
+
+int main() {
+  {
+    const FlatMap<string, int> map = {{"first", 1}, {"second", 2}};
+    assertx(map.get("second") == 2);
+    assertx(map.num() == 2 && !map.contains("third"));
+  }
+  {
+    FlatMap<int, int> m;
+    assertx(m.num() == 0);
+    for (int i : m.keys()) {
+      (void(i));
+      if (1) assertnever("");
+    }
+    assertx(!m.contains(0) && m.retrieve(0) == 0);
+    for_int(i, 100) m.enter(i, i * 8);
+    assertx(m.num() == 100);
+    m.enter(998, 999);
+    assertx(m.contains(998) && !m.contains(999));
+    assertx(m.get(998) == 999);
+    assertx(m.remove(998) == 999);
+    assertx(!m.contains(998));
+    int sk = 0, sv = 0;
+    for (auto& [k, v] : m) {
+      assertx(k * 8 == v);
+      sk += k, sv += v;
+    }
+    assertx(sk == (0 + 99) * (100 / 2) && sv == sk * 8);
+    for_int(i, 50) assertx(m.remove(i) == i * 8);
+    assertx(m.num() == 50);
+    sk = 0, sv = 0;
+    for (int k : m.keys()) sk += k;
+    for (int v : m.values()) sv += v;
+    assertx(sk == (50 + 99) * (50 / 2) && sv == sk * 8);
+    for (int& v : m.values()) v++;
+    assertx(m.get(60) == 60 * 8 + 1);
+    bool is_new;
+    assertx(m.enter(60, 0, is_new) == 60 * 8 + 1 && !is_new);
+    assertx(m.enter(200, 7, is_new) == 7 && is_new);
+    assertx(m.replace(200, 8) == 7 && m[200] == 8);
+    m.clear();
+    assertx(m.empty());
+    for_int(i, 100) m.enter(i, i);
+    for_int(i, 100) {
+      const int val = m.get_random_value(Random::G);
+      assertx(m.remove(val) == val);
+    }
+    assertx(m.empty());
+  }
+  {
+    // Compare against Map over a random sequence of insertions and removals, including table growth, reuse of
+    // deleted slots, and shrinking.
+    Random random(5);
+    FlatMap<int, int> fm;
+    FlatMap<int, int, BadHash> fmbad;
+    Map<int, int> m;
+    for_int(iter, 200'000) {
+      const int phase = iter / 50'000;
+      const int key = int(random.get_unsigned(phase == 1 ? 100'000 : 3'000));
+      const bool do_remove = phase == 3 ? random.unif() < .9f : random.unif() < .3f;
+      if (do_remove) {
+        assertx(fm.remove(key) == m.retrieve(key));
+        assertx(fmbad.remove(key) == m.retrieve(key));
+        m.remove(key);
+      } else if (!m.contains(key)) {
+        m.enter(key, iter);
+        fm.enter(key, iter);
+        fmbad.enter(key, iter);
+      }
+      assertx(fm.num() == m.num() && fmbad.num() == m.num());
+    }
+    fm.shrink_to_fit();
+    fmbad.shrink_to_fit();
+    for (auto& [key, value] : m) assertx(fm.get(key) == value && fmbad.get(key) == value);
+    for (auto& [key, value] : fm) assertx(m.get(key) == value);
+    const FlatMap<int, int> fm2 = fm;
+    assertx(fm2.num() == fm.num());
+    for (auto& [key, value] : fm2) assertx(fm.get(key) == value);
+  }
+  {
+    // Removing elements (even nearly all of them) during an iteration keeps the iteration valid.
+    FlatMap<int, int> m;
+    for_int(i, 1000) m.enter(i, i);
+    int num_visited = 0;
+    for (const auto& [key, value] : m) {
+      num_visited++;
+      const int k = key, v = value;  // Copies, since the removal destroys the element.
+      if (k % 100) assertx(m.remove(k) == v);
+    }
+    assertx(num_visited == 1000 && m.num() == 10);
+    for_int(i, 100) assertx(m.get_random_key(Random::G) % 100 == 0);  // Random access in the sparse table.
+    m.shrink_to_fit();
+    for_int(i, 10) assertx(m.get(i * 100) == i * 100);
+  }
+  {
+    FlatMap<string, string> m;
+    m.enter("abc", "12");
+    m.enter("abcd", "13");
+    m.enter("ab", "14");
+    assertx(!m.contains("abcde") && m.retrieve("abcde") == "");
+    assertx(m.remove("abc") == "12");
+    assertx(m.replace("abcd", "113") == "13");
+    Array<string> ar(m.keys());
+    sort(ar);
+    for (const string& s : ar) SHOW(s, m[s]);
+    assertx(m.remove("ab") == "14");
+    SHOW(m);
+  }
+  {
+    FlatMap<int, unique_ptr<int>> m;  // Move-only values.
+    for_int(i, 1000) m.enter(i, make_unique<int>(i));
+    FlatMap<int, unique_ptr<int>> m2 = std::move(m);
+    assertx(m.empty() && m2.num() == 1000);
+    for_int(i, 1000) assertx(*m2.get(i) == i);
+    assertx(*m2.remove(7) == 7 && !m2.remove(7));
+  }
+  {
+    FlatSet<int> set;
+    for_int(i, 20) set.enter(i * 3);
+    assertx(set.num() == 20 && set.contains(9) && !set.contains(10));
+    assertx(!set.add(9) && set.add(10));
+    assertx(set.remove(10) && !set.remove(10));
+    int sum = 0;
+    for (int i : set) sum += i;
+    SHOW(sum);
+    FlatSet<int> set2{1, 3, 5, 7};
+    set.merge(set2);
+    assertx(set.num() == 23 && set2.num() == 1 && set2.contains(3));
+    Array<int> ar;
+    while (!set.empty()) ar.push(set.remove_random(Random::G));
+    sort(ar);
+    SHOW(ar);
+  }
+}
+
+namespace hh {
+
+template class FlatMap<int, int>;
+template class FlatMap<string, string>;
+template class FlatSet<int>;
+
+}  // namespace hh
@@ -78,12 +78,68 @@ int main() {
     assertx(GMesh::string_update(s3, "uv", nullptr) == "");  // not == nullptr
     SHOW(GMesh::string_update(s3, "sharp", ""));
   }
+  {
+    GMesh mesh;
+    Vec4<Vertex> va;
+    for_int(i, 4) {
+      va[i] = mesh.create_vertex();
+      mesh.set_point(va[i], Point(float(i % 2), float(i / 2), 0.f));
+    }
+    mesh.set_string(va[0], "rgb=(1 0 0) uv=(0 0)");
+    mesh.set_string(va[1], "rgb=(0 1 0)");
+    Face f1 = mesh.create_face(va[0], va[1], va[3]);
+    Face f2 = mesh.create_face(va[0], va[3], va[2]);
+    mesh.set_string(f2, "rgb=(.5 .5 .5)");
+    mesh.set_string(mesh.corner(va[3], f1), "rgb=(0 0 1)");
+    GMeshChannel& vrgb = mesh.vertex_channel("rgb", 3);
+    GMeshChannel& frgb = mesh.face_channel("rgb", 3);
+    GMeshChannel& crgb = mesh.corner_channel("rgb", 3);
+    assertx(&mesh.vertex_channel("rgb", 3) == &vrgb);
+    Vector rgb;
+    string str;
+    for (Vertex v : mesh.ordered_vertices())
+      showf("vertex %d rgb: %s\n", mesh.vertex_id(v), vrgb.get(v, rgb) ? csform_vec(str, rgb) : "none");
+    for (Face f : mesh.ordered_faces()) {
+      showf("face %d rgb: %s\n", mesh.face_id(f), frgb.get(f, rgb) ? csform_vec(str, rgb) : "none");
+      for (Corner c : mesh.corners(f)) {
+        Vector rgb2;
+        const bool present2 = mesh.parse_corner_key_vec(c, "rgb", rgb2);
+        assertx(crgb.get(c, rgb) == present2 && (!present2 || rgb == rgb2));
+      }
+    }
+    mesh.update_string(va[1], "rgb", "(0 .25 0)");
+    assertx(vrgb.get(va[1], rgb) && rgb == Vector(0.f, .25f, 0.f));
+    assertx(crgb.get(mesh.corner(va[1], f1), rgb) && rgb == Vector(0.f, .25f, 0.f));
+    mesh.update_string(mesh.corner(va[3], f1), "rgb", nullptr);
+    assertx(!crgb.get(mesh.corner(va[3], f1), rgb));
+    mesh.collapse_edge_vertex(mesh.edge(va[0], va[1]), va[1]);  // Corners of va[0] now refer to va[1].
+    for (Face f : mesh.faces())
+      for (Corner c : mesh.corners(f)) {
+        Vector rgb2;
+        const bool present2 = mesh.parse_corner_key_vec(c, "rgb", rgb2);
+        assertx(crgb.get(c, rgb) == present2 && (!present2 || rgb == rgb2));
+      }
+    Face f3 = mesh.create_face(va[3], va[1], mesh.create_vertex());  // Its corners get slots in crgb.
+    mesh.set_string(mesh.corner(va[3], f3), "rgb=(1 1 0)");
+    assertx(crgb.get(mesh.corner(va[3], f3), rgb) && rgb == Vector(1.f, 1.f, 0.f));
+    assertx(crgb.get(mesh.corner(va[1], f3), rgb) && rgb == Vector(0.f, .25f, 0.f));  // From the vertex string.
+    mesh.renumber();
+    for (Face f : mesh.faces()) assertx(frgb.get(f, rgb) == (mesh.get_string(f) != nullptr));
+    mesh.clear_channels();
+  }
   {
     GMesh mesh;
     mesh.read(RFile("-")());
     show_mesh(mesh);
     SHOW("original");
     mesh.write(std::cout);
+    {
+      GMesh mesh2;
+      mesh2.copy_faces(mesh, V(mesh.id_face(2), mesh.id_face(1)));
+      SHOW("copy_faces");
+      mesh2.write(std::cout);
+      SHOW(mesh2.face_id(mesh2.create_face(mesh2.id_vertex(1), mesh2.id_vertex(4), mesh2.id_vertex(7))));
+    }
     SHOW("renumbered");
     mesh.renumber();
     mesh.write(std::cout);
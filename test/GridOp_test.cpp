@@ -253,4 +253,32 @@ int main() {
     assertx(view.dims() == V(1, 20, 20));
     assertx(equal(view[0], grid));
   }
+  if (1) {  // box-filter Gaussian blur approximates convolution with the exact Gaussian kernel
+    const float sdv = 6.f;
+    Array<float> kernel(2 * 25 + 1);
+    for_int(i, kernel.num()) kernel[i] = gaussian(float(i - 25), sdv);
+    kernel /= float(sum(kernel));
+    for (const Bndrule bndrule : {Bndrule::reflected, Bndrule::periodic, Bndrule::clamped, Bndrule::border}) {
+      Grid<2, Pixel> grid(V(40, 37));
+      for (const auto& yx : range(grid.dims()))
+        grid[yx] = Pixel(uint8_t((yx[0] * 7) % 256), uint8_t(yx[1] * 6), 80, 255);
+      const Pixel bordervalue(255, 0, 0, 255);
+      Grid<2, Pixel> grid_exact(grid), grid_box(grid);
+      for_int(d, 2) {
+        grid_exact = convolve_d(grid_exact, d, kernel, bndrule, &bordervalue);
+        grid_box = gaussian_blur_d(grid_box, d, sdv, bndrule, &bordervalue);
+      }
+      int max_diff = 0;
+      for_size_t(i, grid.size()) {
+        for_int(c, 4) max_diff = max(max_diff, abs(grid_exact.flat(i)[c] - grid_box.flat(i)[c]));
+      }
+      SHOW(bndrule, max_diff);
+    }
+    Grid<3, float> grid(V(4, 5, 6));
+    for_size_t(i, grid.size()) grid.flat(i) = float(i % 7);
+    for_int(d, 3) {
+      assertx(max_abs_element(gaussian_blur_d(grid, d, 0.f, Bndrule::reflected) - grid) < 1e-6f);
+      assertx(abs(sum(gaussian_blur_d(grid, d, 3.f, Bndrule::periodic)) - sum(grid)) < 1e-3);
+    }
+  }
 }
@@ -1,6 +1,7 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
 #include "libHh/Image.h"
 
+#include "libHh/Random.h"
 #include "libHh/Stat.h"
 using namespace hh;
 
@@ -25,4 +26,58 @@ int main() {
       SHOW(newgrid.dims());
     }
   }
+  if (1) {
+    // Width 70 exercises both the vectorized conversions and their scalar remainders.
+    Image image(V(4, 70));
+    for_int(y, image.ysize()) for_int(x, image.xsize()) image[y][x] = Pixel(uint8_t(x * 3), uint8_t(y * 60), 128, 255);
+    Nv12 nv12(image.dims());
+    convert_Image_to_Nv12(image, nv12);
+    const Vec2<uint8_t>& uv = nv12.get_UV()[1][34];
+    SHOW(int(nv12.get_Y()[0][0]), int(nv12.get_Y()[3][69]), int(uv[0]), int(uv[1]));
+    Image image2(image.dims()), image3(image.dims());
+    convert_Nv12_to_Image(nv12, image2);
+    convert_Nv12_to_Image_BGRA(nv12, image3);
+    SHOW(image2[0][0], image2[3][69]);
+    int max_diff = 0;
+    for_int(y, image.ysize()) for_int(x, image.xsize()) {
+      const Pixel& p3 = image3[y][x];
+      assertx(image2[y][x] == Pixel(p3[2], p3[1], p3[0], p3[3]));
+      for_int(c, 3) max_diff = max(max_diff, abs(image[y][x][c] - image2[y][x][c]));
+    }
+    SHOW(max_diff);
+  }
+  if (1) {
+    // The vectorized conversions match the per-pixel formulas bit for bit, for all widths of their scalar remainders.
+    const auto random_byte = [] { return uint8_t(Random::G.get_unsigned(256)); };
+    for (int nx = 2; nx <= 70; nx += 2) {
+      const int ny = 4;
+      Image image(V(ny, nx));
+      for_int(y, ny) for_int(x, nx) image[y][x] = Pixel(random_byte(), random_byte(), random_byte(), 255);
+      Nv12 nv12(image.dims());
+      convert_Image_to_Nv12(image, nv12);
+      for_int(y, ny) for_int(x, nx) assertx(nv12.get_Y()[y][x] == Y_from_RGB(image[y][x]));
+      for_int(yb, ny / 2) for_int(xb, nx / 2) {
+        int r = 0, g = 0, b = 0;  // Sums over the 2x2 block.
+        for_int(yi, 2) for_int(xi, 2) {
+          const Pixel& pix = image[yb * 2 + yi][xb * 2 + xi];
+          r += pix[0], g += pix[1], b += pix[2];
+        }
+        const Vec2<uint8_t>& uv = nv12.get_UV()[yb][xb];
+        assertx(uv[0] == ((-38 * r - 74 * g + 112 * b + 128 * 4 + 2 * (-38 - 74 + 112) + 128 * 1024) >> 10));
+        assertx(uv[1] == ((112 * r - 94 * g - 18 * b + 128 * 4 + 2 * (112 - 94 - 18) + 128 * 1024) >> 10));
+      }
+      // Arbitrary YUV values also exercise the saturation of the RGB results.
+      for_int(y, ny) for_int(x, nx) nv12.get_Y()[y][x] = random_byte();
+      for_int(yb, ny / 2) for_int(xb, nx / 2) nv12.get_UV()[yb][xb] = V(random_byte(), random_byte());
+      Image image2(image.dims()), image3(image.dims());
+      convert_Nv12_to_Image(nv12, image2);
+      convert_Nv12_to_Image_BGRA(nv12, image3);
+      for_int(y, ny) for_int(x, nx) {
+        const Vec2<uint8_t>& uv = nv12.get_UV()[y / 2][x / 2];
+        const Pixel pix = RGB_Pixel_from_YUV(nv12.get_Y()[y][x], uv[0], uv[1]);
+        assertx(image2[y][x] == pix);
+        assertx(image3[y][x] == Pixel(pix[2], pix[1], pix[0], pix[3]));
+      }
+    }
+  }
 }
@@ -0,0 +1,77 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/MeshGeodesic.h"
+
+#include "libHh/GraphOp.h"  // Dijkstra
+using namespace hh;
+
+int main() {
+  // A planar grid of n x n vertices with unit spacing, each square split into two right triangles.
+  const int n = 201;
+  GMesh mesh;
+  Matrix<Vertex> verts(n, n);
+  for_int(y, n) for_int(x, n) {
+    verts[y][x] = mesh.create_vertex();
+    mesh.set_point(verts[y][x], Point(float(x), float(y), 0.f));
+  }
+  for_int(y, n - 1) for_int(x, n - 1) {
+    mesh.create_face(verts[y][x], verts[y][x + 1], verts[y + 1][x + 1]);
+    mesh.create_face(verts[y][x], verts[y + 1][x + 1], verts[y + 1][x]);
+  }
+  const MeshGeodesic geodesic(mesh);
+  SHOW(geodesic.num(), geodesic.delta());
+  const int icenter = geodesic.index(verts[n / 2][n / 2]);
+  const int icorner = geodesic.index(verts[0][n - 1]);
+  Array<float> dist(geodesic.num());
+  {
+    geodesic.distances(V(icenter), dist);
+    Graph<int> graph;
+    for_int(i, geodesic.num()) {
+      graph.enter(i);
+      for (const int j : geodesic.neighbors(i)) graph.enter(i, j);
+    }
+    const auto fdist = [&](int i, int j) { return ::hh::dist(mesh.point(geodesic.vertices()[i]),
+                                                             mesh.point(geodesic.vertices()[j])); };
+    Dijkstra dijkstra(&graph, icenter, fdist);
+    float max_err = 0.f;
+    for (int count = 0; !dijkstra.done(); count++) {
+      float d;
+      const int i = dijkstra.next(d);
+      max_err = max(max_err, abs(dist[i] - d));
+    }
+    assertx(max_err < 1e-4f);
+    showf("graph: corner distance %.4f (euclidean %.4f)\n", dist[icorner],
+          ::hh::dist(mesh.point(verts[0][n - 1]), mesh.point(verts[n / 2][n / 2])));
+  }
+  {
+    geodesic.distances(V(icenter), dist, MeshGeodesic::EMetric::fast_marching);
+    float max_rel_err = 0.f;
+    for_int(i, geodesic.num()) {
+      const float d = ::hh::dist(mesh.point(geodesic.vertices()[i]), mesh.point(verts[n / 2][n / 2]));
+      if (d > 10.f) max_rel_err = max(max_rel_err, abs(dist[i] - d) / d);
+    }
+    showf("fast_marching: corner distance %.2f max_rel_err=%.4f\n", dist[icorner], max_rel_err);
+  }
+  {
+    geodesic.distances(V(icenter), dist, MeshGeodesic::EMetric::graph, 5.f);
+    int num_reached = 0;
+    for (const float d : dist) num_reached += d != BIGFLOAT;
+    SHOW(num_reached);
+  }
+  {
+    const Array<int> sources = {icenter, icorner, geodesic.index(verts[n - 1][0]), geodesic.index(verts[3][7])};
+    for (const auto metric : {MeshGeodesic::EMetric::graph, MeshGeodesic::EMetric::fast_marching}) {
+      const Matrix<float> dists = geodesic.distances_from_each(sources, metric);
+      for_int(s, sources.num()) {
+        geodesic.distances(sources.slice(s, s + 1), dist, metric);
+        assertx(dists[s] == dist);
+      }
+      if (metric == MeshGeodesic::EMetric::fast_marching) continue;  // Merging fronts interact in fast marching.
+      geodesic.distances(sources, dist, metric);
+      for_int(i, geodesic.num()) {
+        float dmin = BIGFLOAT;
+        for_int(s, sources.num()) dmin = min(dmin, dists[s][i]);
+        assertx(abs(dist[i] - dmin) < 1e-4f);
+      }
+    }
+  }
+}
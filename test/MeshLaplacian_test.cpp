@@ -0,0 +1,43 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/MeshLaplacian.h"
+
+#include "libHh/RangeOp.h"  // sort()
+using namespace hh;
+
+int main() {
+  // A fan of 4 triangles around an interior vertex (the apex), with a boundary ring of 4 vertices.
+  GMesh mesh;
+  const Vertex vapex = mesh.create_vertex();
+  mesh.set_point(vapex, Point(0.f, 0.f, 1.f));
+  Array<Vertex> ring;
+  for (const Point& p : {Point(1.f, 0.f, 0.f), Point(0.f, 1.f, 0.f), Point(-1.f, 0.f, 0.f), Point(0.f, -1.f, 0.f)}) {
+    ring.push(mesh.create_vertex());
+    mesh.set_point(ring.last(), p);
+  }
+  for_int(i, 4) mesh.create_face(vapex, ring[i], ring[(i + 1) % 4]);
+  for (const auto weights : {MeshLaplacian::EWeights::uniform, MeshLaplacian::EWeights::cotangent}) {
+    const MeshLaplacian laplacian(mesh, weights);
+    assertx(laplacian.num() == 5);
+    for_int(i, laplacian.num()) {
+      const Vertex v = laplacian.vertices()[i];
+      assertx(laplacian.index(v) == i);
+      Array<int> ids;
+      for (const int j : laplacian.neighbors(i)) ids.push(mesh.vertex_id(laplacian.vertices()[j]));
+      sort(ids);
+      float sum_w = 0.f;
+      for (const float w : laplacian.weights(i)) sum_w += w;
+      string s;
+      for (const int id : ids) s += sform(" %d", id);
+      showf("v%d neighbors:%s sum_w=%g\n", mesh.vertex_id(v), s.c_str(), sum_w);
+    }
+    Array<Point> points = laplacian.get_points(mesh), newpoints(points.num());
+    laplacian.smooth_step(points, newpoints, .5f);
+    for_int(i, laplacian.num()) {
+      const int id = mesh.vertex_id(laplacian.vertices()[i]);
+      SHOW(id, newpoints[i]);
+    }
+    Array<bool> movable(laplacian.num(), false);
+    laplacian.smooth_step(points, newpoints, 1.f, movable);
+    assertx(newpoints == points);
+  }
+}
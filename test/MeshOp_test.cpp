@@ -0,0 +1,110 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/MeshOp.h"
+
+#include "libHh/Array.h"
+#include "libHh/Random.h"
+#include "libHh/RangeOp.h"  // sort(), contains()
+using namespace hh;
+
+namespace {
+
+// Grid of n * n quads, each split into two triangles, created in a shuffled order so that the ids of both
+// vertices and faces are unrelated to their positions.  Each vertex has a string "key=i" for its grid index.
+GMesh create_shuffled_grid(int n) {
+  GMesh mesh;
+  Random random;
+  const int nv = square(n + 1);
+  Array<int> vorder(nv);
+  for_int(i, nv) vorder[i] = i;
+  shuffle(vorder, random);
+  Array<Vertex> va(nv);
+  for (const int i : vorder) {
+    va[i] = mesh.create_vertex();
+    mesh.set_point(va[i], Point(float(i % (n + 1)), float(i / (n + 1)), 0.f));
+    mesh.set_string(va[i], sform("key=%d", i).c_str());
+  }
+  Array<Vec3<int>> triangles;
+  for_int(y, n) for_int(x, n) {
+    const int i = y * (n + 1) + x;
+    triangles.push(V(i, i + 1, i + n + 2));
+    triangles.push(V(i, i + n + 2, i + n + 1));
+  }
+  shuffle(triangles, random);
+  for (const Vec3<int>& triangle : triangles)
+    mesh.create_face(va[triangle[0]], va[triangle[1]], va[triangle[2]]);
+  return mesh;
+}
+
+int vertex_key(const GMesh& mesh, Vertex v) {
+  string str;
+  return to_int(assertx(GMesh::string_key(str, mesh.get_string(v), "key")));
+}
+
+// Faces as sequences of vertex keys, each rotated to start at its smallest key, sorted.
+Array<string> face_signatures(const GMesh& mesh) {
+  Array<string> signatures;
+  for (Face f : mesh.faces()) {
+    const Vec3<Vertex> va = mesh.triangle_vertices(f);
+    Vec3<int> signature = map(va, [&](Vertex v) { return vertex_key(mesh, v); });
+    while (signature[0] != min(signature)) signature = V(signature[1], signature[2], signature[0]);
+    signatures.push(sform("%d %d %d", signature[0], signature[1], signature[2]));
+  }
+  sort(signatures);
+  return signatures;
+}
+
+// Mean difference in id between the two vertices of each edge, and between the two faces of each interior edge.
+Vec2<float> mean_id_spans(const GMesh& mesh) {
+  double sum_v = 0., sum_f = 0.;
+  int num_f = 0;
+  for (Edge e : mesh.edges()) {
+    sum_v += abs(mesh.vertex_id(mesh.vertex1(e)) - mesh.vertex_id(mesh.vertex2(e)));
+    if (mesh.is_boundary(e)) continue;
+    sum_f += abs(mesh.face_id(mesh.face1(e)) - mesh.face_id(mesh.face2(e)));
+    num_f++;
+  }
+  return V(float(sum_v / mesh.num_edges()), float(sum_f / num_f));
+}
+
+}  // namespace
+
+int main() {
+  GMesh mesh = create_shuffled_grid(40);
+  for (Edge e : mesh.edges())
+    if (mesh.is_boundary(e)) mesh.flags(e).flag(GMesh::eflag_sharp) = true;
+  const Face f0 = mesh.id_face(1);
+  mesh.set_string(f0, "rgb=(1 0 0)");
+  const int f0_key = vertex_key(mesh, mesh.triangle_vertices(f0)[0]);
+  const Array<string> signatures = face_signatures(mesh);
+  const Vec2<float> spans = mean_id_spans(mesh);
+  const int nv = mesh.num_vertices(), nf = mesh.num_faces(), ne = mesh.num_edges();
+
+  reorder_for_locality(mesh);
+  mesh.ok();
+  showf("nv=%d nf=%d ne=%d\n", mesh.num_vertices(), mesh.num_faces(), mesh.num_edges());
+  assertx(mesh.num_vertices() == nv && mesh.num_faces() == nf && mesh.num_edges() == ne);
+  assertx(face_signatures(mesh) == signatures);
+  for (Vertex v : mesh.vertices()) {
+    const int i = vertex_key(mesh, v);
+    assertx(mesh.point(v) == Point(float(i % 41), float(i / 41), 0.f));
+  }
+  int num_sharp = 0, num_rgb = 0;
+  for (Edge e : mesh.edges()) {
+    const bool is_sharp = mesh.flags(e).flag(GMesh::eflag_sharp);
+    assertx(is_sharp == mesh.is_boundary(e));
+    num_sharp += is_sharp;
+  }
+  for (Face f : mesh.faces()) {
+    if (!mesh.get_string(f)) continue;
+    assertx(!strcmp(mesh.get_string(f), "rgb=(1 0 0)"));
+    const Vec3<int> keys = map(mesh.triangle_vertices(f), [&](Vertex v) { return vertex_key(mesh, v); });
+    assertx(contains(keys, f0_key));
+    num_rgb++;
+  }
+  showf("num_sharp=%d num_rgb=%d\n", num_sharp, num_rgb);
+
+  // Ids should now follow spatial proximity much more closely than the shuffled creation order.
+  const Vec2<float> new_spans = mean_id_spans(mesh);
+  showf("vertex span reduced=%d face span reduced=%d\n",  //
+        new_spans[0] * 4.f < spans[0], new_spans[1] * 4.f < spans[1]);
+}
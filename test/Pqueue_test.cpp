@@ -241,6 +241,63 @@ void test9() {
   }
 }
 
+// Intrusive index slots for elements 0..99 of IPqueue.
+Array<int> g_pq_index(100, 0);
+struct PqIndex {
+  int& operator()(int i) const { return g_pq_index[i]; }
+};
+
+void test10() {
+  std::default_random_engine random_engine;
+  for_int(itest, 200) {
+    const int n = 100;
+    IPqueue<int, PqIndex> ipq;
+    HPqueue<int> hpq;
+    if (itest % 2) {
+      for_int(i, n) {
+        const float pri = float(random_engine() % 50);
+        ipq.enter_unsorted(i, pri), hpq.enter_unsorted(i, pri);
+      }
+      ipq.sort(), hpq.sort();
+    } else {
+      ipq.sort(), hpq.sort();  // Sorting an empty queue.
+      assertx(ipq.empty());
+    }
+    for_int(iop, 300) {
+      const int i = int(random_engine() % n);
+      const float pri = float(random_engine() % 50);
+      switch (random_engine() % 6) {
+        case 0: assertx(ipq.enter_update(i, pri) == hpq.enter_update(i, pri)); break;
+        case 1: assertx(ipq.update(i, pri) == hpq.update(i, pri)); break;
+        case 2: assertx(ipq.remove(i) == hpq.remove(i)); break;
+        case 3: assertx(ipq.enter_update_if_smaller(i, pri) == hpq.enter_update_if_smaller(i, pri)); break;
+        case 4: assertx(ipq.enter_update_if_greater(i, pri) == hpq.enter_update_if_greater(i, pri)); break;
+        case 5:
+          if (!ipq.empty()) {
+            const float min_pri = ipq.min_priority();
+            assertx(min_pri == hpq.min_priority());
+            assertx(hpq.remove(ipq.remove_min()) == min_pri);  // With ties, the removed elements may differ.
+          }
+          break;
+        default: assertnever("");
+      }
+      assertx(ipq.num() == hpq.num());
+      for_int(j, n) assertx(ipq.retrieve(j) == hpq.retrieve(j));
+    }
+    float a = 0.f;
+    while (!ipq.empty()) {
+      const float b = ipq.min_priority();
+      assertx(b >= a);
+      a = b;
+      const int i = ipq.remove_min();
+      assertx(hpq.remove(i) == b);
+      assertx(!ipq.contains(i));
+    }
+    assertx(hpq.empty());
+    for_int(i, n) assertx(g_pq_index[i] == 0);
+  }
+}
+
 }  // namespace
 
 int main() {
@@ -253,6 +310,7 @@ int main() {
   test7();
   test8();
   test9();
+  test10();
 }
 
 template class hh::Pqueue<unsigned>;
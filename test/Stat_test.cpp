@@ -2,6 +2,7 @@
 #include "libHh/Stat.h"
 
 #include "libHh/Array.h"
+#include "libHh/Parallel.h"
 #include "libHh/Vec.h"
 using namespace hh;
 
@@ -26,6 +27,8 @@ int main() {
   }
   SHOW("before Stot");
   HH_SSTAT(Stot, 0);
+  // Static Stat objects may be entered concurrently.
+  parallel_for_each({1}, range(100'000), [&](const int i) { HH_SSTAT(Sparallel, i % 10); });
   {
     Stat Svar("Svar", true);
     for_int(i, 100) Svar.enter(i);
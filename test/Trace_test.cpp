@@ -0,0 +1,55 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/Trace.h"
+
+#include "libHh/FileIO.h"
+#include "libHh/Parallel.h"
+#include "libHh/Stat.h"
+#include "libHh/StringOp.h"
+#include "libHh/Timer.h"
+using namespace hh;
+
+int main() {
+  my_setenv("HH_TRACE", "Trace_test.tmp.json");
+  my_setenv("HH_HIDE_SUMMARIES", "1");
+  Timer::set_show_times(-1);
+  SHOW(Trace::enabled());
+  for (float value : {0.f, 1.f, 1.5f, 2.f, -3.f, 1e-20f, 1e20f}) SHOW(value, Trace::histogram_bin(value));
+  {
+    HH_TIMER("outer");
+    {
+      HH_TIMER("inner");
+      HH_TRACE_COUNTER("count", 3);
+    }
+    parallel_for_each(range(100), [&](int i) {
+      HH_TIMER("task");
+      HH_TRACE_COUNTER("index", i);
+    });
+    for_int(i, 10) HH_SSTAT(Svalue, i);
+  }
+  hh_clean_up();
+  {
+    RFile fi("Trace_test.tmp.json");
+    int num_x = 0, num_c = 0, num_depth1 = 0;
+    for (string line; my_getline(fi(), line);) {
+      num_x += contains(line, "\"ph\": \"X\"");
+      num_c += contains(line, "\"ph\": \"C\"");
+      num_depth1 += contains(line, "\"name\": \"inner\"") && contains(line, "\"depth\": 1");
+    }
+    SHOW(num_x, num_c, num_depth1);
+  }
+  {
+    RFile fi("Trace_test.tmp.csv");
+    for (string line; my_getline(fi(), line);) {
+      if (starts_with(line, "timer,")) {
+        line.erase(line.find(',', line.find(',', 6) + 1));  // Omit the timing values.
+        SHOW(line);
+      } else {
+        SHOW(line);
+      }
+    }
+  }
+  assertx(remove_file("Trace_test.tmp.json"));
+  assertx(remove_file("Trace_test.tmp.csv"));
+  // The files must not be written again upon program termination.
+  hh_at_clean_up([] { assertx(!file_exists("Trace_test.tmp.json")); });
+}
@@ -1,6 +1,7 @@
 // -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
 #include "libHh/UnionFind.h"
 
+#include "libHh/Parallel.h"
 #include "libHh/Vec.h"
 using namespace hh;
 
@@ -92,6 +93,22 @@ int main() {
     SHOW(uf2.get_label(4));
     SHOW(uf2.get_label(5));
   }
+  {
+    const int num = 10'000;
+    ParallelUnionFind uf(num);
+    parallel_for_each({1000}, range(num), [&](const int i) {
+      if (i % 100) uf.unify(i, i - 1);            // Classes {0, ..., 99}, {100, ..., 199}, ...
+      if (i % 200 == 150) uf.unify(i, i - 100);  // Merge pairs of classes.
+    });
+    int num_classes = 0;
+    for_int(i, num) num_classes += uf.get_label(i) == i;
+    SHOW(num_classes);
+    SHOW(uf.get_label(99));
+    SHOW(uf.get_label(199));
+    SHOW(uf.get_label(9'999));
+    SHOW(uf.equal(150, 50));
+    SHOW(uf.equal(200, 199));
+  }
 }
 
 template class hh::UnionFind<unsigned>;
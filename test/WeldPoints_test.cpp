@@ -0,0 +1,37 @@
+// -*- C++ -*-  Copyright (c) Microsoft Corporation; see license.txt
+#include "libHh/WeldPoints.h"
+using namespace hh;
+
+int main() {
+  {
+    Array<int> point_class;
+    assertx(weld_points(Array<Point>{}, point_class) == 0 && !point_class.num());
+  }
+  {
+    // Bounding box of size 1, hence a grid spacing of 1e-3.
+    const Array<Point> points = {
+        Point(0.f, 0.f, 0.f),     //
+        Point(1.f, 1.f, 1.f),     //
+        Point(.5f, .5f, .5f),     //
+        Point(0.f, 0.f, 0.f),     // Exact duplicate of [0].
+        Point(.5f, .5f, .5005f),  // Near [2].
+        Point(.2999f, .3f, .3f),  // Straddles a cell boundary with [6].
+        Point(.3001f, .3f, .3f),  //
+        Point(.3f, .3f, .3035f),  // Too far from [5] and [6].
+        Point(.7f, .7f, .7f),     //
+        Point(.7009f, .7f, .7f),  // Chain of near points: [8] - [9] - [10].
+        Point(.7018f, .7f, .7f),  //
+        Point(1.f, 1.f, .9999f),  // Near [1].
+    };
+    Array<int> point_class;
+    const int num_classes = weld_points(points, point_class, 1e-3f);
+    SHOW(num_classes);
+    for_int(i, points.num()) showf("point %2d: class %d\n", i, point_class[i]);
+  }
+  {
+    // All points coincident.
+    Array<int> point_class;
+    SHOW(weld_points(Array<Point>(5, Point(1.f, 2.f, 3.f)), point_class));
+    SHOW(point_class);
+  }
+}